@@ -0,0 +1,211 @@
+/**
+ * @file engine_bench.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief epoll与io_uring事件引擎的回环基准测试
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ * 模拟服务器keep-alive场景： 每个请求都经历一次读、一次写和一次
+ * ModFd重新注册(EPOLLONESHOT | EPOLLET)。
+ * uring-cq一轮使用完成语义的请求： multishot recv读取， SENDMSG写回，
+ * 不再重新注册。
+ * 用法: ./engine_bench [连接数=64] [持续秒数=3]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "poller.h"
+#include "uringpoller.h"
+
+static const char REQUEST[] =
+    "GET /index.html HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+static const char RESPONSE[] = "HTTP/1.1 200 OK\r\nContent-length: 2\r\n\r\nok";
+
+/**
+ * @brief 建立conns条回环TCP连接
+ *
+ * @param clients 客户端套接字
+ * @param servers 服务端套接字(非阻塞)
+ * @param conns 连接数
+ */
+static void MakeConnections(std::vector<int> &clients,
+                            std::vector<int> &servers,
+                            int conns)
+{
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, conns) < 0 ||
+        getsockname(listenFd, (struct sockaddr *)&addr, &len) < 0)
+    {
+        perror("listen");
+        exit(1);
+    }
+    int one = 1;
+    for (int i = 0; i < conns; i++)
+    {
+        int c = socket(AF_INET, SOCK_STREAM, 0);
+        if (connect(c, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            perror("connect");
+            exit(1);
+        }
+        setsockopt(c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        int s = accept(listenFd, nullptr, nullptr);
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+        clients.push_back(c);
+        servers.push_back(s);
+    }
+    close(listenFd);
+}
+
+/**
+ * @brief 使用指定引擎运行一轮测试
+ *
+ * @param engine 事件引擎
+ * @param completion 是否使用io_uring完成语义的请求收发
+ * @param conns 连接数
+ * @param seconds 持续时间
+ */
+static void Run(EventEngine engine, bool completion, int conns, int seconds)
+{
+    std::unique_ptr<Poller> poller = Poller::Create(engine);
+    const char *name = "epoll";
+    UringPoller *uring = dynamic_cast<UringPoller *>(poller.get());
+    if (engine == EventEngine::IO_URING)
+    {
+        name = completion ? "uring-cq" : "io_uring";
+        if (!uring || (completion && !uring->CompletionIO()))
+        {
+            printf("%-8s unavailable, skipped\n", name);
+            return;
+        }
+    }
+
+    std::vector<int> clients, servers;
+    MakeConnections(clients, servers, conns);
+    const uint32_t connEvent = EPOLLONESHOT | EPOLLRDHUP | EPOLLET;
+    for (int fd : servers)
+    {
+        if (completion)
+            uring->Recv(fd);
+        else
+            poller->AddFd(fd, EPOLLIN | connEvent);
+    }
+
+    /* 响应内容不变， 所有连接共用同一个msghdr */
+    struct iovec iov = {const_cast<char *>(RESPONSE), sizeof(RESPONSE) - 1};
+    struct msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    std::atomic<bool> stop(false);
+    long served = 0;
+    std::thread loop([&] {
+        char buf[4096];
+        while (!stop)
+        {
+            int n = poller->Wait(100);
+            for (int i = 0; i < n; i++)
+            {
+                int fd = poller->GetEventFd(i);
+                if (completion)
+                {
+                    if (uring->GetOp(i) == UringPoller::RECV &&
+                        uring->GetResult(i) > 0 &&
+                        uring->Send(fd, &msg, MSG_NOSIGNAL))
+                        served++;
+                    continue;
+                }
+                if (!(poller->GetEvents(i) & EPOLLIN))
+                    continue;
+                while (read(fd, buf, sizeof(buf)) > 0)
+                {
+                    if (write(fd, RESPONSE, sizeof(RESPONSE) - 1) > 0)
+                        served++;
+                }
+                poller->ModFd(fd, EPOLLIN | connEvent);
+            }
+        }
+    });
+
+    /* 客户端在所有连接上并发发送请求， 再依次收取响应 */
+    char buf[4096];
+    long rounds = 0;
+    auto begin = std::chrono::steady_clock::now();
+    auto deadline = begin + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        for (int c : clients)
+        {
+            if (write(c, REQUEST, sizeof(REQUEST) - 1) < 0)
+            {
+                perror("write");
+                exit(1);
+            }
+        }
+        for (int c : clients)
+        {
+            size_t got = 0;
+            while (got < sizeof(RESPONSE) - 1)
+            {
+                ssize_t r = read(c, buf, sizeof(buf));
+                if (r <= 0)
+                {
+                    perror("read");
+                    exit(1);
+                }
+                got += r;
+            }
+        }
+        rounds++;
+    }
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    stop = true;
+    loop.join();
+
+    long requests = rounds * conns;
+    printf("%-8s conns=%d requests=%ld served=%ld %.0f req/s\n",
+           name,
+           conns,
+           requests,
+           served,
+           requests / elapsed);
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+        poller->DelFd(servers[i]);
+        close(servers[i]);
+        close(clients[i]);
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    int conns = argc > 1 ? atoi(argv[1]) : 64;
+    int seconds = argc > 2 ? atoi(argv[2]) : 3;
+    Run(EventEngine::EPOLL, false, conns, seconds);
+    Run(EventEngine::IO_URING, false, conns, seconds);
+    Run(EventEngine::IO_URING, true, conns, seconds);
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file parser_bench.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 正则表达式解析与零拷贝状态机解析的基准测试
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <regex>
+#include <string>
+#include <unordered_map>
+
+#include "httpparser.h"
+
+static const char REQUEST[] =
+    "GET /css/bootstrap.min.css HTTP/1.1\r\n"
+    "Host: 127.0.0.1:8080\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, "
+    "like Gecko) Chrome/120.0.0.0 Safari/537.36\r\n"
+    "Accept: text/css,*/*;q=0.1\r\n"
+    "Referer: http://127.0.0.1:8080/index.html\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark\r\n"
+    "\r\n";
+
+/**
+ * @brief 原HttpRequest的解析方式： 逐行拷贝并用正则表达式匹配
+ *
+ * @return size_t 首部字段数
+ */
+static size_t RegexParse(const char *begin, const char *end)
+{
+    const char CRLF[] = "\r\n";
+    std::string method, path, version;
+    std::unordered_map<std::string, std::string> header;
+    bool requestLine = true;
+    while (begin < end)
+    {
+        const char *lineEnd = std::search(begin, end, CRLF, CRLF + 2);
+        std::string line(begin, lineEnd);
+        if (requestLine)
+        {
+            std::regex patten("^([^ ]*) ([^ ]*) HTTP/([^ ]*)$");
+            std::smatch subMatch;
+            if (!std::regex_match(line, subMatch, patten))
+            {
+                return 0;
+            }
+            method = subMatch[1];
+            path = subMatch[2];
+            version = subMatch[3];
+            requestLine = false;
+        }
+        else
+        {
+            std::regex patten("^([^:]*): ?(.*)$");
+            std::smatch subMatch;
+            if (!std::regex_match(line, subMatch, patten))
+            {
+                break;
+            }
+            header[subMatch[1]] = subMatch[2];
+        }
+        begin = lineEnd + 2;
+    }
+    return header.size();
+}
+
+template <typename F> static double Run(const char *name, int rounds, F &&f)
+{
+    size_t sum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++)
+    {
+        sum += f();
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count() /
+                rounds;
+    printf("%-8s %10.1f ns/request (%zu)\n", name, ns, sum / rounds);
+    return ns;
+}
+
+int main(int argc, char const *argv[])
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 200000;
+    const char *begin = REQUEST;
+    const char *end = REQUEST + sizeof(REQUEST) - 1;
+    double regex = Run("regex", std::max(1, rounds / 100), [&] {
+        return RegexParse(begin, end);
+    });
+    HttpParser parser;
+    double simd = Run("parser", rounds, [&] {
+        /* Parse可以续接， 完成后需重置才会解析下一个请求 */
+        parser.Reset();
+        parser.Parse(begin, end);
+        return parser.HeaderCount();
+    });
+    printf("speedup  %10.1fx\n", regex / simd);
+
+    /* 长首部中查找行尾： SIMD与标量实现对比 */
+    std::string line(4096, 'x');
+    line += "\r\n";
+    const char *lb = line.data(), *le = line.data() + line.size();
+    Run("eol-simd", rounds, [&] { return HttpParser::FindEol(lb, le) - lb; });
+    Run("eol-byte", rounds, [&] {
+        return HttpParser::FindEolScalar(lb, le) - lb;
+    });
+    return 0;
+}
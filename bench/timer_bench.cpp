@@ -0,0 +1,72 @@
+/**
+ * @file timer_bench.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 小根堆与分层时间轮定时器的基准测试
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#include "timer.h"
+
+/**
+ * @brief 模拟keep-alive连接： 先为每个连接添加定时器， 再随机刷新
+ *
+ * @param type 定时器类型
+ * @param conns 连接数
+ * @param rounds 刷新次数
+ */
+static void Run(TimerType type, int conns, int rounds)
+{
+    std::unique_ptr<Timer> timer = Timer::Create(type, 10);
+    std::mt19937 rng(42);
+    std::vector<int> order(rounds);
+    for (auto &id : order)
+    {
+        id = rng() % conns;
+    }
+    int closed = 0;
+
+    auto begin = Clock::now();
+    for (int id = 0; id < conns; id++)
+    {
+        timer->add(id, 60000, [&closed] { closed++; });
+    }
+    auto added = Clock::now();
+    for (int id : order)
+    {
+        timer->adjust(id, 60000);
+    }
+    auto adjusted = Clock::now();
+    for (int id = 0; id < conns; id++)
+    {
+        timer->cancel(id);
+    }
+    auto cancelled = Clock::now();
+
+    auto ns = [](TimeStamp a, TimeStamp b, int n) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / n;
+    };
+    printf("%-6s conns=%d add %.1f ns/op, adjust %.1f ns/op, cancel %.1f "
+           "ns/op\n",
+           type == TimerType::WHEEL ? "wheel" : "heap",
+           conns,
+           ns(begin, added, conns),
+           ns(added, adjusted, rounds),
+           ns(adjusted, cancelled, conns));
+}
+
+int main(int argc, char const *argv[])
+{
+    int conns = argc > 1 ? atoi(argv[1]) : 50000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 2000000;
+    Run(TimerType::HEAP, conns, rounds);
+    Run(TimerType::WHEEL, conns, rounds);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file arena.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 单调递增的内存池实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "arena.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief 分配内存， 在Reset之前有效
+ *
+ * @param size
+ * @param align 2的幂
+ * @return void*
+ */
+void *Arena::Allocate(size_t size, size_t align)
+{
+    uintptr_t p = (reinterpret_cast<uintptr_t>(ptr_) + align - 1) & ~(align - 1);
+    if (ptr_ == nullptr || p + size > reinterpret_cast<uintptr_t>(end_))
+    {
+        NextBlock_(size, align);
+        p = (reinterpret_cast<uintptr_t>(ptr_) + align - 1) & ~(align - 1);
+    }
+    ptr_ = reinterpret_cast<char *>(p + size);
+    return reinterpret_cast<void *>(p);
+}
+
+/**
+ * @brief 拷贝字符串， 结果以'\0'结尾
+ *
+ * @param str
+ * @return std::string_view
+ */
+std::string_view Arena::Copy(std::string_view str)
+{
+    char *p = static_cast<char *>(Allocate(str.size() + 1, 1));
+    memcpy(p, str.data(), str.size());
+    p[str.size()] = '\0';
+    return std::string_view(p, str.size());
+}
+
+/**
+ * @brief 拼接两个字符串， 结果以'\0'结尾， 用于拼接目录与文件名
+ *
+ * @param a
+ * @param b
+ * @return const char*
+ */
+const char *Arena::Concat(std::string_view a, std::string_view b)
+{
+    char *p = static_cast<char *>(Allocate(a.size() + b.size() + 1, 1));
+    memcpy(p, a.data(), a.size());
+    memcpy(p + a.size(), b.data(), b.size());
+    p[a.size() + b.size()] = '\0';
+    return p;
+}
+
+/**
+ * @brief 释放全部分配， 保留不超过MAX_RETAIN的内存块供下次使用
+ *
+ */
+void Arena::Reset()
+{
+    size_t kept = 0;
+    size_t n = 0;
+    while (n < blocks_.size() && kept + blocks_[n].size <= MAX_RETAIN)
+    {
+        kept += blocks_[n++].size;
+    }
+    blocks_.resize(n);
+    cur_ = 0;
+    ptr_ = end_ = nullptr;
+    if (!blocks_.empty())
+    {
+        ptr_ = blocks_[0].data.get();
+        end_ = ptr_ + blocks_[0].size;
+    }
+}
+
+size_t Arena::Capacity() const
+{
+    size_t total = 0;
+    for (auto &block : blocks_)
+    {
+        total += block.size;
+    }
+    return total;
+}
+
+/**
+ * @brief 切换到下一个能容纳size的内存块， 没有时申请新的
+ *
+ * @param size
+ * @param align
+ */
+void Arena::NextBlock_(size_t size, size_t align)
+{
+    size_t need = size + align;
+    size_t next = ptr_ == nullptr ? 0 : cur_ + 1;
+    /* 复用Reset后保留的内存块 */
+    while (next < blocks_.size() && blocks_[next].size < need)
+    {
+        next++;
+    }
+    if (next == blocks_.size())
+    {
+        size_t blockSize = std::max(BLOCK_SIZE, need);
+        blocks_.push_back({std::make_unique<char[]>(blockSize), blockSize});
+    }
+    cur_ = next;
+    ptr_ = blocks_[cur_].data.get();
+    end_ = ptr_ + blocks_[cur_].size;
+}
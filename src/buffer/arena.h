@@ -0,0 +1,61 @@
+/**
+ * @file arena.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 单调递增的内存池， 按请求整体释放
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(ARENA_H)
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * @brief 只分配不单独释放， Reset后从头复用已有的内存块
+ *
+ * 每个连接一个， 存放一个请求处理过程中的临时数据， 请求完成后Reset。
+ * 稳定状态下不再向系统申请内存。 超过MAX_RETAIN的内存块在Reset时释放，
+ * 避免偶发的大请求长期占用内存。 非线程安全。
+ */
+class Arena
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t MAX_RETAIN = 64 * 1024;
+
+    Arena() : cur_(0), ptr_(nullptr), end_(nullptr) {}
+    ~Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    void *Allocate(size_t size, size_t align = alignof(std::max_align_t));
+    std::string_view Copy(std::string_view str);
+    const char *Concat(std::string_view a, std::string_view b);
+    void Reset();
+
+    /* 已申请的内存块总大小 */
+    size_t Capacity() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void NextBlock_(size_t size, size_t align);
+
+    std::vector<Block> blocks_;
+    size_t cur_; // 当前使用的内存块
+    char *ptr_;
+    char *end_;
+};
+
+#endif // ARENA_H
@@ -13,10 +13,12 @@
 /**
  * @brief Construct a new Buffer:: Buffer object
  *
+ * 构造时不分配内存， 空闲连接不占用缓冲区。
+ *
  * @param initBuffSize 初始化缓冲区大小
  */
 Buffer::Buffer(int initBuffSize)
-: buffer_(initBuffSize)
+: initBuffSize_(initBuffSize)
 , readPos_(0)
 , writePos_(0)
 {
@@ -100,7 +102,10 @@ void Buffer::RetrieveUntil(const char *end)
 void Buffer::RetrieveAll()
 {
     // 缓冲区全部置零
-    memset(buffer_.data(), 0, buffer_.size());
+    if (!buffer_.empty())
+    {
+        memset(buffer_.data(), 0, buffer_.size());
+    }
     readPos_ = 0;
     writePos_ = 0;
 }
@@ -139,9 +144,12 @@ char *Buffer::BeginWrite() { return BeginPtr_() + writePos_; }
  *
  * @param str 字符串
  */
-void Buffer::Append(const std::string &str)
+void Buffer::Append(std::string_view str)
 {
-    Append(str.data(), str.length());
+    if (!str.empty())
+    {
+        Append(str.data(), str.size());
+    }
 }
 
 /**
@@ -260,8 +268,13 @@ const char *Buffer::BeginPtr_() const
  */
 void Buffer::MakeSpace_(size_t len)
 {
+    if (buffer_.empty())
+    {
+        // 首次写入， 按初始大小分配
+        buffer_.resize(std::max(initBuffSize_, len + 1));
+    }
     // 如果可写区域+头部区域小于len, 则重新分配
-    if (WritableBytes() + PrependableBytes() < len)
+    else if (WritableBytes() + PrependableBytes() < len)
     {
         buffer_.resize(writePos_ + len + 1);
     }
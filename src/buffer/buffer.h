@@ -16,7 +16,9 @@
 #include <unistd.h>
 #include <sys/uio.h>
 #include <vector>
+#include <string_view>
 #include <atomic>
+#include <algorithm>
 #include <assert.h>
 
 class Buffer
@@ -42,7 +44,7 @@ public:
     const char *BeginWriteConst() const;
     char *BeginWrite();
 
-    void Append(const std::string &str);
+    void Append(std::string_view str);
     void Append(const char *str, size_t len);
     void Append(const void *data, size_t len);
     void Append(const Buffer &buff);
@@ -55,7 +57,8 @@ private:
     const char *BeginPtr_() const;
     void MakeSpace_(size_t len);
 
-    std::vector<char> buffer_;
+    std::vector<char> buffer_; // 首次写入时才分配
+    size_t initBuffSize_;
     std::atomic<std::size_t> readPos_;
     std::atomic<std::size_t> writePos_;
 };
@@ -0,0 +1,164 @@
+/**
+ * @file bytescan.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 按字节类别查找的SIMD扫描器与十六进制数字转换， 供各解析器共用
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(BYTE_SCAN_H)
+#define BYTE_SCAN_H
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BYTE_SCAN_X86
+#endif
+
+/**
+ * @brief 字节类别： 至多三个指定字节， 可选地加上控制字符(0x00-0x1f)
+ *
+ * Find一次比较16或32字节， 运行时按CPU是否支持AVX2选择实现， 只选择一次；
+ * 非x86平台使用FindScalar。 不足三个字节时用重复的字节补齐， 不影响结果。
+ */
+class ByteClass
+{
+public:
+    constexpr explicit ByteClass(char a) : ByteClass(a, a, a, false) {}
+    constexpr ByteClass(char a, char b) : ByteClass(a, b, b, false) {}
+    constexpr ByteClass(char a, char b, char c, bool ctrl)
+        : a_(a), b_(b), c_(c), ctrl_(ctrl)
+    {
+    }
+
+    bool Contains(char ch) const
+    {
+        return ch == a_ || ch == b_ || ch == c_ ||
+               (ctrl_ && static_cast<unsigned char>(ch) < 0x20);
+    }
+
+    /**
+     * @brief 查找第一个属于该类别的字节
+     *
+     * @param begin
+     * @param end
+     * @return const char* 找不到时返回end
+     */
+    const char *Find(const char *begin, const char *end) const
+    {
+        static const FindFunc func = SelectFind_();
+        return func(*this, begin, end);
+    }
+
+    const char *FindScalar(const char *begin, const char *end) const
+    {
+        while (begin < end && !Contains(*begin))
+        {
+            begin++;
+        }
+        return begin;
+    }
+
+private:
+    typedef const char *(*FindFunc)(const ByteClass &, const char *, const char *);
+
+#if defined(BYTE_SCAN_X86)
+
+    __attribute__((target("sse2"))) static const char *
+    FindSse2_(const ByteClass &set, const char *p, const char *end)
+    {
+        const __m128i a = _mm_set1_epi8(set.a_);
+        const __m128i b = _mm_set1_epi8(set.b_);
+        const __m128i c = _mm_set1_epi8(set.c_);
+        /* v <= 0x1f 等价于 max(v, 0x1f) == 0x1f， 不需要控制字符时屏蔽掉 */
+        const __m128i ctrl = _mm_set1_epi8(0x1f);
+        const __m128i ctrlMask = _mm_set1_epi8(set.ctrl_ ? -1 : 0);
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, b)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, c),
+                             _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl),
+                                           ctrlMask)));
+            int mask = _mm_movemask_epi8(hit);
+            if (mask)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return set.FindScalar(p, end);
+    }
+
+    __attribute__((target("avx2"))) static const char *
+    FindAvx2_(const ByteClass &set, const char *p, const char *end)
+    {
+        const __m256i a = _mm256_set1_epi8(set.a_);
+        const __m256i b = _mm256_set1_epi8(set.b_);
+        const __m256i c = _mm256_set1_epi8(set.c_);
+        const __m256i ctrl = _mm256_set1_epi8(0x1f);
+        const __m256i ctrlMask = _mm256_set1_epi8(set.ctrl_ ? -1 : 0);
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            __m256i hit = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, b)),
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(v, c),
+                    _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl),
+                                     ctrlMask)));
+            unsigned mask = _mm256_movemask_epi8(hit);
+            if (mask)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return FindSse2_(set, p, end);
+    }
+
+    static FindFunc SelectFind_()
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? FindAvx2_ : FindSse2_;
+    }
+
+#else
+
+    static const char *
+    FindScalar_(const ByteClass &set, const char *p, const char *end)
+    {
+        return set.FindScalar(p, end);
+    }
+
+    static FindFunc SelectFind_() { return FindScalar_; }
+
+#endif
+
+    char a_;
+    char b_;
+    char c_;
+    bool ctrl_;
+};
+
+/**
+ * @brief 十六进制数字的值， 不区分大小写
+ *
+ * @param ch
+ * @return int 不是十六进制数字时返回-1
+ */
+inline int HexDigit(char ch)
+{
+    if (ch >= '0' && ch <= '9')
+    {
+        return ch - '0';
+    }
+    ch |= 0x20;
+    if (ch >= 'a' && ch <= 'f')
+    {
+        return ch - 'a' + 10;
+    }
+    return -1;
+}
+
+#endif // BYTE_SCAN_H
@@ -0,0 +1,815 @@
+/**
+ * @file filecache.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 静态文件缓存实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "filecache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace
+{
+
+const uint32_t WATCH_MASK = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE |
+                            IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                            IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+const char DEFAULT_COMPRESS_TYPES[] =
+    "text/html,text/css,text/javascript,text/plain,text/xml,"
+    "application/xhtml+xml,application/json,image/svg+xml";
+
+} // namespace
+
+FileCache::Entry::~Entry()
+{
+    if (data && blob.empty())
+    {
+        munmap(data, size);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+FileCache *FileCache::Instance()
+{
+    static FileCache cache;
+    return &cache;
+}
+
+FileCache::FileCache()
+: capacity_(64 * 1024 * 1024)
+, compressMinSize_(1024)
+, inotifyFd_(-1)
+, stopFd_(-1)
+{
+    SetCompress(compressMinSize_, DEFAULT_COMPRESS_TYPES);
+}
+
+FileCache::~FileCache()
+{
+    if (watchThread_)
+    {
+        uint64_t one = 1;
+        ssize_t n = write(stopFd_, &one, sizeof(one));
+        (void)n;
+        watchThread_->join();
+    }
+    if (inotifyFd_ >= 0)
+    {
+        close(inotifyFd_);
+    }
+    if (stopFd_ >= 0)
+    {
+        close(stopFd_);
+    }
+}
+
+/**
+ * @brief 设置缓存容量
+ *
+ * @param capacity 映射的文件与条目本身占用的字节数上限， 0表示不缓存
+ */
+void FileCache::Init(size_t capacity)
+{
+    capacity_ = capacity;
+    Clear();
+}
+
+/**
+ * @brief 设置可压缩的文件
+ *
+ * @param minSize 小于该大小的文件不压缩
+ * @param types 逗号分隔的MIME类型， 为空时不压缩
+ */
+void FileCache::SetCompress(size_t minSize, std::string_view types)
+{
+    compressMinSize_ = minSize;
+    compressTypes_.clear();
+    while (!types.empty())
+    {
+        size_t comma = types.find(',');
+        std::string_view type = types.substr(0, comma);
+        while (!type.empty() && type.front() == ' ')
+        {
+            type.remove_prefix(1);
+        }
+        while (!type.empty() && type.back() == ' ')
+        {
+            type.remove_suffix(1);
+        }
+        if (!type.empty())
+        {
+            compressTypes_.emplace_back(type);
+        }
+        if (comma == std::string_view::npos)
+        {
+            break;
+        }
+        types.remove_prefix(comma + 1);
+    }
+    Clear();
+}
+
+/**
+ * @brief 缓存目录(含子目录)下的文件， 用inotify监视其中的变化
+ *
+ * @param dir
+ * @return true
+ * @return false 无法监视， 该目录下的文件不缓存
+ */
+bool FileCache::Watch(const std::string &dir)
+{
+    std::string root = dir;
+    if (root.empty() || root.back() != '/')
+    {
+        root += '/';
+    }
+    if (std::find(roots_.begin(), roots_.end(), root) != roots_.end())
+    {
+        return true;
+    }
+    if (inotifyFd_ < 0)
+    {
+        inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        stopFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotifyFd_ < 0 || stopFd_ < 0)
+        {
+            return false;
+        }
+        watchThread_ = std::make_unique<std::thread>(&FileCache::WatchLoop_, this);
+    }
+    if (!AddWatch_(root))
+    {
+        return false;
+    }
+    roots_.push_back(root);
+    return true;
+}
+
+/**
+ * @brief 查找文件， 未命中时打开并插入缓存
+ *
+ * @param path 完整路径
+ * @param type 取得文件的MIME类型
+ * @param map 是否需要内存映射， 用sendfile发送时不需要
+ * @return EntryPtr 不为空
+ */
+FileCache::EntryPtr
+FileCache::Get(const char *path, TypeFunc type, bool map)
+{
+    std::string_view key(path);
+    size_t capacity = capacity_;
+    bool cacheable = capacity > 0 && Cacheable_(key);
+    Shard &shard = ShardOf_(key);
+    uint64_t generation = 0;
+    if (cacheable)
+    {
+        if (EntryPtr hit = Find_(shard, key, generation))
+        {
+            return hit;
+        }
+    }
+
+    size_t budget = capacity / SHARD_NUM;
+    std::shared_ptr<Entry> entry =
+        Load_(path, !map ? 0 : cacheable ? budget / 2 : SIZE_MAX);
+    entry->type = &type(entry->path);
+    entry->compressible = entry->code == 200 && Compressible(entry->size, *entry->type);
+    if (entry->code == 200)
+    {
+        entry->header = "Content-type: " + *entry->type + "\r\n" +
+                        (entry->compressible ? "Vary: Accept-Encoding\r\n" : "") +
+                        entry->validators + "Content-length: " + std::to_string(entry->size) + "\r\n\r\n";
+    }
+    if (!cacheable)
+    {
+        return entry;
+    }
+    return Insert_(shard, generation, std::move(entry), budget);
+}
+
+/**
+ * @brief 查找文件的编码后的内容
+ *
+ * 以"路径\0编码"为键缓存， 没有可用的编码结果时缓存为404。 不缓存的
+ * 文件只使用预先压缩的文件， 不在请求中压缩。 同一键同时只有一个线程
+ * 加载或压缩， 其余线程得到空， 本次发送原始内容。
+ *
+ * @param plain Get返回的可压缩的条目
+ * @param encoding GZIP或BR， 只有GZIP可以压缩生成
+ * @param map 是否需要内存映射
+ * @return EntryPtr 没有可用的编码结果时为空
+ */
+FileCache::EntryPtr
+FileCache::GetEncoded(const EntryPtr &plain, Encoding encoding, bool map)
+{
+    if (!plain->compressible)
+    {
+        return nullptr;
+    }
+    size_t capacity = capacity_;
+    if (capacity == 0 || !Cacheable_(plain->path))
+    {
+        auto entry = LoadEncoded_(*plain, encoding, map ? SIZE_MAX : 0, false);
+        return entry->code == 200 ? entry : nullptr;
+    }
+    /* 复用线程的键缓冲， 命中时不申请内存 */
+    static thread_local std::string key;
+    key.assign(plain->path).push_back('\0');
+    key.append(EncodingName_(encoding));
+    Shard &shard = ShardOf_(key);
+    uint64_t generation;
+    if (EntryPtr hit = Find_(shard, key, generation))
+    {
+        return hit->code == 200 ? hit : nullptr;
+    }
+
+    /* 原文件已失效时其内容可能是旧的， 生成的结果不缓存 */
+    bool current = false;
+    {
+        Shard &plainShard = ShardOf_(plain->path);
+        std::shared_lock<std::shared_mutex> locker(plainShard.mtx);
+        auto it = plainShard.map.find(plain->path);
+        current = it != plainShard.map.end() && it->second == plain;
+    }
+    /* 同一键只由一个线程生成， 其余线程先发送原始内容 */
+    {
+        std::lock_guard<std::mutex> locker(encodingMtx_);
+        if (!encoding_.insert(key).second)
+        {
+            return nullptr;
+        }
+    }
+    size_t budget = capacity / SHARD_NUM;
+    std::shared_ptr<Entry> entry =
+        LoadEncoded_(*plain, encoding, map ? budget / 2 : 0, plain->size <= budget / 2);
+    entry->path = key;
+    EntryPtr result = current ? Insert_(shard, generation, entry, budget) : entry;
+    {
+        std::lock_guard<std::mutex> locker(encodingMtx_);
+        encoding_.erase(entry->path);
+    }
+    return result->code == 200 ? result : nullptr;
+}
+
+/**
+ * @brief 只查找已缓存的条目， 不打开文件
+ *
+ * @param path
+ * @return EntryPtr 未命中或不缓存时为空
+ */
+FileCache::EntryPtr FileCache::Find(const char *path)
+{
+    std::string_view key(path);
+    if (capacity_ == 0 || !Cacheable_(key))
+    {
+        return nullptr;
+    }
+    uint64_t generation;
+    return Find_(ShardOf_(key), key, generation);
+}
+
+/**
+ * @brief 删除路径对应的条目以及受其影响的编码后的条目
+ *
+ * @param path
+ */
+void FileCache::Invalidate(std::string_view path)
+{
+    Erase_(path);
+    /* 编码后的条目随原文件或预先压缩的文件一同失效 */
+    std::string key(path);
+    key.push_back('\0');
+    for (Encoding encoding : {GZIP, BR})
+    {
+        Erase_(key + EncodingName_(encoding));
+    }
+    for (Encoding encoding : {GZIP, BR})
+    {
+        std::string_view suffix = encoding == GZIP ? ".gz" : ".br";
+        if (path.size() > suffix.size() &&
+            path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            key.assign(path.substr(0, path.size() - suffix.size())).push_back('\0');
+            Erase_(key + EncodingName_(encoding));
+        }
+    }
+}
+
+/**
+ * @brief 删除全部条目
+ *
+ */
+void FileCache::Clear()
+{
+    for (Shard &shard : shards_)
+    {
+        std::unique_lock<std::shared_mutex> locker(shard.mtx);
+        shard.generation++;
+        shard.map.clear();
+        shard.bytes = 0;
+    }
+}
+
+size_t FileCache::Size() const
+{
+    size_t size = 0;
+    for (const Shard &shard : shards_)
+    {
+        std::shared_lock<std::shared_mutex> locker(shard.mtx);
+        size += shard.map.size();
+    }
+    return size;
+}
+
+size_t FileCache::Bytes() const
+{
+    size_t bytes = 0;
+    for (const Shard &shard : shards_)
+    {
+        std::shared_lock<std::shared_mutex> locker(shard.mtx);
+        bytes += shard.bytes;
+    }
+    return bytes;
+}
+
+/**
+ * @brief 打开文件并读取元数据
+ *
+ * @param path
+ * @param maxMap 不超过该大小的文件映射到内存
+ * @return std::shared_ptr<Entry> 不含type与header
+ */
+std::shared_ptr<FileCache::Entry> FileCache::Load_(const char *path, size_t maxMap)
+{
+    auto entry = std::make_shared<Entry>();
+    entry->path = path;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0)
+    {
+        entry->code = errno == EACCES ? 403 : 404;
+        return entry;
+    }
+    if (fstat(fd, &st) < 0 || S_ISDIR(st.st_mode))
+    {
+        close(fd);
+        return entry;
+    }
+    if (!(st.st_mode & S_IROTH)) // 判断文件是否具有读权限
+    {
+        close(fd);
+        entry->code = 403;
+        return entry;
+    }
+    entry->code = 200;
+    entry->fd = fd;
+    entry->size = st.st_size;
+    entry->mtime = st.st_mtime;
+    entry->etag = ETag(st);
+    entry->validators = Validators(entry->etag, entry->mtime);
+    if (entry->size > 0 && entry->size <= maxMap)
+    {
+        void *data = mmap(nullptr, entry->size, PROT_READ, MAP_SHARED, fd, 0);
+        /* 映射失败时改用sendfile发送 */
+        entry->data = data == MAP_FAILED ? nullptr : static_cast<char *>(data);
+    }
+    return entry;
+}
+
+/**
+ * @brief 取得编码后的内容
+ *
+ * 同目录下的预先压缩的文件比原文件旧时视为过期， 不使用。
+ *
+ * @param plain
+ * @param encoding
+ * @param maxMap 预先压缩的文件不超过该大小时映射到内存
+ * @param compress 没有预先压缩的文件时是否用zlib压缩
+ * @return std::shared_ptr<Entry> 不可用时code为404
+ */
+std::shared_ptr<FileCache::Entry>
+FileCache::LoadEncoded_(const Entry &plain, Encoding encoding, size_t maxMap, bool compress)
+{
+    std::string sibling = plain.path + (encoding == GZIP ? ".gz" : ".br");
+    std::shared_ptr<Entry> entry = Load_(sibling.c_str(), maxMap);
+    if (entry->code != 200 || entry->mtime < plain.mtime)
+    {
+        entry = std::make_shared<Entry>();
+        entry->path = plain.path;
+        if (encoding != GZIP || !compress || !Compress_(plain, entry->blob))
+        {
+            return entry;
+        }
+        entry->code = 200;
+        entry->data = &entry->blob[0];
+        entry->size = entry->blob.size();
+        entry->mtime = plain.mtime;
+    }
+    entry->type = plain.type;
+    entry->etag = plain.etag;
+    entry->validators = plain.validators;
+    entry->header = "Content-type: " + *entry->type + "\r\nContent-Encoding: " +
+                    EncodingName_(encoding) + "\r\nVary: Accept-Encoding\r\n" +
+                    entry->validators + "Content-length: " + std::to_string(entry->size) + "\r\n\r\n";
+    return entry;
+}
+
+/**
+ * @brief 用zlib以gzip格式压缩文件内容
+ *
+ * @param plain
+ * @param out
+ * @return true
+ * @return false 读取失败或压缩后没有变小
+ */
+bool FileCache::Compress_(const Entry &plain, std::string &out)
+{
+    std::string content;
+    const char *data = plain.data;
+    if (!data)
+    {
+        content.resize(plain.size);
+        size_t off = 0;
+        while (off < plain.size)
+        {
+            ssize_t n = pread(plain.fd, &content[off], plain.size - off, off);
+            if (n <= 0)
+            {
+                return false;
+            }
+            off += n;
+        }
+        data = content.data();
+    }
+
+    z_stream zs{};
+    /* windowBits加16生成gzip格式 */
+    if (deflateInit2(&zs, COMPRESS_LEVEL, Z_DEFLATED, 15 + 16, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+    out.resize(deflateBound(&zs, plain.size));
+    zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    zs.avail_in = plain.size;
+    zs.next_out = reinterpret_cast<Bytef *>(&out[0]);
+    zs.avail_out = out.size();
+    int ret = deflate(&zs, Z_FINISH);
+    deflateEnd(&zs);
+    if (ret != Z_STREAM_END || zs.total_out >= plain.size)
+    {
+        out.clear();
+        return false;
+    }
+    out.resize(zs.total_out);
+    out.shrink_to_fit();
+    return true;
+}
+
+/**
+ * @brief 由inode、 大小与修改时间(纳秒)生成弱ETag
+ *
+ * @param st
+ * @return std::string 形如W/"inode-size-mtime"， 均为十六进制
+ */
+std::string FileCache::ETag(const struct stat &st)
+{
+    char etag[64];
+    unsigned long long mtime =
+        static_cast<unsigned long long>(st.st_mtim.tv_sec) * 1000000000ULL +
+        st.st_mtim.tv_nsec;
+    int len = snprintf(etag, sizeof(etag), "W/\"%llx-%llx-%llx\"",
+                       static_cast<unsigned long long>(st.st_ino),
+                       static_cast<unsigned long long>(st.st_size), mtime);
+    return std::string(etag, len);
+}
+
+/**
+ * @brief 生成ETag与Last-Modified首部
+ *
+ * @param etag
+ * @param mtime
+ * @return std::string 含各行结尾的CRLF
+ */
+std::string FileCache::Validators(std::string_view etag, time_t mtime)
+{
+    char date[64];
+    struct tm tm;
+    gmtime_r(&mtime, &tm);
+    size_t len = strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    std::string validators = "ETag: ";
+    validators.append(etag).append("\r\nLast-Modified: ").append(date, len).append("\r\n");
+    return validators;
+}
+
+const char *FileCache::EncodingName_(Encoding encoding)
+{
+    return encoding == BR ? "br" : "gzip";
+}
+
+/**
+ * @brief 条目占用的字节数， 映射的文件计入容量
+ *
+ * @param entry
+ * @return size_t
+ */
+size_t FileCache::Cost_(const Entry &entry)
+{
+    return sizeof(Entry) + entry.path.size() + entry.header.size() +
+           (entry.data ? entry.size : 0);
+}
+
+/**
+ * @brief 是否压缩， 取决于大小与MIME类型
+ *
+ * @param size
+ * @param type
+ * @return true
+ * @return false
+ */
+bool FileCache::Compressible(size_t size, const std::string &type) const
+{
+    return size >= compressMinSize_ && size > 0 &&
+           std::find(compressTypes_.begin(), compressTypes_.end(), type) !=
+               compressTypes_.end();
+}
+
+int64_t FileCache::Now_()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief 是否位于Watch过的目录下
+ *
+ * 只缓存规范的路径， 与inotify报告的路径一致； 含有..的路径可能指向
+ * 目录之外， 也不缓存。
+ *
+ * @param path
+ * @return true
+ * @return false
+ */
+bool FileCache::Cacheable_(std::string_view path) const
+{
+    if (path.find("/..") != std::string_view::npos ||
+        path.find("/./") != std::string_view::npos ||
+        path.find("//") != std::string_view::npos)
+    {
+        return false;
+    }
+    for (const std::string &root : roots_)
+    {
+        if (path.compare(0, root.size(), root) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+FileCache::Shard &FileCache::ShardOf_(std::string_view path)
+{
+    return shards_[std::hash<std::string_view>()(path) % SHARD_NUM];
+}
+
+/**
+ * @brief 在分片中查找， 命中时更新最近使用时间
+ *
+ * @param shard
+ * @param key
+ * @param generation 未命中时返回分片当前的代数， 供Insert_使用
+ * @return EntryPtr 未命中时为空
+ */
+FileCache::EntryPtr
+FileCache::Find_(Shard &shard, std::string_view key, uint64_t &generation)
+{
+    std::shared_lock<std::shared_mutex> locker(shard.mtx);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end())
+    {
+        generation = shard.generation;
+        return nullptr;
+    }
+    /* 时间不变时不写入， 避免多个线程反复争用同一缓存行 */
+    int64_t now = Now_();
+    if (it->second->lastUse.load(std::memory_order_relaxed) != now)
+    {
+        it->second->lastUse.store(now, std::memory_order_relaxed);
+    }
+    return it->second;
+}
+
+/**
+ * @brief 插入加载的条目
+ *
+ * @param shard
+ * @param generation 查找时分片的代数， 不同时说明加载期间发生了失效
+ * @param entry
+ * @param budget 分片的字节数上限
+ * @return EntryPtr 其他线程已插入时为已有的条目
+ */
+FileCache::EntryPtr FileCache::Insert_(Shard &shard,
+                                       uint64_t generation,
+                                       std::shared_ptr<Entry> entry,
+                                       size_t budget)
+{
+    std::unique_lock<std::shared_mutex> locker(shard.mtx);
+    if (shard.generation != generation)
+    {
+        /* 加载期间文件发生了变化， 本次结果不缓存 */
+        return entry;
+    }
+    auto it = shard.map.find(entry->path);
+    if (it != shard.map.end())
+    {
+        return it->second;
+    }
+    entry->lastUse.store(Now_(), std::memory_order_relaxed);
+    shard.map.emplace(entry->path, entry);
+    shard.bytes += Cost_(*entry);
+    Evict_(shard, budget, MAX_ENTRIES / SHARD_NUM);
+    return entry;
+}
+
+/**
+ * @brief 删除键对应的条目并使分片的代数加一
+ *
+ * @param key
+ */
+void FileCache::Erase_(std::string_view key)
+{
+    Shard &shard = ShardOf_(key);
+    std::unique_lock<std::shared_mutex> locker(shard.mtx);
+    shard.generation++;
+    auto it = shard.map.find(key);
+    if (it != shard.map.end())
+    {
+        shard.bytes -= Cost_(*it->second);
+        shard.map.erase(it);
+    }
+}
+
+/**
+ * @brief 淘汰最久未使用的条目， 直到不超过容量
+ *
+ * @param shard 需持有写锁
+ * @param budget 分片的字节数上限
+ * @param maxEntries 分片的条目数上限
+ */
+void FileCache::Evict_(Shard &shard, size_t budget, size_t maxEntries)
+{
+    while (!shard.map.empty() &&
+           (shard.bytes > budget || shard.map.size() > maxEntries))
+    {
+        auto victim = std::min_element(
+            shard.map.begin(), shard.map.end(), [](auto &a, auto &b) {
+                return a.second->lastUse.load(std::memory_order_relaxed) <
+                       b.second->lastUse.load(std::memory_order_relaxed);
+            });
+        shard.bytes -= Cost_(*victim->second);
+        shard.map.erase(victim);
+    }
+}
+
+/**
+ * @brief 监视目录及其子目录
+ *
+ * @param dir 以'/'结尾
+ * @return true
+ * @return false
+ */
+bool FileCache::AddWatch_(const std::string &dir)
+{
+    int wd = inotify_add_watch(inotifyFd_, dir.c_str(), WATCH_MASK);
+    if (wd < 0)
+    {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> locker(watchMtx_);
+        watches_[wd] = dir;
+    }
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr)
+    {
+        return true;
+    }
+    while (struct dirent *ent = readdir(d))
+    {
+        if (ent->d_type == DT_DIR && strcmp(ent->d_name, ".") != 0 &&
+            strcmp(ent->d_name, "..") != 0)
+        {
+            AddWatch_(dir + ent->d_name + "/");
+        }
+    }
+    closedir(d);
+    return true;
+}
+
+/**
+ * @brief inotify线程， 直到析构时退出
+ *
+ */
+void FileCache::WatchLoop_()
+{
+    alignas(struct inotify_event) char buf[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+    struct pollfd fds[2] = {{inotifyFd_, POLLIN, 0}, {stopFd_, POLLIN, 0}};
+    while (true)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents)
+        {
+            break;
+        }
+        ssize_t len;
+        while ((len = read(inotifyFd_, buf, sizeof(buf))) > 0)
+        {
+            HandleEvents_(buf, len);
+        }
+    }
+}
+
+/**
+ * @brief 处理一批inotify事件
+ *
+ * 文件的变化使对应条目失效； 目录的创建、 删除与移动以及事件队列溢出时
+ * 无法确定受影响的路径(包括负缓存)， 清空全部条目。
+ *
+ * @param buf
+ * @param len
+ */
+void FileCache::HandleEvents_(const char *buf, size_t len)
+{
+    for (size_t off = 0; off < len;)
+    {
+        auto *event = reinterpret_cast<const struct inotify_event *>(buf + off);
+        off += sizeof(struct inotify_event) + event->len;
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+            Clear();
+            continue;
+        }
+        std::string dir;
+        {
+            std::lock_guard<std::mutex> locker(watchMtx_);
+            auto it = watches_.find(event->wd);
+            if (it == watches_.end())
+            {
+                continue;
+            }
+            dir = it->second;
+            if (event->mask & IN_IGNORED)
+            {
+                watches_.erase(it);
+                continue;
+            }
+        }
+        if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+        {
+            Clear();
+        }
+        else if (event->mask & IN_ISDIR)
+        {
+            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+                AddWatch_(dir + event->name + "/");
+            }
+            Clear();
+        }
+        else if (event->len > 0)
+        {
+            Invalidate(dir + event->name);
+        }
+    }
+}
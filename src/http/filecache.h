@@ -0,0 +1,151 @@
+/**
+ * @file filecache.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 进程内共享的静态文件缓存， 由inotify失效
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(FILE_CACHE_H)
+#define FILE_CACHE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <time.h>
+
+/**
+ * @brief 路径到打开的文件、 内存映射、 元数据与预先生成的首部的缓存
+ *
+ * 按路径哈希分片， 每个分片一把读写锁， 命中只加读锁并以原子变量记录最近
+ * 使用时间， 各Reactor线程互不阻塞。 插入时超出容量则淘汰分片中最久未使用
+ * 的条目(近似LRU)。 不存在或不可读的路径也会缓存(负缓存)。
+ *
+ * 只缓存Watch过的目录下的文件， 目录中文件的修改、 删除与创建由inotify
+ * 线程通知后立即失效。 条目以shared_ptr交给响应， 失效或淘汰后仍在发送的
+ * 响应不受影响， 最后一个引用释放时才关闭文件、 解除映射。
+ *
+ * 可压缩的文件另有编码后的条目(GetEncoded)： 优先使用同目录下不旧于原文件
+ * 的.gz/.br文件， 没有时用zlib压缩一次， 结果与原文件一同失效。
+ */
+class FileCache
+{
+public:
+    /* 内容编码， 按位组合表示客户端接受的编码 */
+    enum Encoding
+    {
+        IDENTITY = 0,
+        GZIP = 1,
+        BR = 2,
+    };
+
+    struct Entry
+    {
+        Entry() = default;
+        ~Entry();
+        Entry(const Entry &) = delete;
+        Entry &operator=(const Entry &) = delete;
+
+        std::string path;
+        int code = 404;        // 200、 403(不可读)或404(不存在或为目录)
+        int fd = -1;           // code为200时打开， 供sendfile使用
+        char *data = nullptr;  // 内存映射或blob， 大文件或sendfile模式下为nullptr
+        std::string blob;      // 压缩生成的内容， 此时fd为-1
+        size_t size = 0;
+        time_t mtime = 0;
+        const std::string *type = nullptr; // MIME类型
+        std::string etag;      // 弱ETag， 编码后的条目与原文件相同
+        std::string validators; // ETag与Last-Modified首部
+        std::string header;    // Content-type与Content-length等首部， 含结尾空行
+        bool compressible = false; // 响应随Accept-Encoding变化
+        mutable std::atomic<int64_t> lastUse{0};
+    };
+    typedef std::shared_ptr<const Entry> EntryPtr;
+    /* 由路径得到MIME类型， 只在未命中时调用， 返回值需在进程内一直有效 */
+    typedef const std::string &(*TypeFunc)(std::string_view path);
+
+    static constexpr size_t SHARD_NUM = 16;
+    static constexpr size_t MAX_ENTRIES = 1024; // 条目数上限， 限制占用的描述符
+    static constexpr int COMPRESS_LEVEL = 6;     // 在Reactor线程中压缩， 不使用最高级别
+
+    static FileCache *Instance();
+
+    void Init(size_t capacity);
+    /* 需在服务器启动前调用 */
+    void SetCompress(size_t minSize, std::string_view types);
+    /* 需在服务器启动前调用 */
+    bool Watch(const std::string &dir);
+    EntryPtr Get(const char *path, TypeFunc type, bool map);
+    EntryPtr GetEncoded(const EntryPtr &plain, Encoding encoding, bool map);
+    EntryPtr Find(const char *path);
+    bool Compressible(size_t size, const std::string &type) const;
+    void Invalidate(std::string_view path);
+    void Clear();
+
+    size_t Size() const;
+    size_t Bytes() const;
+
+    static std::string ETag(const struct stat &st);
+    static std::string Validators(std::string_view etag, time_t mtime);
+
+private:
+    struct Shard
+    {
+        mutable std::shared_mutex mtx;
+        std::unordered_map<std::string_view, std::shared_ptr<Entry>> map;
+        size_t bytes = 0;
+        uint64_t generation = 0; // 每次失效加一， 避免插入失效前读取的旧内容
+    };
+
+    FileCache();
+    ~FileCache();
+
+    static std::shared_ptr<Entry> Load_(const char *path, size_t maxMap);
+    static bool Compress_(const Entry &plain, std::string &out);
+    static const char *EncodingName_(Encoding encoding);
+    static size_t Cost_(const Entry &entry);
+    static int64_t Now_();
+
+    std::shared_ptr<Entry>
+    LoadEncoded_(const Entry &plain, Encoding encoding, size_t maxMap, bool compress);
+    bool Cacheable_(std::string_view path) const;
+    Shard &ShardOf_(std::string_view path);
+    EntryPtr Find_(Shard &shard, std::string_view key, uint64_t &generation);
+    EntryPtr Insert_(Shard &shard,
+                     uint64_t generation,
+                     std::shared_ptr<Entry> entry,
+                     size_t budget);
+    void Erase_(std::string_view key);
+    void Evict_(Shard &shard, size_t budget, size_t maxEntries);
+    bool AddWatch_(const std::string &dir);
+    void WatchLoop_();
+    void HandleEvents_(const char *buf, size_t len);
+
+    Shard shards_[SHARD_NUM];
+    std::atomic<size_t> capacity_; // 总字节数上限， 0表示不缓存
+    size_t compressMinSize_;         // 小于该大小的文件不压缩
+    std::vector<std::string> compressTypes_; // 可压缩的MIME类型， 启动后只读
+    std::mutex encodingMtx_;
+    std::unordered_set<std::string> encoding_; // 正在生成编码结果的键
+
+    std::vector<std::string> roots_; // Watch的目录， 以'/'结尾， 启动后只读
+    std::mutex watchMtx_;
+    std::unordered_map<int, std::string> watches_; // inotify watch -> 目录
+    int inotifyFd_;
+    int stopFd_;
+    std::unique_ptr<std::thread> watchThread_;
+};
+
+#endif // FILE_CACHE_H
@@ -0,0 +1,146 @@
+/**
+ * @file formdata.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief URL百分号解码与表单键值对实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "formdata.h"
+
+#include <string.h>
+
+#include "bytescan.h"
+
+namespace
+{
+
+constexpr ByteClass ESCAPE('%', '+');
+
+} // namespace
+
+/**
+ * @brief 解析&分隔的键值对， 键与值分别原地解码
+ *
+ * 没有=的项值为空， 空项被忽略。
+ *
+ * @param data 原文， 解码后被改写
+ * @param len
+ */
+void FormData::Parse(char *data, size_t len)
+{
+    char *end = data + len;
+    while (data < end)
+    {
+        char *amp = static_cast<char *>(memchr(data, '&', end - data));
+        char *stop = amp ? amp : end;
+        if (stop > data)
+        {
+            char *eq = static_cast<char *>(memchr(data, '=', stop - data));
+            char *keyEnd = eq ? eq : stop;
+            char *value = eq ? eq + 1 : stop;
+            size_t keyLen = Decode(data, keyEnd - data, true);
+            size_t valueLen = Decode(value, stop - value, true);
+            fields_.emplace_back(std::string_view(data, keyLen),
+                                 std::string_view(value, valueLen));
+        }
+        data = stop + 1;
+    }
+}
+
+/**
+ * @brief 添加键值对， 不拷贝
+ *
+ * @param key
+ * @param value
+ */
+void FormData::Add(std::string_view key, std::string_view value)
+{
+    fields_.emplace_back(key, value);
+}
+
+/**
+ * @brief 按键查找
+ *
+ * @param key 区分大小写
+ * @return std::string_view 不存在时data()为nullptr
+ */
+std::string_view FormData::Get(std::string_view key) const
+{
+    for (auto &field : fields_)
+    {
+        if (field.first == key)
+        {
+            return field.second;
+        }
+    }
+    return std::string_view();
+}
+
+/**
+ * @brief 原地百分号解码
+ *
+ * 用SIMD查找%与+， 两者之间不需转义的部分整段移动。 不合法的转义(%后不足
+ * 两位十六进制数)原样保留。
+ *
+ * @param data
+ * @param len
+ * @param plusAsSpace 表单与查询字符串中+表示空格， 路径中不是
+ * @return size_t 解码后的长度
+ */
+size_t FormData::Decode(char *data, size_t len, bool plusAsSpace)
+{
+    const char *p = data;
+    const char *end = data + len;
+    char *out = data;
+    while (p < end)
+    {
+        const char *stop = ScanEscape(p, end);
+        size_t run = stop - p;
+        if (out != p)
+        {
+            memmove(out, p, run);
+        }
+        out += run;
+        p = stop;
+        if (p == end)
+        {
+            break;
+        }
+        if (*p == '+')
+        {
+            *out++ = plusAsSpace ? ' ' : '+';
+            p++;
+            continue;
+        }
+        int hi = end - p > 2 ? HexDigit(p[1]) : -1;
+        int lo = hi >= 0 ? HexDigit(p[2]) : -1;
+        if (lo < 0)
+        {
+            *out++ = *p++;
+            continue;
+        }
+        *out++ = static_cast<char>(hi << 4 | lo);
+        p += 3;
+    }
+    return out - data;
+}
+
+/**
+ * @brief 查找第一个%或+
+ *
+ * @param begin
+ * @param end
+ * @return const char* 找不到时为end
+ */
+const char *FormData::ScanEscape(const char *begin, const char *end)
+{
+    return ESCAPE.Find(begin, end);
+}
+
+const char *FormData::ScanEscapeScalar(const char *begin, const char *end)
+{
+    return ESCAPE.FindScalar(begin, end);
+}
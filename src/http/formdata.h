@@ -0,0 +1,47 @@
+/**
+ * @file formdata.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief URL百分号解码与application/x-www-form-urlencoded键值对
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(FORMDATA_H)
+#define FORMDATA_H
+
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * @brief 表单或查询字符串的键值对， 只保存指向原文的视图
+ *
+ * Parse在原文上原地解码(解码结果不会比原文长)， 因此原文须在使用期间保持
+ * 不变。 键值对按出现顺序保存， 同名的键Get返回第一个。 Clear保留容量，
+ * 多次解析间不再申请内存。
+ */
+class FormData
+{
+public:
+    typedef std::pair<std::string_view, std::string_view> Field;
+
+    void Parse(char *data, size_t len);
+    void Add(std::string_view key, std::string_view value);
+    void Clear() { fields_.clear(); }
+
+    bool Empty() const { return fields_.empty(); }
+    const std::vector<Field> &Fields() const { return fields_; }
+    std::string_view Get(std::string_view key) const;
+
+    static size_t Decode(char *data, size_t len, bool plusAsSpace);
+    static const char *ScanEscape(const char *begin, const char *end);
+    static const char *ScanEscapeScalar(const char *begin, const char *end);
+
+private:
+    std::vector<Field> fields_;
+};
+
+#endif // FORMDATA_H
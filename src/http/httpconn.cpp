@@ -13,12 +13,22 @@
 
 const char *HttpConn::srcDir;
 std::atomic<int> HttpConn::userCount;
+std::atomic<bool> HttpConn::isDraining(false);
 bool HttpConn::isET;
+int HttpConn::keepAliveMax = 0;
+int HttpConn::keepAliveTimeout = 0;
 
 HttpConn::HttpConn()
 : fd_(-1)
 , addr_({0})
 , isClose_(true)
+, keepAlive_(false)
+, requestCnt_(0)
+, toWrite_(0)
+, iovIdx_(0)
+, sendIdx_(0)
+, sendMsg_{}
+, respCnt_(0)
 {
 }
 
@@ -40,8 +50,11 @@ void HttpConn::init(int sockFd, const sockaddr_in &addr)
     userCount++;
     addr_ = addr;
     fd_ = sockFd;
-    writeBuff_.RetrieveAll();
+    ClearResponses_();
     readBuff_.RetrieveAll();
+    request_.Init();
+    keepAlive_ = false;
+    requestCnt_ = 0;
     isClose_ = false;
     LOG_INFO("Client[%d](%s:%d) in, userCount:%d",
              fd_,
@@ -81,45 +94,169 @@ ssize_t HttpConn::write(int *saveErrno)
     ssize_t len = -1;
     do
     {
-        len = writev(fd_, iov_, iovCnt_);
+        len = WriteOnce_(saveErrno);
         if (len <= 0)
         {
-            *saveErrno = errno;
             break;
         }
-        if (iov_[0].iov_len + iov_[1].iov_len == 0)
+        Sent(len);
+        if (toWrite_ == 0)
         {
-            /* 传输结束 */
             break;
         }
-        else if (static_cast<size_t>(len) > iov_[0].iov_len)
+    } while (isET || ToWriteBytes() > 10240);
+    return len;
+}
+
+/**
+ * @brief 记录已发送的字节数
+ *
+ * 跳过已发送完的iovec， 调整发送了一部分的iovec， 全部发送完时释放响应。
+ *
+ * @param len
+ */
+void HttpConn::Sent(size_t len)
+{
+    assert(len <= toWrite_);
+    toWrite_ -= len;
+    size_t left = len;
+    while (left > 0)
+    {
+        struct iovec &iov = iov_[iovIdx_];
+        if (iov.iov_base == nullptr)
         {
-            iov_[1].iov_base =
-                static_cast<char *>(iov_[1].iov_base) + (len - iov_[0].iov_len);
-            iov_[1].iov_len -= (len - iov_[0].iov_len);
-            if (iov_[0].iov_len)
+            /* 文件的偏移已由sendfile更新 */
+            iov.iov_len -= left;
+            left = 0;
+            if (iov.iov_len == 0)
             {
-                writeBuff_.RetrieveAll();
-                iov_[0].iov_len = 0;
+                iovIdx_++;
+                sendIdx_++;
             }
         }
+        else if (left >= iov.iov_len)
+        {
+            left -= iov.iov_len;
+            iov.iov_len = 0;
+            iovIdx_++;
+        }
         else
         {
-            iov_[0].iov_base = static_cast<char *>(iov_[0].iov_base) + len;
-            iov_[0].iov_len -= len;
-            writeBuff_.Retrieve(len);
+            iov.iov_base = static_cast<char *>(iov.iov_base) + left;
+            iov.iov_len -= left;
+            left = 0;
         }
-    } while (isET || ToWriteBytes() > 10240);
+    }
+    if (toWrite_ == 0)
+    {
+        /* 传输结束， 及时释放文件映射 */
+        ClearResponses_();
+    }
+}
+
+/**
+ * @brief 准备下一段内存数据的发送请求
+ *
+ * @param flags 输出sendmsg的flags
+ * @return const struct msghdr* 下一段为文件或没有数据时为nullptr，
+ *         改用WriteFile发送
+ */
+const struct msghdr *HttpConn::PrepareSend(int *flags)
+{
+    if (iovIdx_ >= iov_.size() || iov_[iovIdx_].iov_base == nullptr)
+    {
+        return nullptr;
+    }
+    *flags = FillMsg_(&sendMsg_);
+    return &sendMsg_;
+}
+
+/**
+ * @brief 用sendfile发送下一段文件， 下一段须为文件
+ *
+ * @param saveErrno
+ * @return ssize_t 发送的字节数， 出错时为-1
+ */
+ssize_t HttpConn::WriteFile(int *saveErrno)
+{
+    assert(iovIdx_ < iov_.size() && iov_[iovIdx_].iov_base == nullptr);
+    ssize_t len = WriteOnce_(saveErrno);
+    if (len > 0)
+    {
+        Sent(len);
+    }
+    return len;
+}
+
+/**
+ * @brief 发送下一段数据
+ *
+ * 从iovIdx_开始的连续内存一次sendmsg发出， 后面紧跟文件时带MSG_MORE，
+ * 使首部与文件开头合并为完整的报文段； 文件用sendfile发送。
+ *
+ * @param saveErrno
+ * @return ssize_t 发送的字节数， 出错时为-1
+ */
+ssize_t HttpConn::WriteOnce_(int *saveErrno)
+{
+    if (iovIdx_ >= iov_.size())
+    {
+        return 0;
+    }
+    struct iovec &first = iov_[iovIdx_];
+    ssize_t len;
+    if (first.iov_base == nullptr)
+    {
+        SendFile &file = sendFiles_[sendIdx_];
+        len = sendfile(fd_, file.fd, &file.offset, first.iov_len);
+        if (len == 0)
+        {
+            /* 文件在发送期间被截短 */
+            errno = EIO;
+            len = -1;
+        }
+    }
+    else
+    {
+        struct msghdr msg;
+        int flags = FillMsg_(&msg);
+        len = sendmsg(fd_, &msg, flags);
+    }
+    if (len < 0)
+    {
+        *saveErrno = errno;
+    }
     return len;
 }
 
+/**
+ * @brief 以从iovIdx_开始的连续内存填写msg， 后面紧跟文件时带MSG_MORE
+ *
+ * @param msg
+ * @return int sendmsg的flags
+ */
+int HttpConn::FillMsg_(struct msghdr *msg) const
+{
+    size_t cnt = 0;
+    size_t limit = std::min<size_t>(iov_.size() - iovIdx_, IOV_MAX);
+    while (cnt < limit && iov_[iovIdx_ + cnt].iov_base != nullptr)
+    {
+        cnt++;
+    }
+    *msg = {};
+    msg->msg_iov = const_cast<struct iovec *>(&iov_[iovIdx_]);
+    msg->msg_iovlen = cnt;
+    bool more = iovIdx_ + cnt < iov_.size();
+    return MSG_NOSIGNAL | (more ? MSG_MORE : 0);
+}
+
 /**
  * @brief 关闭http连接
  * 
  */
 void HttpConn::Close()
 {
-    response_.UnmapFile();
+    ClearResponses_();
     if (isClose_ == false)
     {
         isClose_ = true;
@@ -152,7 +289,12 @@ int HttpConn::getPort() const { return addr_.sin_port; }
  * 
  * @return const char* 
  */
-const char *HttpConn::getIP() const { return inet_ntoa(addr_.sin_addr); }
+const char *HttpConn::getIP() const
+{
+    /* inet_ntoa使用全局静态缓冲区， 多Reactor下改用线程局部缓冲区 */
+    static thread_local char ip[INET_ADDRSTRLEN];
+    return inet_ntop(AF_INET, &addr_.sin_addr, ip, sizeof(ip));
+}
 
 /**
  * @brief 获取该http连接的地址
@@ -163,41 +305,126 @@ sockaddr_in HttpConn::getAddr() const { return addr_; }
 
 /**
  * @brief 处理http连接
- * 
- * @return true 
- * @return false 
+ *
+ * 依次处理读缓冲区中所有完整的请求(流水线)， 各响应按请求顺序排列在
+ * iov_中， 由write一次writev发出。 遇到不保持连接的请求时停止处理。
+ *
+ * @return true 有响应需要发送
+ * @return false 没有完整的请求， 需要继续读取
  */
 bool HttpConn::process()
 {
-    request_.Init();
-    if (readBuff_.ReadableBytes() <= 0)
+    ClearResponses_();
+    /* 各响应首部依次追加在writeBuff_中， 全部生成后再计算地址 */
+    std::array<size_t, MAX_PIPELINE> headEnd;
+    while (respCnt_ < MAX_PIPELINE && readBuff_.ReadableBytes() > 0)
+    {
+        /* 解析进度保存在request_中， 请求不完整时继续读取 */
+        HttpRequest::HTTP_CODE code = request_.parse(readBuff_);
+        if (code == HttpRequest::NO_REQUEST)
+        {
+            break;
+        }
+        if (respCnt_ == responses_.size())
+        {
+            responses_.push_back(std::make_unique<HttpResponse>());
+        }
+        HttpResponse &response = *responses_[respCnt_];
+        requestCnt_++;
+        /* 达到请求数上限的响应带上Connection: close */
+        keepAlive_ = code == HttpRequest::GET_REQUEST && request_.IsKeepAlive() &&
+                     (keepAliveMax <= 0 || requestCnt_ < keepAliveMax);
+        if (code == HttpRequest::GET_REQUEST)
+        {
+            LOG_DEBUG("%s", request_.path().c_str());
+            response.Init(srcDir, request_.path(), isKeepAlive(), 200);
+            response.SetAcceptEncoding(request_.GetHeader(HttpHeader::ACCEPT_ENCODING));
+            std::string_view ifNoneMatch = request_.GetHeader(HttpHeader::IF_NONE_MATCH);
+            std::string_view ifModifiedSince =
+                request_.GetHeader(HttpHeader::IF_MODIFIED_SINCE);
+            if ((!ifNoneMatch.empty() || !ifModifiedSince.empty()) &&
+                request_.method() == "GET")
+            {
+                response.SetConditions(ifNoneMatch, ifModifiedSince);
+            }
+            response.SetKeepAlive(keepAliveTimeout,
+                                  keepAliveMax > 0 ? keepAliveMax - requestCnt_ : 0);
+            request_.Dispatch(response);
+        }
+        else
+        {
+            response.Init(srcDir,
+                          request_.path(),
+                          false,
+                          code == HttpRequest::PAYLOAD_TOO_LARGE ? 413 : 400);
+        }
+        response.MakeResponse(writeBuff_, request_.GetArena());
+        headEnd[respCnt_++] = writeBuff_.ReadableBytes();
+        if (!isKeepAlive())
+        {
+            break;
+        }
+    }
+    if (respCnt_ == 0)
     {
         return false;
     }
-    else if (request_.parse(readBuff_))
+
+    size_t headBegin = 0;
+    for (size_t i = 0; i < respCnt_; i++)
     {
-        LOG_DEBUG("%s", request_.path().c_str());
-        response_.Init(srcDir, request_.path(), request_.IsKeepAlive(), 200);
+        /* 响应首部， 前一个响应没有文件时与其首部合并 */
+        char *head = const_cast<char *>(writeBuff_.Peek()) + headBegin;
+        size_t headLen = headEnd[i] - headBegin;
+        if (!iov_.empty() && static_cast<char *>(iov_.back().iov_base) +
+                                     iov_.back().iov_len ==
+                                 head)
+        {
+            iov_.back().iov_len += headLen;
+        }
+        else
+        {
+            iov_.push_back({head, headLen});
+        }
+        headBegin = headEnd[i];
+        /* 文件 */
+        HttpResponse &response = *responses_[i];
+        if (response.FileLen() > 0 && response.File())
+        {
+            iov_.push_back({response.File(), response.FileLen()});
+        }
+        else if (response.FileLen() > 0 && response.FileFd() >= 0)
+        {
+            iov_.push_back({nullptr, response.FileLen()});
+            sendFiles_.push_back({response.FileFd(), 0});
+        }
     }
-    else
+    for (auto &iov : iov_)
     {
-        response_.Init(srcDir, request_.path(), false, 400);
+        toWrite_ += iov.iov_len;
     }
+    LOG_DEBUG("responses:%d, iov:%d, %d to write",
+              static_cast<int>(respCnt_),
+              static_cast<int>(iov_.size()),
+              static_cast<int>(toWrite_));
+    return true;
+}
 
-    response_.MakeResponse(writeBuff_);
-    /* 响应头 */
-    iov_[0].iov_base = const_cast<char *>(writeBuff_.Peek());
-    iov_[0].iov_len = writeBuff_.ReadableBytes();
-    iovCnt_ = 1;
-
-    /* 文件 */
-    if (response_.FileLen() > 0 && response_.File())
+/**
+ * @brief 释放已发送完毕的响应
+ *
+ */
+void HttpConn::ClearResponses_()
+{
+    for (size_t i = 0; i < respCnt_; i++)
     {
-        iov_[1].iov_base = response_.File();
-        iov_[1].iov_len = response_.FileLen();
-        iovCnt_ = 2;
+        responses_[i]->UnmapFile();
     }
-    LOG_DEBUG(
-        "filesize:%d, %d to %d", response_.FileLen(), iovCnt_, ToWriteBytes());
-    return true;
+    respCnt_ = 0;
+    iov_.clear();
+    iovIdx_ = 0;
+    sendFiles_.clear();
+    sendIdx_ = 0;
+    toWrite_ = 0;
+    writeBuff_.RetrieveAll();
 }
@@ -14,15 +14,22 @@
 
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
 #include <arpa/inet.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
+#include <array>
+#include <memory>
+#include <vector>
 
 #include "log.h"
 #include "sqlconnRAII.h"
 #include "buffer.h"
 #include "httprequest.h"
 #include "httpresponse.h"
+#include "timer.h"
 
 class HttpConn
 {
@@ -41,27 +48,62 @@ public:
     sockaddr_in getAddr() const;
 
     bool process();
+
+    /* io_uring完成模式下， 收发请求由Reactor提交， 此处只处理数据 */
+    void Append(const char *data, size_t len) { readBuff_.Append(data, len); }
+    const struct msghdr *PrepareSend(int *flags);
+    ssize_t WriteFile(int *saveErrno);
+    void Sent(size_t len);
     /* 要写的字节数 */
-    int ToWriteBytes() { return iov_[0].iov_len + iov_[1].iov_len; }
-    bool isKeepAlive() const { return request_.IsKeepAlive(); }
+    size_t ToWriteBytes() const { return toWrite_; }
+    /* 最后一个已响应的请求是否保持连接， 热升级排空期间不再保持连接 */
+    bool isKeepAlive() const { return keepAlive_ && !isDraining; }
+    /* 最近一次活跃的时间， 惰性超时模式下使用 */
+    void SetLastActive(TimeStamp t) { lastActive_ = t; }
+    TimeStamp LastActive() const { return lastActive_; }
 
     static bool isET;
     static const char *srcDir;
     static std::atomic<int> userCount;
+    static std::atomic<bool> isDraining;
+    static int keepAliveMax;     // 每个连接最多处理的请求数， 0表示不限制
+    static int keepAliveTimeout; // 空闲连接的超时(秒)， 由定时器执行， 只用于公布
+
+    static const size_t MAX_PIPELINE = 16; // 一次处理的流水线请求数上限
 
 private:
     int fd_;
     struct sockaddr_in addr_;
 
+    void ClearResponses_();
+    ssize_t WriteOnce_(int *saveErrno);
+    int FillMsg_(struct msghdr *msg) const;
+
     bool isClose_;
-    int iovCnt_;
-    struct iovec iov_[2];
+    bool keepAlive_;
+    int requestCnt_; // 本连接已处理的请求数
+    size_t toWrite_;
+    size_t iovIdx_;                 // 第一个未发送完的iovec
+    std::vector<struct iovec> iov_; // 依次为各响应的首部与文件
+    /* 用sendfile发送的文件， 在iov_中以iov_base为nullptr的项占位 */
+    struct SendFile
+    {
+        int fd;
+        off_t offset; // 下一次发送的位置， 部分发送后由此继续
+    };
+    size_t sendIdx_; // 第一个未发送完的文件
+    std::vector<SendFile> sendFiles_;
+    struct msghdr sendMsg_; // 提交给io_uring的发送请求
+
+    TimeStamp lastActive_;
 
     Buffer readBuff_;  // 读缓冲区
     Buffer writeBuff_; // 写缓冲区
 
     HttpRequest request_;
-    HttpResponse response_;
+    /* 按需创建， 在同一连接的多批请求间复用 */
+    std::vector<std::unique_ptr<HttpResponse>> responses_;
+    size_t respCnt_;
 };
 
 #endif // HTTP_CONN_H
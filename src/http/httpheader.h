@@ -0,0 +1,198 @@
+/**
+ * @file httpheader.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 常用首部字段表， 编译期生成的完美哈希
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(HTTP_HEADER_H)
+#define HTTP_HEADER_H
+
+#include <string_view>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 常用首部字段， 解析时直接映射到固定槽位
+ *
+ */
+enum class HttpHeader : uint8_t
+{
+    HOST = 0,
+    CONNECTION,
+    KEEP_ALIVE,
+    CONTENT_LENGTH,
+    CONTENT_TYPE,
+    TRANSFER_ENCODING,
+    ACCEPT,
+    ACCEPT_ENCODING,
+    ACCEPT_LANGUAGE,
+    USER_AGENT,
+    REFERER,
+    COOKIE,
+    ORIGIN,
+    CACHE_CONTROL,
+    PRAGMA,
+    IF_NONE_MATCH,
+    IF_MODIFIED_SINCE,
+    RANGE,
+    IF_RANGE,
+    EXPECT,
+    UPGRADE,
+    AUTHORIZATION,
+    UPGRADE_INSECURE_REQUESTS,
+    SEC_FETCH_SITE,
+    SEC_FETCH_MODE,
+    SEC_FETCH_DEST,
+    DNT,
+    UNKNOWN, // 不在表中的首部字段
+};
+
+namespace httpheader
+{
+
+constexpr size_t KNOWN_NUM = static_cast<size_t>(HttpHeader::UNKNOWN);
+
+/* 与HttpHeader顺序一致 */
+constexpr std::string_view NAMES[KNOWN_NUM] = {
+    "Host",
+    "Connection",
+    "Keep-Alive",
+    "Content-Length",
+    "Content-Type",
+    "Transfer-Encoding",
+    "Accept",
+    "Accept-Encoding",
+    "Accept-Language",
+    "User-Agent",
+    "Referer",
+    "Cookie",
+    "Origin",
+    "Cache-Control",
+    "Pragma",
+    "If-None-Match",
+    "If-Modified-Since",
+    "Range",
+    "If-Range",
+    "Expect",
+    "Upgrade",
+    "Authorization",
+    "Upgrade-Insecure-Requests",
+    "Sec-Fetch-Site",
+    "Sec-Fetch-Mode",
+    "Sec-Fetch-Dest",
+    "DNT",
+};
+
+constexpr int TABLE_BITS = 7;
+constexpr size_t TABLE_SIZE = 1 << TABLE_BITS;
+
+constexpr char ToLower(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch + ('a' - 'A')) : ch;
+}
+
+/* 不区分大小写的FNV-1a， seed不同得到不同的哈希函数 */
+constexpr uint32_t Hash(std::string_view name, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ seed;
+    for (char ch : name)
+    {
+        h = (h ^ static_cast<unsigned char>(ToLower(ch))) * 16777619u;
+    }
+    return h >> (32 - TABLE_BITS);
+}
+
+/* 找到使所有名称落在不同槽位的seed */
+constexpr uint32_t FindSeed()
+{
+    for (uint32_t seed = 0;; seed++)
+    {
+        bool used[TABLE_SIZE] = {};
+        bool ok = true;
+        for (size_t i = 0; i < KNOWN_NUM && ok; i++)
+        {
+            uint32_t slot = Hash(NAMES[i], seed);
+            ok = !used[slot];
+            used[slot] = true;
+        }
+        if (ok)
+        {
+            return seed;
+        }
+    }
+}
+
+constexpr uint32_t SEED = FindSeed();
+
+struct Table
+{
+    HttpHeader slots[TABLE_SIZE] = {};
+    constexpr Table()
+    {
+        for (size_t i = 0; i < TABLE_SIZE; i++)
+        {
+            slots[i] = HttpHeader::UNKNOWN;
+        }
+        for (size_t i = 0; i < KNOWN_NUM; i++)
+        {
+            slots[Hash(NAMES[i], SEED)] = static_cast<HttpHeader>(i);
+        }
+    }
+};
+
+constexpr Table TABLE;
+
+constexpr bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (ToLower(a[i]) != ToLower(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace httpheader
+
+/**
+ * @brief 查找首部字段名对应的槽位， 名称不区分大小写
+ *
+ * 一次哈希定位候选槽位， 再比较一次名称确认。
+ *
+ * @param name
+ * @return constexpr HttpHeader 不在表中时为UNKNOWN
+ */
+constexpr HttpHeader LookupHeader(std::string_view name)
+{
+    HttpHeader id = httpheader::TABLE.slots[httpheader::Hash(name, httpheader::SEED)];
+    if (id != HttpHeader::UNKNOWN &&
+        httpheader::EqualsIgnoreCase(
+            httpheader::NAMES[static_cast<size_t>(id)], name))
+    {
+        return id;
+    }
+    return HttpHeader::UNKNOWN;
+}
+
+constexpr std::string_view HeaderName(HttpHeader id)
+{
+    return id == HttpHeader::UNKNOWN ? std::string_view()
+                                     : httpheader::NAMES[static_cast<size_t>(id)];
+}
+
+static_assert(LookupHeader("content-TYPE") == HttpHeader::CONTENT_TYPE,
+              "header lookup must be case-insensitive");
+static_assert(LookupHeader("X-Unknown") == HttpHeader::UNKNOWN,
+              "unknown header must not match");
+
+#endif // HTTP_HEADER_H
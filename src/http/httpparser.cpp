@@ -0,0 +1,341 @@
+/**
+ * @file httpparser.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 零拷贝HTTP/1.1请求头解析器实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "httpparser.h"
+
+#include "bytescan.h"
+
+namespace
+{
+
+constexpr ByteClass EOL('\r', '\n');
+
+/* token字符表， 方法名与首部字段名只允许token字符 */
+struct TokenTable
+{
+    bool table[256] = {};
+    constexpr TokenTable()
+    {
+        const char *delims = "\"(),/:;<=>?@[\\]{}";
+        for (int ch = 0x21; ch < 0x7f; ch++)
+        {
+            table[ch] = true;
+        }
+        for (const char *p = delims; *p; p++)
+        {
+            table[static_cast<unsigned char>(*p)] = false;
+        }
+    }
+};
+
+constexpr TokenTable TOKEN_TABLE;
+
+bool IsTokenChar(unsigned char ch) { return TOKEN_TABLE.table[ch]; }
+
+bool IsWhiteSpace(char ch) { return ch == ' ' || ch == '\t'; }
+
+} // namespace
+
+/**
+ * @brief 重置解析结果
+ *
+ */
+void HttpParser::Reset()
+{
+    state_ = REQUEST_LINE;
+    base_ = "";
+    lineBegin_ = scanned_ = 0;
+    method_ = path_ = version_ = Span();
+    known_.fill(NO_HEADER);
+    headerCount_ = 0;
+    headLen_ = 0;
+}
+
+/**
+ * @brief 解析请求行与首部字段， 从上一次停下的位置继续
+ *
+ * @param begin 请求的起始位置， 与之前的调用相比数据可以已被移动
+ * @param end 已读取数据的结束位置
+ * @return PARSE_RESULT
+ */
+HttpParser::PARSE_RESULT HttpParser::Parse(const char *begin, const char *end)
+{
+    base_ = begin;
+    if (state_ == DONE)
+    {
+        return PARSE_OK;
+    }
+    while (true)
+    {
+        const char *line = begin + lineBegin_;
+        const char *eol = FindEol(begin + scanned_, end);
+        if (eol - begin >= static_cast<ptrdiff_t>(MAX_HEAD))
+        {
+            /* 没有行尾的请求行或首部字段会让读缓冲区无限增长 */
+            return PARSE_ERROR;
+        }
+        if (eol == end)
+        {
+            scanned_ = end - begin;
+            return PARSE_AGAIN;
+        }
+        /* 行尾为CRLF， 也兼容单独的LF */
+        const char *next = eol + 1;
+        if (*eol == '\r')
+        {
+            if (next == end)
+            {
+                scanned_ = eol - begin;
+                return PARSE_AGAIN;
+            }
+            if (*next != '\n')
+            {
+                return PARSE_ERROR;
+            }
+            next++;
+        }
+        if (state_ == REQUEST_LINE)
+        {
+            /* 忽略请求行之前的空行 */
+            if (eol != line)
+            {
+                if (!ParseRequestLine_(line, eol))
+                {
+                    return PARSE_ERROR;
+                }
+                state_ = HEADERS;
+            }
+        }
+        else if (eol == line)
+        {
+            headLen_ = next - begin;
+            state_ = DONE;
+            return PARSE_OK;
+        }
+        else if (!ParseHeader_(line, eol))
+        {
+            return PARSE_ERROR;
+        }
+        lineBegin_ = scanned_ = next - begin;
+    }
+}
+
+/**
+ * @brief 按名称查找首部字段， 名称不区分大小写
+ *
+ * 常用首部字段经完美哈希直接定位， 其余的逐个比较。
+ *
+ * @param name
+ * @return std::string_view 不存在时为空
+ */
+std::string_view HttpParser::GetHeader(std::string_view name) const
+{
+    HttpHeader id = LookupHeader(name);
+    if (id != HttpHeader::UNKNOWN)
+    {
+        return GetHeader(id);
+    }
+    for (size_t i = 0; i < headerCount_; i++)
+    {
+        if (EqualsIgnoreCase(View_(headers_[i].name), name))
+        {
+            return View_(headers_[i].value);
+        }
+    }
+    return std::string_view();
+}
+
+/**
+ * @brief 查找第一个CR或LF
+ *
+ * @param begin
+ * @param end
+ * @return const char* 找不到时返回end
+ */
+const char *HttpParser::FindEol(const char *begin, const char *end)
+{
+    return EOL.Find(begin, end);
+}
+
+/**
+ * @brief 查找第一个指定字符
+ *
+ * @param begin
+ * @param end
+ * @param ch
+ * @return const char* 找不到时返回end
+ */
+const char *HttpParser::FindChar(const char *begin, const char *end, char ch)
+{
+    return ByteClass(ch).Find(begin, end);
+}
+
+const char *HttpParser::FindEolScalar(const char *begin, const char *end)
+{
+    return EOL.FindScalar(begin, end);
+}
+
+const char *
+HttpParser::FindCharScalar(const char *begin, const char *end, char ch)
+{
+    return ByteClass(ch).FindScalar(begin, end);
+}
+
+/**
+ * @brief 不区分大小写比较
+ *
+ * @param a
+ * @param b
+ * @return true
+ * @return false
+ */
+bool HttpParser::EqualsIgnoreCase(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() && strncasecmp(a.data(), b.data(), a.size()) == 0;
+}
+
+/**
+ * @brief 逗号分隔的首部字段值中是否含有token， 如 Connection: keep-alive, Upgrade
+ *
+ * @param value
+ * @param token 不区分大小写
+ * @return true
+ * @return false
+ */
+bool HttpParser::HasToken(std::string_view value, std::string_view token)
+{
+    while (!value.empty())
+    {
+        size_t comma = value.find(',');
+        std::string_view item = value.substr(0, comma);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t'))
+        {
+            item.remove_prefix(1);
+        }
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t'))
+        {
+            item.remove_suffix(1);
+        }
+        if (EqualsIgnoreCase(item, token))
+        {
+            return true;
+        }
+        if (comma == std::string_view::npos)
+        {
+            break;
+        }
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+/**
+ * @brief 解析请求行， 格式为 method SP path SP HTTP/version
+ *
+ * @param begin
+ * @param end 行尾(不含CRLF)
+ * @return true
+ * @return false
+ */
+bool HttpParser::ParseRequestLine_(const char *begin, const char *end)
+{
+    const char *sp1 = FindChar(begin, end, ' ');
+    if (sp1 == begin || sp1 == end)
+    {
+        return false;
+    }
+    const char *sp2 = FindChar(sp1 + 1, end, ' ');
+    if (sp2 == sp1 + 1 || sp2 == end)
+    {
+        return false;
+    }
+    for (const char *p = begin; p < sp1; p++)
+    {
+        if (!IsTokenChar(*p))
+        {
+            return false;
+        }
+    }
+    for (const char *p = sp1 + 1; p < sp2; p++)
+    {
+        if (static_cast<unsigned char>(*p) <= 0x20 || *p == 0x7f)
+        {
+            return false;
+        }
+    }
+    const char *ver = sp2 + 1;
+    if (end - ver <= 5 || memcmp(ver, "HTTP/", 5) != 0 ||
+        FindChar(ver, end, ' ') != end)
+    {
+        return false;
+    }
+    method_ = Span_(begin, sp1);
+    path_ = Span_(sp1 + 1, sp2);
+    version_ = Span_(ver + 5, end);
+    return true;
+}
+
+/**
+ * @brief 解析首部字段， 格式为 name: OWS value OWS
+ *
+ * @param begin
+ * @param end 行尾(不含CRLF)
+ * @return true
+ * @return false 格式错误、首部字段过多或重复的Content-Length与Transfer-Encoding
+ */
+bool HttpParser::ParseHeader_(const char *begin, const char *end)
+{
+    if (headerCount_ == MAX_HEADERS)
+    {
+        return false;
+    }
+    const char *colon = FindChar(begin, end, ':');
+    if (colon == begin || colon == end)
+    {
+        return false;
+    }
+    for (const char *p = begin; p < colon; p++)
+    {
+        if (!IsTokenChar(*p))
+        {
+            return false;
+        }
+    }
+    const char *value = colon + 1;
+    while (value < end && IsWhiteSpace(*value))
+    {
+        value++;
+    }
+    const char *valueEnd = end;
+    while (valueEnd > value && IsWhiteSpace(valueEnd[-1]))
+    {
+        valueEnd--;
+    }
+    HttpHeader id = LookupHeader(std::string_view(begin, colon - begin));
+    if (id != HttpHeader::UNKNOWN)
+    {
+        uint8_t &slot = known_[static_cast<size_t>(id)];
+        if (slot == NO_HEADER)
+        {
+            slot = static_cast<uint8_t>(headerCount_);
+        }
+        else if (id == HttpHeader::CONTENT_LENGTH ||
+                 id == HttpHeader::TRANSFER_ENCODING)
+        {
+            /* 多个Content-Length或Transfer-Encoding可能被用于请求走私：
+               中间代理可能合并为列表， 与只看第一个的分帧结果不一致 */
+            return false;
+        }
+    }
+    HeaderSpan &header = headers_[headerCount_++];
+    header.name = Span_(begin, colon);
+    header.value = Span_(value, valueEnd);
+    return true;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file httpparser.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 零拷贝HTTP/1.1请求头解析器
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(HTTP_PARSER_H)
+#define HTTP_PARSER_H
+
+#include <array>
+#include <string_view>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include "httpheader.h"
+
+/**
+ * @brief HTTP/1.1请求行与首部字段解析器
+ *
+ * 手写状态机， 不分配内存也不拷贝数据： 解析结果均为指向输入缓冲区的
+ * string_view， 在缓冲区中的数据被移动或覆盖之前有效。
+ * 行尾与':'的查找使用SSE2/AVX2(运行时检测)， 其余平台使用标量实现。
+ *
+ * 解析可以跨多次读取继续： 状态机位置与各字段均以相对请求起始位置的
+ * 偏移保存， 每次以同一请求的起始位置(缓冲区可能已移动)和新的结束位置
+ * 调用Parse， 已查找过的字节不会再次扫描。 Reset后开始解析下一个请求。
+ * 请求行与首部字段合计超过MAX_HEAD时视为格式错误， 不再等待行尾。
+ */
+class HttpParser
+{
+public:
+    enum PARSE_RESULT
+    {
+        PARSE_OK = 0,  // 请求行与首部字段完整
+        PARSE_AGAIN,   // 数据不完整， 需要继续读取
+        PARSE_ERROR,   // 格式错误或请求头过大
+    };
+
+    struct Header
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    static const size_t MAX_HEADERS = 64;
+    static const size_t MAX_HEAD = 16 * 1024; // 请求行与首部字段的总长度上限
+    static constexpr uint8_t NO_HEADER = 0xff;
+
+    HttpParser() { Reset(); }
+
+    void Reset();
+
+    PARSE_RESULT Parse(const char *begin, const char *end);
+
+    /* 请求头被拷贝到别处后， 让解析结果指向新的位置 */
+    void Rebase(const char *begin) { base_ = begin; }
+
+    std::string_view Method() const { return View_(method_); }
+    std::string_view Path() const { return View_(path_); }
+    std::string_view Version() const { return View_(version_); }
+
+    size_t HeaderCount() const { return headerCount_; }
+    Header GetHeader(size_t i) const
+    {
+        return {View_(headers_[i].name), View_(headers_[i].value)};
+    }
+    std::string_view GetHeader(std::string_view name) const;
+    /* 常用首部字段O(1)查找 */
+    std::string_view GetHeader(HttpHeader id) const
+    {
+        if (id == HttpHeader::UNKNOWN)
+        {
+            return std::string_view();
+        }
+        uint8_t i = known_[static_cast<size_t>(id)];
+        return i == NO_HEADER ? std::string_view() : View_(headers_[i].value);
+    }
+
+    /* 请求行与首部字段(含结尾空行)的总长度 */
+    size_t HeadLength() const { return headLen_; }
+
+    static const char *FindEol(const char *begin, const char *end);
+    static const char *FindChar(const char *begin, const char *end, char ch);
+
+    static const char *FindEolScalar(const char *begin, const char *end);
+    static const char *FindCharScalar(const char *begin,
+                                      const char *end,
+                                      char ch);
+
+    static bool EqualsIgnoreCase(std::string_view a, std::string_view b);
+    static bool HasToken(std::string_view value, std::string_view token);
+
+private:
+    enum STATE
+    {
+        REQUEST_LINE,
+        HEADERS,
+        DONE,
+    };
+
+    /* 相对请求起始位置的偏移与长度 */
+    struct Span
+    {
+        uint32_t off = 0;
+        uint32_t len = 0;
+    };
+
+    struct HeaderSpan
+    {
+        Span name;
+        Span value;
+    };
+
+    std::string_view View_(Span span) const
+    {
+        return std::string_view(base_ + span.off, span.len);
+    }
+    Span Span_(const char *begin, const char *end) const
+    {
+        return {static_cast<uint32_t>(begin - base_),
+                static_cast<uint32_t>(end - begin)};
+    }
+
+    bool ParseRequestLine_(const char *begin, const char *end);
+    bool ParseHeader_(const char *begin, const char *end);
+
+    STATE state_;
+    const char *base_;  // 最近一次Parse时请求的起始位置
+    size_t lineBegin_;  // 当前行的起始偏移
+    size_t scanned_;    // 已查找过行尾的偏移
+    Span method_, path_, version_;
+    std::array<HeaderSpan, MAX_HEADERS> headers_;
+    /* 常用首部字段在headers_中的下标， 重复出现时取第一个 */
+    std::array<uint8_t, httpheader::KNOWN_NUM> known_;
+    size_t headerCount_;
+    size_t headLen_;
+};
+
+#endif // HTTP_PARSER_H
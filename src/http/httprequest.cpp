@@ -9,28 +9,17 @@
  * 
  */
 #include "httprequest.h"
+#include "bytescan.h"
+#include "httpresponse.h"
 
 /**
- * @brief 默认的html文件
- * 
+ * @brief 路由表， 缺省包含各页面与登录注册表单
+ *
  */
-const std::unordered_set<std::string> HttpRequest::DEFAULT_HTML{
-    "/index",
-    "/register",
-    "/login",
-    "/welcome",
-    "/video",
-    "/picture",
-};
+Router HttpRequest::router = HttpRequest::DefaultRouter_();
 
-/**
- * @brief 默认的html文件标签
- * 
- */
-const std::unordered_map<std::string, int> HttpRequest::DEFAULT_HTML_TAG{
-    {"/register.html", 0},
-    {"/login.html", 1},
-};
+std::string HttpRequest::uploadDir = "/tmp";
+size_t HttpRequest::maxUpload = 16 << 20;
 
 /**
  * @brief 初始化
@@ -40,60 +29,124 @@ void HttpRequest::Init()
 {
     method_ = path_ = version_ = body_ = "";
     state_ = REQUEST_LINE;
-    header_.clear();
-    post_.clear();
+    keepAlive_ = false;
+    bodyState_ = BODY_NONE;
+    remaining_ = 0;
+    lineScanned_ = 0;
+    route_.route = nullptr;
+    route_.paramCount = 0;
+    arena_.Reset();
+    parser_.Reset();
+    if (multipart_)
+    {
+        multipart_->Reset();
+    }
+    json_.Clear();
+    post_.Clear();
+    query_.Clear();
 }
 
 /**
- * @brief 解析请求
- * 
- * @param buff 
- * @return true 
- * @return false 
+ * @brief 解析请求， 数据不完整时保留进度， 下次读取后继续
+ *
+ * 请求头完整之前不从缓冲区取走数据。 有内容实体时将请求头拷贝到arena_，
+ * 之后内容实体每到达一段就交给处理函数并从缓冲区取走， 不整体缓存。
+ * 请求完成后缓冲区中剩余的数据属于下一个请求。
+ *
+ * @param buff 读缓冲区
+ * @return HTTP_CODE NO_REQUEST: 请求不完整； GET_REQUEST: 请求完整；
+ *         BAD_REQUEST: 格式错误； PAYLOAD_TOO_LARGE: 上传超出上限
  */
-bool HttpRequest::parse(Buffer &buff)
+HttpRequest::HTTP_CODE HttpRequest::parse(Buffer &buff)
 {
-    const char CRLF[] = "\r\n";
-    if (buff.ReadableBytes() <= 0)
+    if (state_ == FINISH)
     {
-        return false;
+        /* 上一个请求已经响应完毕， 开始解析下一个请求 */
+        Init();
     }
-    while (buff.ReadableBytes() && state_ != FINISH)
+    if (state_ != BODY)
     {
-        const char *lineEnd =
-            std::search(buff.Peek(), buff.BeginWriteConst(), CRLF, CRLF + 2);
-        std::string line(buff.Peek(), lineEnd);
-        // 利用状态机解析请求
-        switch (state_)
+        const char *begin = buff.Peek();
+        switch (parser_.Parse(begin, buff.BeginWriteConst()))
         {
-        case REQUEST_LINE:
-            if (!ParseRequestLine_(line))
-            {
-                return false;
-            }
-            ParsePath_();
-            break;
-        case HEADERS:
-            ParseHeader_(line);
-            /* 如果可读字节数小于2， 说明没有内容实体， 解析完成*/
-            if (buff.ReadableBytes() <= 2)
-            {
-                state_ = FINISH;
-            }
-            break;
-        case BODY:
-            ParseBody_(line);
-            break;
+        case HttpParser::PARSE_AGAIN:
+            state_ = parser_.Method().empty() ? REQUEST_LINE : HEADERS;
+            return NO_REQUEST;
+        case HttpParser::PARSE_ERROR:
+            LOG_ERROR("RequestLine Error");
+            state_ = FINISH;
+            buff.RetrieveAll();
+            return BAD_REQUEST;
         default:
             break;
         }
-        if (lineEnd == buff.BeginWriteConst())
-            break;
-        buff.RetrieveUntil(lineEnd + 2);
+        method_.assign(parser_.Method());
+        version_.assign(parser_.Version());
+        /* HTTP/1.1缺省保持连接， HTTP/1.0需显式请求 */
+        std::string_view connection = parser_.GetHeader(HttpHeader::CONNECTION);
+        if (version_ == "1.1")
+        {
+            keepAlive_ = !HttpParser::HasToken(connection, "close");
+        }
+        else
+        {
+            keepAlive_ = version_ == "1.0" &&
+                         HttpParser::HasToken(connection, "keep-alive");
+        }
+        if (!ParseTarget_())
+        {
+            LOG_ERROR("Request target Error");
+            state_ = FINISH;
+            keepAlive_ = false;
+            buff.RetrieveAll();
+            return BAD_REQUEST;
+        }
+        /* 在请求头完整时查找路由， 以便内容实体交给对应的处理函数 */
+        router.Find(method_, path_, route_);
+        if (!ParseFraming_() || !InitForm_())
+        {
+            LOG_ERROR("Body framing Error");
+            state_ = FINISH;
+            keepAlive_ = false;
+            buff.RetrieveAll();
+            return BAD_REQUEST;
+        }
+        size_t headLen = parser_.HeadLength();
+        if (bodyState_ != BODY_NONE)
+        {
+            parser_.Rebase(arena_.Copy(std::string_view(begin, headLen)).data());
+        }
+        buff.Retrieve(headLen);
+        state_ = BODY;
     }
-    LOG_DEBUG(
-        "[%s], [%s], [%s]", method_.c_str(), path_.c_str(), version_.c_str());
-    return true;
+
+    HTTP_CODE code = ParseBody_(buff);
+    if (code == BAD_REQUEST)
+    {
+        LOG_ERROR("Body Error");
+        if (multipart_ && multipart_->TooLarge())
+        {
+            code = PAYLOAD_TOO_LARGE;
+        }
+        if (multipart_)
+        {
+            /* 立即删除已写入的临时文件 */
+            multipart_->Reset();
+        }
+        state_ = FINISH;
+        keepAlive_ = false;
+        buff.RetrieveAll();
+        return code;
+    }
+    if (code == GET_REQUEST)
+    {
+        state_ = FINISH;
+        LOG_DEBUG("[%s], [%s], [%s]",
+                  method_.c_str(),
+                  path_.c_str(),
+                  version_.c_str());
+    }
+    return code;
 }
 
 std::string HttpRequest::path() const { return path_; }
@@ -118,112 +171,414 @@ std::string HttpRequest::GetPost(const std::string &key) const
 std::string HttpRequest::GetPost(const char *key) const
 {
     assert(key != nullptr);
-    if (post_.count(key) == 1)
+    return std::string(post_.Get(key));
+}
+
+/**
+ * @brief 获取查询字符串中的参数
+ *
+ * @param key
+ * @return std::string_view 已解码； 不存在时data()为nullptr
+ */
+std::string_view HttpRequest::GetQuery(std::string_view key) const
+{
+    return query_.Get(key);
+}
+
+/**
+ * @brief 按名称查找首部字段， 名称不区分大小写
+ *
+ * @param name
+ * @return std::string_view 不存在时为空； 在请求完成后的下一次读取前有效
+ */
+std::string_view HttpRequest::GetHeader(std::string_view name) const
+{
+    return parser_.GetHeader(name);
+}
+
+std::string_view HttpRequest::GetHeader(HttpHeader id) const
+{
+    return parser_.GetHeader(id);
+}
+
+/**
+ * @brief 获取路由中的路径参数， 如/user/:id中的id
+ *
+ * @param name
+ * @return std::string_view 不存在时为空
+ */
+std::string_view HttpRequest::GetParam(std::string_view name) const
+{
+    return route_.Get(name);
+}
+
+/**
+ * @brief 获取multipart表单上传的文件
+ *
+ * @param name 表单字段名
+ * @return const MultipartParser::File* 不存在时为nullptr； 临时文件在下一个请求
+ *         开始时删除， 需要保留时应rename
+ */
+const MultipartParser::File *HttpRequest::GetFile(const std::string &name) const
+{
+    for (auto &file : GetFiles())
     {
-        return post_.find(key)->second;
+        if (file.name == name)
+        {
+            return &file;
+        }
     }
-    return "";
+    return nullptr;
+}
+
+const std::vector<MultipartParser::File> &HttpRequest::GetFiles() const
+{
+    static const std::vector<MultipartParser::File> NO_FILES;
+    return multipart_ ? multipart_->Files() : NO_FILES;
 }
 
 /**
- * @brief 是否保持连接
- * 
- * @return true 
- * @return false 
+ * @brief 请求完整后调用匹配到的路由处理函数， 没有时按路径响应静态文件
+ *
+ * @param response 已按请求路径初始化
  */
-bool HttpRequest::IsKeepAlive() const
+void HttpRequest::Dispatch(HttpResponse &response)
 {
-    if (header_.count("Connection") == 1)
+    if (route_.route && route_.route->handler)
     {
-        return header_.find("Connection")->second == "keep-alive" &&
-               version_ == "1.1";
+        route_.route->handler(*this, response);
     }
-    return false;
 }
 
 /**
- * @brief 解析请求行
+ * @brief 注册内容实体处理函数， 需在服务器启动前调用
+ *
+ * @param method 请求方法
+ * @param path 路径模式， 见Router
+ * @param handler
+ */
+void HttpRequest::SetBodyHandler(const std::string &method,
+                                 const std::string &path,
+                                 BodyHandler handler)
+{
+    router.Add(method, path).bodyHandler = std::move(handler);
+}
+
+/**
+ * @brief 允许向该路径POST带文件的multipart/form-data， 需在服务器启动前调用
+ *
+ * 文件边接收边写入uploadDir下的临时文件， 合计不超过maxUpload。 其余路径的
+ * multipart内容实体被丢弃， 不写入磁盘。
+ *
+ * @param path 路径模式， 见Router
+ */
+void HttpRequest::AllowUpload(const std::string &path)
+{
+    router.Add("POST", path).upload = true;
+}
+
+/**
+ * @brief 是否保持连接
  * 
- * @param line 
  * @return true 
  * @return false 
  */
-bool HttpRequest::ParseRequestLine_(const std::string &line)
+bool HttpRequest::IsKeepAlive() const
+{
+    return keepAlive_;
+}
+
+/**
+ * @brief 根据Transfer-Encoding与Content-Length确定内容实体的分帧方式
+ *
+ * 两者同时出现时可能被用于请求走私， 直接拒绝。
+ *
+ * @return true
+ * @return false 字段值非法
+ */
+bool HttpRequest::ParseFraming_()
 {
-    // 正则表达式解析请求行
-    std::regex patten("^([^ ]*) ([^ ]*) HTTP/([^ ]*)$");
-    std::smatch subMatch;
-    if (std::regex_match(line, subMatch, patten))
-    {
-        method_ = subMatch[1];
-        path_ = subMatch[2];
-        version_ = subMatch[3];
-        state_ = HEADERS;
+    std::string_view te = parser_.GetHeader(HttpHeader::TRANSFER_ENCODING);
+    std::string_view cl = parser_.GetHeader(HttpHeader::CONTENT_LENGTH);
+    bodyState_ = BODY_NONE;
+    remaining_ = 0;
+    if (!te.empty())
+    {
+        if (!cl.empty() || !HttpParser::EqualsIgnoreCase(te, "chunked"))
+        {
+            return false;
+        }
+        bodyState_ = CHUNK_SIZE;
         return true;
     }
-    LOG_ERROR("RequestLine Error");
-    return false;
+    if (cl.empty())
+    {
+        return true;
+    }
+    if (cl.size() > 18)
+    {
+        return false;
+    }
+    for (char ch : cl)
+    {
+        if (ch < '0' || ch > '9')
+        {
+            return false;
+        }
+        remaining_ = remaining_ * 10 + (ch - '0');
+    }
+    if (remaining_ > 0)
+    {
+        bodyState_ = BODY_LENGTH;
+    }
+    return true;
 }
 
 /**
- * @brief 解析请求首部字段[首部字段为可选项]
- * 
- * @param line 
+ * @brief 允许上传的路径上的multipart/form-data请求， 边接收边解析
+ *
+ * @return true
+ * @return false boundary非法
  */
-void HttpRequest::ParseHeader_(const std::string &line)
+bool HttpRequest::InitForm_()
 {
-    /*
-        正则表达式匹配首部字段
-        格式为 key: value
-    */
-    std::regex patten("^([^:]*): ?(.*)$");
-    std::smatch subMatch;
-    if (std::regex_match(line, subMatch, patten))
+    std::string_view type = GetHeader(HttpHeader::CONTENT_TYPE);
+    if (bodyState_ == BODY_NONE || method_ != "POST" || !route_.route ||
+        !route_.route->upload || route_.route->bodyHandler ||
+        !MultipartParser::IsMultipart(type))
     {
-        header_[subMatch[1]] = subMatch[2];
+        return true;
     }
-    else
+    if (!multipart_)
     {
-        /*遇到空行， 开始解析内容实体*/
-        state_ = BODY;
+        multipart_ = std::make_unique<MultipartParser>();
     }
+    return multipart_->Init(type, uploadDir, maxUpload);
 }
 
 /**
- * @brief 解析body
- * 
- * @param line 
+ * @brief 处理缓冲区中已到达的内容实体
+ *
+ * @param buff
+ * @return HTTP_CODE
+ */
+HttpRequest::HTTP_CODE HttpRequest::ParseBody_(Buffer &buff)
+{
+    while (true)
+    {
+        const char *begin = buff.Peek();
+        const char *end = buff.BeginWriteConst();
+        switch (bodyState_)
+        {
+        case BODY_NONE:
+            return OnBody_(nullptr, 0, true) ? GET_REQUEST : BAD_REQUEST;
+        case BODY_LENGTH:
+        case CHUNK_DATA:
+        {
+            size_t len = std::min(remaining_, buff.ReadableBytes());
+            if (len == 0)
+            {
+                return NO_REQUEST;
+            }
+            remaining_ -= len;
+            bool last = bodyState_ == BODY_LENGTH && remaining_ == 0;
+            if (!OnBody_(begin, len, last))
+            {
+                return BAD_REQUEST;
+            }
+            buff.Retrieve(len);
+            if (last)
+            {
+                return GET_REQUEST;
+            }
+            if (remaining_ == 0)
+            {
+                bodyState_ = CHUNK_DATA_CRLF;
+            }
+            break;
+        }
+        case CHUNK_DATA_CRLF:
+            if (end - begin < 2)
+            {
+                return NO_REQUEST;
+            }
+            if (begin[0] != '\r' || begin[1] != '\n')
+            {
+                return BAD_REQUEST;
+            }
+            buff.Retrieve(2);
+            bodyState_ = CHUNK_SIZE;
+            break;
+        case CHUNK_SIZE:
+        case CHUNK_TRAILER:
+        {
+            /* 行尾未到达时记住查找位置， 下次只查找新到达的数据 */
+            const char *eol = HttpParser::FindEol(begin + lineScanned_, end);
+            if (eol - begin > static_cast<ptrdiff_t>(MAX_CHUNK_LINE))
+            {
+                return BAD_REQUEST;
+            }
+            if (eol == end || eol + 1 == end)
+            {
+                lineScanned_ = eol - begin;
+                return NO_REQUEST;
+            }
+            lineScanned_ = 0;
+            if (eol[0] != '\r' || eol[1] != '\n')
+            {
+                return BAD_REQUEST;
+            }
+            if (bodyState_ == CHUNK_SIZE)
+            {
+                if (!ParseChunkSize_(begin, eol))
+                {
+                    return BAD_REQUEST;
+                }
+                /* 大小为0的块表示结束， 之后是trailer */
+                bodyState_ = remaining_ > 0 ? CHUNK_DATA : CHUNK_TRAILER;
+            }
+            else if (eol == begin)
+            {
+                buff.Retrieve(2);
+                return OnBody_(nullptr, 0, true) ? GET_REQUEST : BAD_REQUEST;
+            }
+            buff.RetrieveUntil(eol + 2);
+            break;
+        }
+        }
+    }
+}
+
+/**
+ * @brief 解析块大小行： 十六进制大小， 可带;开头的扩展
+ *
+ * @param begin
+ * @param end 行尾(不含CRLF)
+ * @return true
+ * @return false
  */
-void HttpRequest::ParseBody_(const std::string &line)
+bool HttpRequest::ParseChunkSize_(const char *begin, const char *end)
 {
-    body_ = line;
-    ParsePost_();
-    state_ = FINISH;
-    LOG_DEBUG("Body:%s, len:%d", line.c_str(), line.size());
+    const char *ext = HttpParser::FindChar(begin, end, ';');
+    while (ext > begin && (ext[-1] == ' ' || ext[-1] == '\t'))
+    {
+        ext--;
+    }
+    if (ext == begin || ext - begin > 15)
+    {
+        return false;
+    }
+    remaining_ = 0;
+    for (const char *p = begin; p < ext; p++)
+    {
+        int digit = HexDigit(*p);
+        if (digit < 0)
+        {
+            return false;
+        }
+        remaining_ = remaining_ * 16 + digit;
+    }
+    return true;
 }
 
 /**
- * @brief 解析文件路径
- * 
+ * @brief 交付一段内容实体
+ *
+ * 注册了处理函数时交给处理函数； multipart表单边到达边解析， 文件写入临时文件；
+ * urlencoded表单与JSON缓存后解析(有上限)； 其余内容实体直接丢弃。
+ *
+ * @param data
+ * @param len
+ * @param last 是否为最后一段
+ * @return true
+ * @return false 处理函数拒绝或表单过大
  */
-void HttpRequest::ParsePath_()
+bool HttpRequest::OnBody_(const char *data, size_t len, bool last)
 {
-    if (path_ == "/")
+    if (route_.route && route_.route->bodyHandler)
     {
-        path_ = "/index.html";
+        return route_.route->bodyHandler(*this, std::string_view(data, len), last);
     }
-    else
+    if (multipart_ && multipart_->Active())
     {
-        /*如果请求路径在预设路径中， 为其加上.html后缀*/
-        for (auto &it : DEFAULT_HTML)
+        if (!multipart_->Feed(data, len) || (last && !multipart_->Finish()))
+        {
+            return false;
+        }
+        if (last)
         {
-            if (it == path_)
+            for (auto &field : multipart_->Fields())
             {
-                path_ += ".html";
-                break;
+                post_.Add(field.first, field.second);
             }
         }
+        return true;
+    }
+    if (method_ != "POST")
+    {
+        return true;
+    }
+    std::string_view type = GetHeader(HttpHeader::CONTENT_TYPE);
+    bool isJson = JsonDoc::IsJson(type);
+    if (!isJson && type != "application/x-www-form-urlencoded")
+    {
+        return true;
+    }
+    if (body_.size() + len > MAX_FORM_BODY)
+    {
+        return false;
+    }
+    body_.append(data, len);
+    if (last && !body_.empty())
+    {
+        LOG_DEBUG("Body:%s, len:%d", body_.c_str(), body_.size());
+        if (isJson)
+        {
+            return json_.Parse(body_);
+        }
+        ParsePost_();
     }
+    return true;
+}
+
+/**
+ * @brief 在?处拆分请求目标， 路径解码后存入path_， 查询字符串拷贝到arena_
+ *
+ * @return true
+ * @return false 解码后的路径含有'\0'或..段， 后者会拼接出srcDir之外的路径
+ */
+bool HttpRequest::ParseTarget_()
+{
+    std::string_view target = parser_.Path();
+    size_t mark = target.find('?');
+    path_.assign(target.substr(0, mark));
+    path_.resize(FormData::Decode(&path_[0], path_.size(), false));
+    if (path_.find('\0') != std::string::npos)
+    {
+        return false;
+    }
+    /* 解码后检查， %2e%2e等编码形式同样拒绝 */
+    for (size_t begin = 0; begin <= path_.size();)
+    {
+        size_t end = path_.find('/', begin);
+        if (end == std::string::npos)
+        {
+            end = path_.size();
+        }
+        if (path_.compare(begin, end - begin, "..") == 0)
+        {
+            return false;
+        }
+        begin = end + 1;
+    }
+    if (mark != std::string_view::npos)
+    {
+        std::string_view query = target.substr(mark + 1);
+        char *copy = static_cast<char *>(arena_.Allocate(query.size(), 1));
+        memcpy(copy, query.data(), query.size());
+        query_.Parse(copy, query.size());
+    }
+    return true;
 }
 
 /**
@@ -233,77 +588,79 @@ void HttpRequest::ParsePath_()
 void HttpRequest::ParsePost_()
 {
     if (method_ == "POST" &&
-        header_["Content-Type"] == "application/x-www-form-urlencoded")
+        GetHeader(HttpHeader::CONTENT_TYPE) == "application/x-www-form-urlencoded")
     {
         ParseFromUrlencoded_();
-        if (DEFAULT_HTML_TAG.count(path_))
-        {
-            int tag = DEFAULT_HTML_TAG.find(path_)->second;
-            LOG_DEBUG("Tag:%d", tag);
-            if (tag == 0 || tag == 1)
-            {
-                /* 判断当前请求是否为登录请求*/
-                bool isLogin = (tag == 1);
-                if (UserVerify(post_["username"], post_["password"], isLogin))
-                {
-                    path_ = "/welcome.html";
-                }
-                else
-                {
-                    path_ = "/error.html";
-                }
-            }
-        }
     }
 }
 
 /**
- * @brief 解析url编码
- * 
+ * @brief 缺省路由： 页面去掉.html后缀的别名， 以及登录、注册(表单或JSON)
+ *
+ * @return Router
  */
-void HttpRequest::ParseFromUrlencoded_()
+Router HttpRequest::DefaultRouter_()
 {
-    if (body_.size() == 0)
+    Router r;
+    auto page = [](const std::string &file) {
+        return [file](HttpRequest &, HttpResponse &response) {
+            response.SetPath(file);
+        };
+    };
+    r.Add("GET", "/", page("/index.html"));
+    for (const char *name :
+         {"/index", "/register", "/login", "/welcome", "/video", "/picture"})
     {
-        return;
+        r.Add("GET", name, page(std::string(name) + ".html"));
     }
-    std::string key, value;
-    int num = 0;
-    int n = body_.size();
-    int i = 0, j = 0;
-    for (; i < n; i++)
+    auto form = [](bool isLogin) {
+        return [isLogin](HttpRequest &request, HttpResponse &response) {
+            JsonValue json = request.GetJson();
+            if (request.post_.Empty() && !json.IsValid())
+            {
+                /* 没有表单时返回页面本身 */
+                response.SetPath(isLogin ? "/login.html" : "/register.html");
+                return;
+            }
+            if (json.IsValid())
+            {
+                /* JSON请求以JSON响应 */
+                bool ok = UserVerify(std::string(json["username"].AsString()),
+                                     std::string(json["password"].AsString()),
+                                     isLogin);
+                response.SetContent(ok ? "{\"ok\":true}" : "{\"ok\":false}",
+                                    "application/json");
+                return;
+            }
+            bool ok = UserVerify(request.GetPost("username"),
+                                 request.GetPost("password"),
+                                 isLogin);
+            response.SetPath(ok ? "/welcome.html" : "/error.html");
+        };
+    };
+    for (const char *name : {"/login", "/login.html"})
     {
-        char ch = body_[i];
-        switch (ch)
-        {
-        case '=':
-            key = body_.substr(j, i - j);
-            j = i + 1;
-            break;
-        case '+':
-            body_[i] = ' ';
-            break;
-        case '%':
-            num = ConverHex(body_[i + 1]) * 16 + ConverHex(body_[i + 2]);
-            body_[i + 2] = num % 10 + '0';
-            body_[i + 1] = num / 10 + '0';
-            i += 2;
-            break;
-        case '&':
-            value = body_.substr(j, i - j);
-            j = i + 1;
-            post_[key] = value;
-            LOG_DEBUG("%s = %s", key.c_str(), value.c_str());
-            break;
-        default:
-            break;
-        }
+        r.Add("POST", name, form(true));
     }
-    assert(j <= i);
-    if (!post_.count(key) && j < i)
+    for (const char *name : {"/register", "/register.html"})
     {
-        value = body_.substr(j, i - j);
-        post_[key] = value;
+        r.Add("POST", name, form(false));
+    }
+    return r;
+}
+
+/**
+ * @brief 解析url编码， 在body_上原地解码
+ * 
+ */
+void HttpRequest::ParseFromUrlencoded_()
+{
+    post_.Parse(&body_[0], body_.size());
+    for (auto &field : post_.Fields())
+    {
+        LOG_DEBUG("%.*s = %.*s",
+                  static_cast<int>(field.first.size()), field.first.data(),
+                  static_cast<int>(field.second.size()), field.second.data());
     }
 }
 
@@ -399,18 +756,3 @@ bool HttpRequest::UserVerify(const std::string &name,
     LOG_DEBUG("UserVerify success!");
     return flag;
 }
-
-/**
- * @brief 转换16进制
- * 
- * @param ch 
- * @return int 
- */
-int HttpRequest::ConverHex(char ch)
-{
-    if (ch >= 'A' && ch <= 'F')
-        return ch - 'A' + 10;
-    if (ch >= 'a' && ch <= 'f')
-        return ch - 'a' + 10;
-    return ch;
-}
@@ -13,13 +13,20 @@
 #define HTTP_REQUEST_H
 
 #include <unordered_map>
-#include <unordered_set>
 #include <string>
-#include <regex>
+#include <string_view>
+#include <functional>
+#include <memory>
 #include <errno.h>
 #include <mysql/mysql.h>
 
+#include "arena.h"
 #include "buffer.h"
+#include "formdata.h"
+#include "httpparser.h"
+#include "json.h"
+#include "multipart.h"
+#include "router.h"
 #include "log.h"
 #include "sqlconnpool.h"
 #include "sqlconnRAII.h"
@@ -45,13 +52,25 @@ public:
         FILE_REQUEST,
         INTERNAL_ERROR,
         CLOSED_CONNECTION,
+        PAYLOAD_TOO_LARGE,
     };
 
+    /**
+     * @brief 内容实体处理函数
+     *
+     * 内容实体按到达顺序分段传入， 最后一次调用时last为true(data可能为空)，
+     * 返回false时以400结束该请求。 回调中可以通过GetHeader读取首部字段。
+     */
+    typedef Router::BodyHandler BodyHandler;
+
+    static const size_t MAX_FORM_BODY = 64 * 1024; // 缓存在body_中的表单上限
+    static const size_t MAX_CHUNK_LINE = 4096; // 块大小行与trailer行的长度上限
+
     HttpRequest() { Init(); }
     ~HttpRequest() = default;
 
     void Init();
-    bool parse(Buffer &buff);
+    HTTP_CODE parse(Buffer &buff);
 
     std::string path() const;
     std::string &path();
@@ -59,20 +78,50 @@ public:
     std::string version() const;
     std::string GetPost(const std::string &key) const;
     std::string GetPost(const char *key) const;
+    std::string_view GetQuery(std::string_view key) const;
+    /* application/json请求的内容实体， 不是JSON时为INVALID */
+    JsonValue GetJson() const { return json_.Root(); }
 
     bool IsKeepAlive() const;
+    /* 当前请求的临时内存， 下一个请求开始时整体释放 */
+    Arena &GetArena() { return arena_; }
+
+    std::string_view GetHeader(std::string_view name) const;
+    std::string_view GetHeader(HttpHeader id) const;
+    std::string_view GetParam(std::string_view name) const;
+    const MultipartParser::File *GetFile(const std::string &name) const;
+    const std::vector<MultipartParser::File> &GetFiles() const;
+
+    void Dispatch(HttpResponse &response);
+
+    static void SetBodyHandler(const std::string &method,
+                               const std::string &path,
+                               BodyHandler handler);
+    static void AllowUpload(const std::string &path);
 
-    /* todo!
-    void HttpConn::ParseFormData();
-    void HttpConn::ParseJson();
-    */
+    static Router router; // 需在服务器启动前注册路由
+    static std::string uploadDir; // 上传文件的临时目录
+    static size_t maxUpload;      // 单个请求上传文件的合计上限
 
 private:
-    bool ParseRequestLine_(const std::string &line);
-    void ParseHeader_(const std::string &line);
-    void ParseBody_(const std::string &line);
+    /* 内容实体的分帧方式 */
+    enum BODY_STATE
+    {
+        BODY_NONE,
+        BODY_LENGTH,     // 按Content-Length
+        CHUNK_SIZE,      // chunked: 块大小行
+        CHUNK_DATA,      // chunked: 块数据
+        CHUNK_DATA_CRLF, // chunked: 块数据后的CRLF
+        CHUNK_TRAILER,   // chunked: 结尾的trailer与空行
+    };
 
-    void ParsePath_();
+    bool ParseFraming_();
+    bool InitForm_();
+    HTTP_CODE ParseBody_(Buffer &buff);
+    bool ParseChunkSize_(const char *begin, const char *end);
+    bool OnBody_(const char *data, size_t len, bool last);
+
+    bool ParseTarget_();
     void ParsePost_();
     void ParseFromUrlencoded_();
 
@@ -81,12 +130,21 @@ private:
 
     PARSE_STATE state_;
     std::string method_, path_, version_, body_;
-    std::unordered_map<std::string, std::string> header_;
-    std::unordered_map<std::string, std::string> post_;
-
-    static const std::unordered_set<std::string> DEFAULT_HTML;
-    static const std::unordered_map<std::string, int> DEFAULT_HTML_TAG;
-    static int ConverHex(char ch);
+    bool keepAlive_;
+    BODY_STATE bodyState_;
+    size_t remaining_;       // 当前块(或整个内容实体)尚未收到的字节数
+    size_t lineScanned_;     // 当前块大小行或trailer行已查找过行尾的字节数
+    Arena arena_;            // 有内容实体时拷贝出的请求头等， 缓冲区可随即释放
+    Router::Match route_; // 参数值指向path_
+    /* 第一个multipart请求时创建， 空闲连接不占用解析状态； 上传的文件在
+       下一个请求开始时删除 */
+    std::unique_ptr<MultipartParser> multipart_;
+    JsonDoc json_;              // 字符串指向body_
+    HttpParser parser_; // 跨多次读取保存解析进度， 请求完成后才重置
+    FormData post_;  // 指向body_或multipart_的表单字段
+    FormData query_; // 指向arena_中的查询字符串
+
+    static Router DefaultRouter_();
 };
 
 #endif // HTTP_REQUEST_H
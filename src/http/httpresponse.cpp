@@ -11,6 +11,11 @@
 
 #include "httpresponse.h"
 
+#include <charconv>
+#include <string.h>
+
+#include "httpparser.h"
+
 const std::unordered_map<std::string, std::string> HttpResponse::SUFFIX_TYPE{
     {".html", "text/html"},
     {".xml", "text/xml"},
@@ -33,10 +38,24 @@ const std::unordered_map<std::string, std::string> HttpResponse::SUFFIX_TYPE{
     {".js", "text/javascript"}};
 
 const std::unordered_map<int, std::string> HttpResponse::CODE_STATUS{
-    {200, "OK"}, {400, "Bad Request"}, {403, "Forbidden"}, {404, "Not Found"}};
+    {200, "OK"},
+    {206, "Partial Content"},
+    {304, "Not Modified"},
+    {400, "Bad Request"},
+    {403, "Forbidden"},
+    {404, "Not Found"},
+    {405, "Method Not Allowed"},
+    {413, "Payload Too Large"},
+    {500, "Internal Server Error"},
+    {503, "Service Unavailable"}};
+
+long HttpResponse::sendfileThreshold = -1;
+
+std::vector<HttpResponse::CacheRule> HttpResponse::cacheRules_;
 
 const std::unordered_map<int, std::string> HttpResponse::CODE_PATH{
-    {400, "/400.html"}, {403, "/403.html"}, {404, "/404.html"}};
+    {400, "/400.html"}, {403, "/403.html"}, {404, "/404.html"}, {405, "/405.html"},
+    {413, "/413.html"}};
 /**
  * @brief Construct a new Http Response:: Http Response object
  * 
@@ -46,8 +65,12 @@ HttpResponse::HttpResponse()
     code_ = -1;
     path_ = srcDir_ = "";
     isKeepAlive_ = false;
+    keepAliveTimeout_ = keepAliveMax_ = 0;
+    acceptEncoding_ = FileCache::IDENTITY;
+    hasContent_ = false;
+    file_ = nullptr;
     mmFile_ = nullptr;
-    mmFileStat_ = {0};
+    fileFd_ = -1;
 }
 
 /**
@@ -64,62 +87,327 @@ HttpResponse::~HttpResponse() { UnmapFile(); }
  * @param isKeepAlive 
  * @param code 
  */
-void HttpResponse::Init(const std::string &srcDir,
+void HttpResponse::Init(std::string_view srcDir,
                         std::string &path,
                         bool isKeepAlive,
                         int code)
 {
-    assert(srcDir != "");
-    if (mmFile_)
-    {
-        UnmapFile();
-    }
+    assert(!srcDir.empty());
+    UnmapFile();
     code_ = code;
     isKeepAlive_ = isKeepAlive;
+    keepAliveTimeout_ = keepAliveMax_ = 0;
+    acceptEncoding_ = FileCache::IDENTITY;
+    ifNoneMatch_ = ifModifiedSince_ = std::string_view();
     path_ = path;
-    srcDir_ = srcDir;
-    mmFile_ = nullptr;
-    mmFileStat_ = {0};
+    srcDir_.assign(srcDir);
+    file_ = nullptr;
+    hasContent_ = false;
+    content_.clear();
+    contentType_.clear();
+}
+
+/**
+ * @brief 设置保持连接时Keep-Alive首部公布的限制
+ *
+ * @param timeout 空闲超时(秒)， 0表示不发送
+ * @param max 该连接还可以处理的请求数， 0表示不发送
+ */
+void HttpResponse::SetKeepAlive(int timeout, int max)
+{
+    keepAliveTimeout_ = timeout;
+    keepAliveMax_ = max;
+}
+
+/**
+ * @brief 设置请求的Accept-Encoding， 可压缩的静态文件据此选择编码
+ *
+ * @param value 首部的值， 为空表示只接受原始内容
+ */
+void HttpResponse::SetAcceptEncoding(std::string_view value)
+{
+    acceptEncoding_ =
+        value.empty() ? static_cast<unsigned>(FileCache::IDENTITY) : AcceptedEncodings(value);
+}
+
+/**
+ * @brief 解析Accept-Encoding中接受的编码
+ *
+ * q=0的编码不接受； *表示未列出的编码。 只关心是否接受， 多个编码都
+ * 接受时由服务器按br、 gzip的顺序选择。
+ *
+ * @param value
+ * @return unsigned FileCache::Encoding的组合
+ */
+unsigned HttpResponse::AcceptedEncodings(std::string_view value)
+{
+    const unsigned ALL = FileCache::GZIP | FileCache::BR;
+    unsigned accepted = 0, listed = 0;
+    bool others = false;
+    while (!value.empty())
+    {
+        size_t comma = value.find(',');
+        std::string_view item = value.substr(0, comma);
+        value.remove_prefix(comma == std::string_view::npos ? value.size() : comma + 1);
+
+        size_t semi = item.find(';');
+        std::string_view name = item.substr(0, semi);
+        while (!name.empty() && (name.front() == ' ' || name.front() == '\t'))
+        {
+            name.remove_prefix(1);
+        }
+        while (!name.empty() && (name.back() == ' ' || name.back() == '\t'))
+        {
+            name.remove_suffix(1);
+        }
+        /* q=0、 q=0.0等表示不接受 */
+        bool refused = false;
+        if (semi != std::string_view::npos)
+        {
+            std::string_view params = item.substr(semi + 1);
+            size_t q = params.find("q=");
+            if (q != std::string_view::npos)
+            {
+                std::string_view qvalue = params.substr(q + 2);
+                size_t end = qvalue.find_first_not_of("0123456789.");
+                qvalue = qvalue.substr(0, end);
+                refused = !qvalue.empty() &&
+                          qvalue.find_first_not_of("0.") == std::string_view::npos;
+            }
+        }
+        unsigned bit = 0;
+        if (HttpParser::EqualsIgnoreCase(name, "gzip") ||
+            HttpParser::EqualsIgnoreCase(name, "x-gzip"))
+        {
+            bit = FileCache::GZIP;
+        }
+        else if (HttpParser::EqualsIgnoreCase(name, "br"))
+        {
+            bit = FileCache::BR;
+        }
+        else if (name == "*")
+        {
+            others = !refused;
+            continue;
+        }
+        listed |= bit;
+        accepted = refused ? accepted & ~bit : accepted | bit;
+    }
+    if (others)
+    {
+        accepted |= ALL & ~listed;
+    }
+    return accepted;
+}
+
+/**
+ * @brief 设置GET请求的条件首部
+ *
+ * If-None-Match优先， 存在时忽略If-Modified-Since。
+ *
+ * @param ifNoneMatch
+ * @param ifModifiedSince
+ */
+void HttpResponse::SetConditions(std::string_view ifNoneMatch,
+                                 std::string_view ifModifiedSince)
+{
+    ifNoneMatch_ = ifNoneMatch;
+    ifModifiedSince_ = ifModifiedSince;
+}
+
+/**
+ * @brief 以弱比较判断If-None-Match是否包含etag
+ *
+ * @param ifNoneMatch 逗号分隔的实体标签或*
+ * @param etag
+ * @return true
+ * @return false
+ */
+bool HttpResponse::ETagMatches(std::string_view ifNoneMatch, std::string_view etag)
+{
+    auto opaque = [](std::string_view tag) {
+        if (tag.size() >= 2 && tag[0] == 'W' && tag[1] == '/')
+        {
+            tag.remove_prefix(2);
+        }
+        return tag;
+    };
+    etag = opaque(etag);
+    while (!ifNoneMatch.empty())
+    {
+        size_t comma = ifNoneMatch.find(',');
+        std::string_view tag = ifNoneMatch.substr(0, comma);
+        while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t'))
+        {
+            tag.remove_prefix(1);
+        }
+        while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t'))
+        {
+            tag.remove_suffix(1);
+        }
+        if (tag == "*" || opaque(tag) == etag)
+        {
+            return true;
+        }
+        if (comma == std::string_view::npos)
+        {
+            break;
+        }
+        ifNoneMatch.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+/**
+ * @brief 解析IMF-fixdate格式的HTTP日期， 如Sun, 06 Nov 1994 08:49:37 GMT
+ *
+ * @param date
+ * @return time_t 格式不正确时为-1
+ */
+time_t HttpResponse::ParseHttpDate(std::string_view date)
+{
+    char text[64];
+    if (date.size() >= sizeof(text))
+    {
+        return -1;
+    }
+    memcpy(text, date.data(), date.size());
+    text[date.size()] = '\0';
+    struct tm tm = {};
+    const char *end = strptime(text, "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    if (end == nullptr || *end != '\0')
+    {
+        return -1;
+    }
+    return timegm(&tm);
+}
+
+/**
+ * @brief 设置静态文件的Cache-Control规则， 需在服务器启动前调用
+ *
+ * 规则以';'分隔， 每条为"匹配:指令"， 如
+ * "/assets/:public, max-age=31536000, immutable;.html:no-cache"。
+ *
+ * @param rules
+ */
+void HttpResponse::SetCacheControl(std::string_view rules)
+{
+    auto trim = [](std::string_view text) {
+        while (!text.empty() && text.front() == ' ')
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && text.back() == ' ')
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    };
+    cacheRules_.clear();
+    while (!rules.empty())
+    {
+        size_t semi = rules.find(';');
+        std::string_view rule = rules.substr(0, semi);
+        size_t colon = rule.find(':');
+        if (colon != std::string_view::npos)
+        {
+            std::string_view match = trim(rule.substr(0, colon));
+            std::string_view directive = trim(rule.substr(colon + 1));
+            if (!match.empty() && !directive.empty())
+            {
+                cacheRules_.push_back({std::string(match),
+                                       "Cache-Control: " + std::string(directive) + "\r\n"});
+            }
+        }
+        if (semi == std::string_view::npos)
+        {
+            break;
+        }
+        rules.remove_prefix(semi + 1);
+    }
+}
+
+/**
+ * @brief 设置由处理函数生成的响应内容， 代替文件
+ *
+ * @param content
+ * @param type Content-type
+ */
+void HttpResponse::SetContent(std::string content, const std::string &type)
+{
+    hasContent_ = true;
+    content_ = std::move(content);
+    contentType_ = type;
 }
 
 /**
  * @brief 生成响应
- * 
- * @param buff 
+ *
+ * 首部直接写入buff， 拼接的文件路径等临时数据存放在arena中。
+ *
+ * @param buff
+ * @param arena 当前请求的Arena
  */
-void HttpResponse::MakeResponse(Buffer &buff)
+void HttpResponse::MakeResponse(Buffer &buff, Arena &arena)
 {
-    /* 判断请求的资源文件 */
-    if (stat((srcDir_ + path_).data(), &mmFileStat_) < 0 ||
-        S_ISDIR(mmFileStat_.st_mode))
+    if (hasContent_)
+    {
+        if (code_ == -1)
+        {
+            code_ = 200;
+        }
+        AddStateLine_(buff);
+        AddHeader_(buff);
+        AddContent_(buff);
+        return;
+    }
+    /* 条件请求命中时只发送首部， 不打开文件 */
+    if ((code_ == -1 || code_ == 200) &&
+        (!ifNoneMatch_.empty() || !ifModifiedSince_.empty()) && NotModified_(buff, arena))
     {
-        code_ = 404;
+        return;
     }
-    else if (!(mmFileStat_.st_mode & S_IROTH)) // 判断文件是否具有读权限
+    /* 已确定为错误页面时不打开请求的路径， 400的路径可能不可信 */
+    if (code_ >= 400 && CODE_PATH.count(code_))
     {
-        code_ = 403;
+        ErrorHtml_(arena);
+        AddStateLine_(buff);
+        AddHeader_(buff);
+        AddContent_(buff);
+        return;
+    }
+    /* 判断请求的资源文件， 条件请求时可能已在缓存中取得 */
+    if (!entry_)
+    {
+        OpenFile_(arena);
+    }
+    if (entry_->code != 200)
+    {
+        code_ = entry_->code;
     }
     else if (code_ == -1)
     {
         code_ = 200;
     }
-    ErrorHtml_();
+    ErrorHtml_(arena);
+    if (code_ == 200)
+    {
+        Negotiate_();
+    }
     AddStateLine_(buff);
     AddHeader_(buff);
     AddContent_(buff);
 }
 
 /**
- * @brief 解除文件映射
+ * @brief 释放文件， 缓存中的文件在最后一个引用释放时关闭
  * 
  */
 void HttpResponse::UnmapFile()
 {
-    if (mmFile_)
-    {
-        munmap(mmFile_, mmFileStat_.st_size);
-        mmFile_ = nullptr;
-    }
+    entry_.reset();
+    mmFile_ = nullptr;
+    fileFd_ = -1;
 }
 
 char *HttpResponse::File() { return mmFile_; }
@@ -129,7 +417,7 @@ char *HttpResponse::File() { return mmFile_; }
  * 
  * @return size_t 
  */
-size_t HttpResponse::FileLen() const { return mmFileStat_.st_size; }
+size_t HttpResponse::FileLen() const { return entry_ ? entry_->size : 0; }
 
 void HttpResponse::ErrorContent(Buffer &buff, std::string message)
 {
@@ -154,106 +442,325 @@ void HttpResponse::ErrorContent(Buffer &buff, std::string message)
 }
 
 /**
- * @brief 添加状态行
+ * @brief 添加状态行与Connection首部
+ *
+ * 两者只取决于状态码与是否保持连接， 首次使用时为每种组合生成一次。
  * 
  * @param buff 
  */
 void HttpResponse::AddStateLine_(Buffer &buff)
 {
-    std::string status;
-    if (CODE_STATUS.count(code_) == 1)
-    {
-        status = CODE_STATUS.find(code_)->second;
-    }
-    else
+    static const std::unordered_map<int, std::array<std::string, 2>> HEAD_PREFIX =
+        [] {
+            std::unordered_map<int, std::array<std::string, 2>> prefix;
+            for (auto &status : CODE_STATUS)
+            {
+                std::string line = "HTTP/1.1 " + std::to_string(status.first) +
+                                   " " + status.second + "\r\nConnection: ";
+                prefix[status.first] = {line + "close\r\n", line + "keep-alive\r\n"};
+            }
+            return prefix;
+        }();
+    auto it = HEAD_PREFIX.find(code_);
+    if (it == HEAD_PREFIX.end())
     {
         code_ = 400;
-        status = CODE_STATUS.find(400)->second;
+        it = HEAD_PREFIX.find(400);
     }
-    buff.Append("HTTP/1.1 " + std::to_string(code_) + " " + status + "\r\n");
+    buff.Append(it->second[isKeepAlive_]);
 }
 
 /**
- * @brief 添加首部字段
+ * @brief 添加Keep-Alive与Date首部
  * 
  * @param buff 
  */
 void HttpResponse::AddHeader_(Buffer &buff)
 {
-    buff.Append("Connection: ");
-    if (isKeepAlive_)
+    if (isKeepAlive_ && (keepAliveTimeout_ > 0 || keepAliveMax_ > 0))
     {
-        buff.Append("keep-alive\r\n");
-        buff.Append("keep-alive: max=6, timeout=120\r\n");
+        buff.Append("Keep-Alive: ");
+        if (keepAliveTimeout_ > 0)
+        {
+            buff.Append("timeout=");
+            AppendNumber_(buff, keepAliveTimeout_);
+            buff.Append(keepAliveMax_ > 0 ? ", " : "");
+        }
+        if (keepAliveMax_ > 0)
+        {
+            buff.Append("max=");
+            AppendNumber_(buff, keepAliveMax_);
+        }
+        buff.Append("\r\n");
     }
-    else
+    buff.Append(DateHeader_());
+}
+
+/**
+ * @brief Date首部， 每个线程每秒格式化一次
+ *
+ * @return std::string_view 含结尾的CRLF
+ */
+std::string_view HttpResponse::DateHeader_()
+{
+    static thread_local time_t last = -1;
+    static thread_local char header[64];
+    static thread_local size_t len = 0;
+    time_t now = time(nullptr);
+    if (now != last)
+    {
+        struct tm tm;
+        gmtime_r(&now, &tm);
+        len = strftime(header, sizeof(header), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm);
+        last = now;
+    }
+    return std::string_view(header, len);
+}
+
+/**
+ * @brief 按请求路径添加Cache-Control首部
+ *
+ * @param buff
+ */
+void HttpResponse::AddCacheControl_(Buffer &buff)
+{
+    std::string_view path(path_);
+    for (const CacheRule &rule : cacheRules_)
     {
-        buff.Append("close\r\n");
+        bool matched = rule.match[0] == '/'
+                           ? path.compare(0, rule.match.size(), rule.match) == 0
+                           : path.size() >= rule.match.size() &&
+                                 path.compare(path.size() - rule.match.size(),
+                                              rule.match.size(), rule.match) == 0;
+        if (matched)
+        {
+            buff.Append(rule.header);
+            return;
+        }
     }
-    buff.Append("Content-type: " + GetFileType_() + "\r\n");
 }
 
 /**
  * @brief 添加响应内容
+ *
+ * 文件的Content-type与Content-length首部由缓存预先生成。
  * 
  * @param buff 
- * @param message 
  */
 void HttpResponse::AddContent_(Buffer &buff)
 {
-    int srcFd = open((srcDir_ + path_).data(), O_RDONLY);
-    if (srcFd < 0)
+    if (hasContent_)
     {
+        buff.Append("Content-type: ");
+        buff.Append(contentType_);
+        buff.Append("\r\nContent-length: ");
+        AppendNumber_(buff, content_.size());
+        buff.Append("\r\n\r\n");
+        buff.Append(content_);
+        return;
+    }
+    if (entry_->code != 200)
+    {
+        buff.Append("Content-type: ");
+        buff.Append(FileType(path_));
+        buff.Append("\r\n");
         ErrorContent(buff, "File NotFound!");
         return;
     }
+    LOG_DEBUG("file path %s", file_);
+    size_t size = entry_->size;
+    if (size > 0 && entry_->fd >= 0 &&
+        (!entry_->data ||
+         (sendfileThreshold >= 0 &&
+          size >= static_cast<size_t>(sendfileThreshold))))
+    {
+        /* 由HttpConn用sendfile从页缓存直接发送 */
+        fileFd_ = entry_->fd;
+    }
+    else
+    {
+        mmFile_ = entry_->data;
+    }
+    if (code_ == 200)
+    {
+        AddCacheControl_(buff);
+    }
+    buff.Append(entry_->header);
+}
 
-    /* 将文件映射到内存提高文件的访问速度
-        MAP——PRIVATE建立一个写入时拷贝的私有映射*/
-    LOG_DEBUG("file path %s", (srcDir_ + path_).data());
-    int *mmRet = (int *)mmap(
-        NULL, mmFileStat_.st_size, PROT_READ, MAP_PRIVATE, srcFd, 0);
-    if (*mmRet == -1)
+/**
+ * @brief 拼接文件路径file_
+ *
+ * @param arena
+ */
+void HttpResponse::FilePath_(Arena &arena)
+{
+    /* srcDir_以'/'结尾时去掉， 使路径与缓存监视的路径一致 */
+    std::string_view dir(srcDir_);
+    if (!dir.empty() && dir.back() == '/' && !path_.empty() && path_[0] == '/')
+    {
+        dir.remove_suffix(1);
+    }
+    file_ = arena.Concat(dir, path_);
+}
+
+/**
+ * @brief 从文件缓存中取得file_对应的条目
+ *
+ * @param arena
+ */
+void HttpResponse::OpenFile_(Arena &arena)
+{
+    FilePath_(arena);
+    /* 全部用sendfile发送时不需要映射 */
+    entry_ = FileCache::Instance()->Get(file_, FileType, sendfileThreshold != 0);
+}
+
+/**
+ * @brief 处理条件请求， 未修改时生成304响应
+ *
+ * 缓存命中时使用条目中的验证器， 否则只stat文件， 都不打开文件或映射。
+ * 未命中304时保留缓存的条目供生成完整响应。
+ *
+ * @param buff
+ * @param arena
+ * @return true 已生成304响应
+ * @return false
+ */
+bool HttpResponse::NotModified_(Buffer &buff, Arena &arena)
+{
+    FilePath_(arena);
+    FileCache::EntryPtr hit = FileCache::Instance()->Find(file_);
+    std::string etag, validators; // 只在未命中缓存时使用
+    std::string_view etagView, validatorsView;
+    time_t mtime;
+    bool vary;
+    if (hit)
+    {
+        if (hit->code != 200)
+        {
+            return false;
+        }
+        etagView = hit->etag;
+        validatorsView = hit->validators;
+        mtime = hit->mtime;
+        vary = hit->compressible;
+    }
+    else
+    {
+        struct stat st;
+        if (stat(file_, &st) < 0 || S_ISDIR(st.st_mode) || !(st.st_mode & S_IROTH))
+        {
+            return false;
+        }
+        etag = FileCache::ETag(st);
+        validators = FileCache::Validators(etag, st.st_mtime);
+        etagView = etag;
+        validatorsView = validators;
+        mtime = st.st_mtime;
+        vary = FileCache::Instance()->Compressible(st.st_size, FileType(file_));
+    }
+
+    bool notModified;
+    if (!ifNoneMatch_.empty())
+    {
+        notModified = ETagMatches(ifNoneMatch_, etagView);
+    }
+    else
+    {
+        time_t since = ParseHttpDate(ifModifiedSince_);
+        notModified = since >= 0 && mtime <= since;
+    }
+    if (!notModified)
+    {
+        entry_ = std::move(hit);
+        return false;
+    }
+    code_ = 304;
+    AddStateLine_(buff);
+    AddHeader_(buff);
+    AddCacheControl_(buff);
+    if (vary)
+    {
+        buff.Append("Vary: Accept-Encoding\r\n");
+    }
+    buff.Append(validatorsView);
+    buff.Append("\r\n");
+    return true;
+}
+
+/**
+ * @brief 按Accept-Encoding选择编码后的内容， 优先br
+ *
+ * 不接受任何编码或没有编码结果时发送原始内容， 可压缩的文件的响应都带有
+ * Vary: Accept-Encoding。
+ */
+void HttpResponse::Negotiate_()
+{
+    if (!entry_->compressible || acceptEncoding_ == FileCache::IDENTITY)
     {
-        ErrorContent(buff, "File NotFound!");
         return;
     }
-    mmFile_ = (char *)mmRet;
-    close(srcFd);
-    buff.Append("Content-length: " + std::to_string(mmFileStat_.st_size) +
-                "\r\n\r\n");
+    for (FileCache::Encoding encoding : {FileCache::BR, FileCache::GZIP})
+    {
+        if (acceptEncoding_ & encoding)
+        {
+            auto encoded = FileCache::Instance()->GetEncoded(
+                entry_, encoding, sendfileThreshold != 0);
+            if (encoded)
+            {
+                entry_ = std::move(encoded);
+                return;
+            }
+        }
+    }
 }
+
 /**
  * @brief 处理错误页面
  * 
+ * @param arena
  */
-void HttpResponse::ErrorHtml_()
+void HttpResponse::ErrorHtml_(Arena &arena)
 {
     /* 如果code_为错误码 */
-    if (CODE_PATH.count(code_) == 1)
+    auto it = CODE_PATH.find(code_);
+    if (it != CODE_PATH.end())
     {
-        path_ = CODE_PATH.find(code_)->second;
-        stat((srcDir_ + path_).data(), &mmFileStat_);
+        path_ = it->second;
+        OpenFile_(arena);
     }
 }
 
 /**
- * @brief 获取文件类型
+ * @brief 按后缀获取文件类型
  * 
- * @return std::string 
+ * @param path
+ * @return const std::string& 
  */
-std::string HttpResponse::GetFileType_()
+const std::string &HttpResponse::FileType(std::string_view path)
 {
+    static const std::string DEFAULT_TYPE = "text/plain";
     /* 判断文件类型 */
-    std::string::size_type idx = path_.find_last_of('.');
-    if (idx == std::string::npos)
+    size_t idx = path.find_last_of('.');
+    /* 后缀不超过短字符串长度， 查找时不分配内存 */
+    if (idx == std::string_view::npos || path.size() - idx > 15)
     {
-        return "text/plain";
+        return DEFAULT_TYPE;
     }
-    std::string suffix = path_.substr(idx);
-    if (SUFFIX_TYPE.count(suffix) == 1)
-    {
-        return SUFFIX_TYPE.find(suffix)->second;
-    }
-    return "text/plain";
+    auto it = SUFFIX_TYPE.find(std::string(path.substr(idx)));
+    return it == SUFFIX_TYPE.end() ? DEFAULT_TYPE : it->second;
+}
+
+/**
+ * @brief 以十进制追加数字
+ *
+ * @param buff
+ * @param num
+ */
+void HttpResponse::AppendNumber_(Buffer &buff, size_t num)
+{
+    char digits[20];
+    auto result = std::to_chars(digits, digits + sizeof(digits), num);
+    buff.Append(digits, result.ptr - digits);
 }
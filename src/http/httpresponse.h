@@ -11,13 +11,19 @@
 #if !defined(HTTP_RESPONSE_H)
 #define HTTP_RESPONSE_H
 
+#include <array>
 #include <unordered_map>
+#include <string_view>
+#include <vector>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
 
+#include "arena.h"
 #include "buffer.h"
+#include "filecache.h"
 #include "log.h"
 
 class HttpResponse
@@ -26,33 +32,84 @@ public:
     HttpResponse();
     ~HttpResponse();
 
-    void Init(const std::string &srcDir,
+    void Init(std::string_view srcDir,
               std::string &path,
               bool isKeepAlive = false,
               int code = -1);
-    void MakeResponse(Buffer &buff);
+    void MakeResponse(Buffer &buff, Arena &arena);
+    void SetKeepAlive(int timeout, int max);
+    void SetAcceptEncoding(std::string_view value);
+    static unsigned AcceptedEncodings(std::string_view value);
+    void SetConditions(std::string_view ifNoneMatch, std::string_view ifModifiedSince);
+    static bool ETagMatches(std::string_view ifNoneMatch, std::string_view etag);
+    static time_t ParseHttpDate(std::string_view date);
+    static void SetCacheControl(std::string_view rules);
     void UnmapFile();
     char *File();
+    /* 用sendfile发送时打开的文件， 否则为-1 */
+    int FileFd() const { return fileFd_; }
     size_t FileLen() const;
     void ErrorContent(Buffer &buff, std::string message);
+    static const std::string &FileType(std::string_view path);
     int Code() const { return code_; }
 
+    /* 以下供路由处理函数修改响应， 需在MakeResponse之前调用 */
+    void SetPath(const std::string &path) { path_ = path; }
+    void SetFile(const std::string &dir, const std::string &path)
+    {
+        srcDir_ = dir;
+        path_ = path;
+    }
+    void SetCode(int code) { code_ = code; }
+    void SetContent(std::string content, const std::string &type);
+
 private:
     void AddStateLine_(Buffer &buff);
     void AddHeader_(Buffer &buff);
     void AddContent_(Buffer &buff);
+    void AddCacheControl_(Buffer &buff);
 
-    void ErrorHtml_();
-    std::string GetFileType_();
+    void ErrorHtml_(Arena &arena);
+    void FilePath_(Arena &arena);
+    void OpenFile_(Arena &arena);
+    void Negotiate_();
+    bool NotModified_(Buffer &buff, Arena &arena);
+    static std::string_view DateHeader_();
+    static void AppendNumber_(Buffer &buff, size_t num);
 
     int code_;
     bool isKeepAlive_;
+    int keepAliveTimeout_; // Keep-Alive首部的timeout(秒)， 0表示不发送
+    int keepAliveMax_;     // Keep-Alive首部的max， 0表示不发送
+    unsigned acceptEncoding_; // 客户端接受的FileCache::Encoding
+    /* 条件请求首部， 指向请求的缓冲区， 只在MakeResponse之前有效 */
+    std::string_view ifNoneMatch_;
+    std::string_view ifModifiedSince_;
 
     std::string path_;
     std::string srcDir_;
+    const char *file_; // srcDir_ + path_， 存放在请求的Arena中
+
+    bool hasContent_;         // 响应内容由处理函数生成， 不读取文件
+    std::string content_;
+    std::string contentType_;
 
+    FileCache::EntryPtr entry_; // 文件缓存的条目， 发送完毕前保持引用
     char *mmFile_;
-    struct stat mmFileStat_;
+    int fileFd_;
+
+public:
+    /* 不小于该大小的文件用sendfile发送， 否则用缓存的内存映射； 小于0时不使用sendfile */
+    static long sendfileThreshold;
+
+private:
+    /* Cache-Control规则： 以'/'开头的按路径前缀匹配， 否则按后缀匹配， 取第一条 */
+    struct CacheRule
+    {
+        std::string match;
+        std::string header; // Cache-Control首部， 含结尾的CRLF
+    };
+    static std::vector<CacheRule> cacheRules_;
 
     static const std::unordered_map<std::string, std::string> SUFFIX_TYPE;
     static const std::unordered_map<int, std::string> CODE_STATUS;
@@ -0,0 +1,518 @@
+/**
+ * @file json.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 单遍JSON解析器实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "json.h"
+
+#include <charconv>
+#include <limits>
+#include <string.h>
+
+#include "bytescan.h"
+#include "httpparser.h"
+
+namespace
+{
+
+/* 字符串中需要停下的字符： 引号、反斜杠与控制字符 */
+constexpr ByteClass STRING_STOP('"', '\\', '\\', true);
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+} // namespace
+
+JsonValue::TYPE JsonValue::Type() const
+{
+    return doc_ ? doc_->nodes_[idx_].type : INVALID;
+}
+
+std::string_view JsonValue::AsString(std::string_view def) const
+{
+    if (Type() != STRING)
+    {
+        return def;
+    }
+    auto &node = doc_->nodes_[idx_];
+    return std::string_view(doc_->text_ + node.off, node.len);
+}
+
+double JsonValue::AsNumber(double def) const
+{
+    if (Type() != NUMBER)
+    {
+        return def;
+    }
+    auto &node = doc_->nodes_[idx_];
+    const char *begin = doc_->text_ + node.off;
+    double value = def;
+    std::from_chars(begin, begin + node.len, value);
+    return value;
+}
+
+int64_t JsonValue::AsInt(int64_t def) const
+{
+    if (Type() != NUMBER)
+    {
+        return def;
+    }
+    auto &node = doc_->nodes_[idx_];
+    const char *begin = doc_->text_ + node.off;
+    int64_t value = 0;
+    auto result = std::from_chars(begin, begin + node.len, value);
+    if (result.ec != std::errc() || result.ptr != begin + node.len)
+    {
+        /* 带小数或指数时按浮点数截断 */
+        return static_cast<int64_t>(AsNumber(static_cast<double>(def)));
+    }
+    return value;
+}
+
+bool JsonValue::AsBool(bool def) const
+{
+    return Type() == BOOLEAN ? doc_->nodes_[idx_].len != 0 : def;
+}
+
+size_t JsonValue::Size() const
+{
+    TYPE type = Type();
+    return (type == ARRAY || type == OBJECT) ? doc_->nodes_[idx_].len : 0;
+}
+
+JsonValue JsonValue::operator[](size_t i) const
+{
+    if (Type() != ARRAY || i >= doc_->nodes_[idx_].len)
+    {
+        return JsonValue();
+    }
+    uint32_t child = idx_ + 1;
+    while (i-- > 0)
+    {
+        child = doc_->nodes_[child].next;
+    }
+    return JsonValue(doc_, child);
+}
+
+/**
+ * @brief 按键查找对象成员， 有重复的键时取第一个
+ *
+ * @param key
+ * @return JsonValue 不存在时为INVALID
+ */
+JsonValue JsonValue::operator[](std::string_view key) const
+{
+    if (Type() != OBJECT)
+    {
+        return JsonValue();
+    }
+    uint32_t child = idx_ + 1;
+    for (uint32_t i = 0; i < doc_->nodes_[idx_].len; i++)
+    {
+        if (JsonValue(doc_, child).AsString() == key)
+        {
+            return JsonValue(doc_, child + 1);
+        }
+        child = doc_->nodes_[child + 1].next;
+    }
+    return JsonValue();
+}
+
+std::string_view JsonValue::Key(size_t i) const
+{
+    if (Type() != OBJECT || i >= doc_->nodes_[idx_].len)
+    {
+        return std::string_view();
+    }
+    uint32_t child = idx_ + 1;
+    while (i-- > 0)
+    {
+        child = doc_->nodes_[child + 1].next;
+    }
+    return JsonValue(doc_, child).AsString();
+}
+
+/**
+ * @brief 解析JSON文本， 字符串原地转义
+ *
+ * @param text 解析后被修改， 须在文档使用期间保持不变
+ * @return true
+ * @return false 格式错误或嵌套过深
+ */
+bool JsonDoc::Parse(std::string &text)
+{
+    Clear();
+    if (text.size() >= std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+    text_ = text.data();
+    pos_ = text_;
+    end_ = text_ + text.size();
+    bool ok = ParseValue_(0);
+    if (ok)
+    {
+        SkipSpace_();
+        ok = pos_ == end_;
+    }
+    if (!ok)
+    {
+        nodes_.clear();
+    }
+    return ok;
+}
+
+/**
+ * @brief 清空文档， 保留节点数组的容量
+ *
+ */
+void JsonDoc::Clear()
+{
+    nodes_.clear();
+    text_ = pos_ = end_ = nullptr;
+}
+
+/**
+ * @brief 是否为application/json， 忽略参数， 不区分大小写
+ *
+ * @param contentType
+ * @return true
+ * @return false
+ */
+bool JsonDoc::IsJson(std::string_view contentType)
+{
+    std::string_view type = contentType.substr(0, contentType.find(';'));
+    while (!type.empty() && (type.back() == ' ' || type.back() == '\t'))
+    {
+        type.remove_suffix(1);
+    }
+    return HttpParser::EqualsIgnoreCase(type, "application/json");
+}
+
+/**
+ * @brief 查找字符串中第一个引号、反斜杠或控制字符
+ *
+ * @param begin
+ * @param end
+ * @return const char* 找不到时返回end
+ */
+const char *JsonDoc::ScanString(const char *begin, const char *end)
+{
+    return STRING_STOP.Find(begin, end);
+}
+
+const char *JsonDoc::ScanStringScalar(const char *begin, const char *end)
+{
+    return STRING_STOP.FindScalar(begin, end);
+}
+
+bool JsonDoc::ParseValue_(size_t depth)
+{
+    SkipSpace_();
+    if (pos_ == end_ || depth > MAX_DEPTH)
+    {
+        return false;
+    }
+    char ch = *pos_;
+    if (ch == '{' || ch == '[')
+    {
+        bool isObject = ch == '{';
+        char close = isObject ? '}' : ']';
+        uint32_t idx = nodes_.size();
+        nodes_.push_back({isObject ? JsonValue::OBJECT : JsonValue::ARRAY,
+                          static_cast<uint32_t>(pos_ - text_),
+                          0,
+                          0});
+        pos_++;
+        SkipSpace_();
+        if (pos_ < end_ && *pos_ == close)
+        {
+            pos_++;
+        }
+        else
+        {
+            while (true)
+            {
+                if (isObject)
+                {
+                    /* 键与值依次作为容器的子节点 */
+                    SkipSpace_();
+                    if (pos_ == end_ || *pos_ != '"' || !ParseString_())
+                    {
+                        return false;
+                    }
+                    SkipSpace_();
+                    if (pos_ == end_ || *pos_ != ':')
+                    {
+                        return false;
+                    }
+                    pos_++;
+                }
+                if (!ParseValue_(depth + 1))
+                {
+                    return false;
+                }
+                nodes_[idx].len++;
+                SkipSpace_();
+                if (pos_ == end_)
+                {
+                    return false;
+                }
+                if (*pos_ == close)
+                {
+                    pos_++;
+                    break;
+                }
+                if (*pos_ != ',')
+                {
+                    return false;
+                }
+                pos_++;
+            }
+        }
+        nodes_[idx].next = nodes_.size();
+        return true;
+    }
+    switch (ch)
+    {
+    case '"':
+        return ParseString_();
+    case 't':
+        return ParseLiteral_("true", 4, JsonValue::BOOLEAN);
+    case 'f':
+        return ParseLiteral_("false", 5, JsonValue::BOOLEAN);
+    case 'n':
+        return ParseLiteral_("null", 4, JsonValue::NUL);
+    default:
+        return ParseNumber_();
+    }
+}
+
+/**
+ * @brief 解析字符串， 没有转义时不移动数据
+ *
+ * 转义后的结果不长于原文， 在原文上从前向后写入。
+ *
+ * @return true
+ * @return false
+ */
+bool JsonDoc::ParseString_()
+{
+    char *begin = ++pos_;
+    char *out = begin;
+    while (true)
+    {
+        char *stop = const_cast<char *>(ScanString(pos_, end_));
+        size_t run = stop - pos_;
+        if (out != pos_)
+        {
+            memmove(out, pos_, run);
+        }
+        out += run;
+        pos_ = stop;
+        if (pos_ == end_ || static_cast<unsigned char>(*pos_) < 0x20)
+        {
+            return false;
+        }
+        if (*pos_ == '"')
+        {
+            pos_++;
+            break;
+        }
+        if (end_ - pos_ < 2)
+        {
+            return false;
+        }
+        char esc = pos_[1];
+        pos_ += 2;
+        switch (esc)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            *out++ = esc;
+            break;
+        case 'b':
+            *out++ = '\b';
+            break;
+        case 'f':
+            *out++ = '\f';
+            break;
+        case 'n':
+            *out++ = '\n';
+            break;
+        case 'r':
+            *out++ = '\r';
+            break;
+        case 't':
+            *out++ = '\t';
+            break;
+        case 'u':
+        {
+            auto hex4 = [this](uint32_t &cp) {
+                if (end_ - pos_ < 4)
+                {
+                    return false;
+                }
+                cp = 0;
+                for (int i = 0; i < 4; i++)
+                {
+                    int d = HexDigit(pos_[i]);
+                    if (d < 0)
+                    {
+                        return false;
+                    }
+                    cp = cp << 4 | d;
+                }
+                pos_ += 4;
+                return true;
+            };
+            uint32_t cp;
+            if (!hex4(cp) || (cp >= 0xdc00 && cp <= 0xdfff))
+            {
+                return false;
+            }
+            if (cp >= 0xd800 && cp <= 0xdbff)
+            {
+                /* UTF-16代理对 */
+                uint32_t low;
+                if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u')
+                {
+                    return false;
+                }
+                pos_ += 2;
+                if (!hex4(low) || low < 0xdc00 || low > 0xdfff)
+                {
+                    return false;
+                }
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+            }
+            if (cp < 0x80)
+            {
+                *out++ = static_cast<char>(cp);
+            }
+            else if (cp < 0x800)
+            {
+                *out++ = static_cast<char>(0xc0 | cp >> 6);
+                *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+            }
+            else if (cp < 0x10000)
+            {
+                *out++ = static_cast<char>(0xe0 | cp >> 12);
+                *out++ = static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+                *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+            }
+            else
+            {
+                *out++ = static_cast<char>(0xf0 | cp >> 18);
+                *out++ = static_cast<char>(0x80 | (cp >> 12 & 0x3f));
+                *out++ = static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+                *out++ = static_cast<char>(0x80 | (cp & 0x3f));
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    uint32_t idx = nodes_.size();
+    nodes_.push_back({JsonValue::STRING,
+                      static_cast<uint32_t>(begin - text_),
+                      static_cast<uint32_t>(out - begin),
+                      idx + 1});
+    return true;
+}
+
+/**
+ * @brief 按JSON语法校验数字， 取值时再转换
+ *
+ * @return true
+ * @return false
+ */
+bool JsonDoc::ParseNumber_()
+{
+    char *begin = pos_;
+    if (*pos_ == '-')
+    {
+        pos_++;
+    }
+    if (pos_ == end_ || !IsDigit(*pos_))
+    {
+        return false;
+    }
+    /* 不允许多余的前导0 */
+    if (*pos_ == '0')
+    {
+        pos_++;
+    }
+    else
+    {
+        while (pos_ < end_ && IsDigit(*pos_))
+        {
+            pos_++;
+        }
+    }
+    if (pos_ < end_ && *pos_ == '.')
+    {
+        pos_++;
+        if (pos_ == end_ || !IsDigit(*pos_))
+        {
+            return false;
+        }
+        while (pos_ < end_ && IsDigit(*pos_))
+        {
+            pos_++;
+        }
+    }
+    if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E'))
+    {
+        pos_++;
+        if (pos_ < end_ && (*pos_ == '+' || *pos_ == '-'))
+        {
+            pos_++;
+        }
+        if (pos_ == end_ || !IsDigit(*pos_))
+        {
+            return false;
+        }
+        while (pos_ < end_ && IsDigit(*pos_))
+        {
+            pos_++;
+        }
+    }
+    uint32_t idx = nodes_.size();
+    nodes_.push_back({JsonValue::NUMBER,
+                      static_cast<uint32_t>(begin - text_),
+                      static_cast<uint32_t>(pos_ - begin),
+                      idx + 1});
+    return true;
+}
+
+bool JsonDoc::ParseLiteral_(const char *word, size_t len, JsonValue::TYPE type)
+{
+    if (static_cast<size_t>(end_ - pos_) < len || memcmp(pos_, word, len) != 0)
+    {
+        return false;
+    }
+    uint32_t idx = nodes_.size();
+    /* 布尔值记录在len中 */
+    nodes_.push_back({type,
+                      static_cast<uint32_t>(pos_ - text_),
+                      static_cast<uint32_t>(word[0] == 't'),
+                      idx + 1});
+    pos_ += len;
+    return true;
+}
+
+void JsonDoc::SkipSpace_()
+{
+    while (pos_ < end_ &&
+           (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t'))
+    {
+        pos_++;
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file json.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 单遍JSON解析器， 结果为指向原文的只读DOM
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(JSON_H)
+#define JSON_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+class JsonDoc;
+
+/**
+ * @brief JSON值的句柄， 只有文档与下标， 可按值传递
+ *
+ * 不存在的值(缺少的键、越界的下标)为INVALID， 在其上继续取值仍为INVALID，
+ * 因此可以直接写 doc.Root()["user"]["name"].AsString()。
+ */
+class JsonValue
+{
+public:
+    enum TYPE : uint8_t
+    {
+        INVALID = 0,
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT,
+    };
+
+    JsonValue() : doc_(nullptr), idx_(0) {}
+    JsonValue(const JsonDoc *doc, uint32_t idx) : doc_(doc), idx_(idx) {}
+
+    TYPE Type() const;
+    bool IsValid() const { return Type() != INVALID; }
+    bool IsNull() const { return Type() == NUL; }
+    bool IsString() const { return Type() == STRING; }
+    bool IsNumber() const { return Type() == NUMBER; }
+
+    std::string_view AsString(std::string_view def = std::string_view()) const;
+    double AsNumber(double def = 0) const;
+    int64_t AsInt(int64_t def = 0) const;
+    bool AsBool(bool def = false) const;
+
+    /* 数组元素个数或对象成员个数 */
+    size_t Size() const;
+    JsonValue operator[](size_t i) const;
+    /* 避免字面量0与const char *重载产生歧义 */
+    JsonValue operator[](int i) const
+    {
+        return i < 0 ? JsonValue() : (*this)[static_cast<size_t>(i)];
+    }
+    JsonValue operator[](std::string_view key) const;
+    JsonValue operator[](const char *key) const { return (*this)[std::string_view(key)]; }
+    /* 对象的第i个成员的键 */
+    std::string_view Key(size_t i) const;
+
+private:
+    const JsonDoc *doc_;
+    uint32_t idx_;
+};
+
+/**
+ * @brief 解析后的JSON文档
+ *
+ * 节点按先序排列在连续的数组中， 容器节点记录子树结束的位置， 跳过兄弟节点
+ * 为O(1)。 字符串在原文中原地转义， 结果直接指向原文， 因此原文须在文档
+ * 使用期间保持不变。 节点数组在多次解析间复用。
+ */
+class JsonDoc
+{
+public:
+    static const size_t MAX_DEPTH = 64;
+
+    JsonDoc() { Clear(); }
+
+    bool Parse(std::string &text);
+    void Clear();
+
+    bool Empty() const { return nodes_.empty(); }
+    JsonValue Root() const { return Empty() ? JsonValue() : JsonValue(this, 0); }
+
+    static bool IsJson(std::string_view contentType);
+    static const char *ScanString(const char *begin, const char *end);
+    static const char *ScanStringScalar(const char *begin, const char *end);
+
+private:
+    friend class JsonValue;
+
+    struct Node
+    {
+        JsonValue::TYPE type;
+        uint32_t off;  // 标量在原文中的位置
+        uint32_t len;  // 标量的长度， 或容器的元素个数
+        uint32_t next; // 子树之后的第一个节点
+    };
+
+    bool ParseValue_(size_t depth);
+    bool ParseString_();
+    bool ParseNumber_();
+    bool ParseLiteral_(const char *word, size_t len, JsonValue::TYPE type);
+    void SkipSpace_();
+
+    std::vector<Node> nodes_;
+    char *text_;
+    char *pos_;
+    char *end_;
+};
+
+#endif // JSON_H
@@ -0,0 +1,538 @@
+/**
+ * @file multipart.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 流式multipart/form-data解析器实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "multipart.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "httpparser.h"
+
+namespace
+{
+
+std::string_view Trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+bool WriteAll(int fd, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+} // namespace
+
+MultipartParser::MultipartParser()
+    : state_(IDLE), error_(false), tooLarge_(false), maxUpload_(0), uploaded_(0),
+      fieldBytes_(0), fd_(-1)
+{
+}
+
+MultipartParser::~MultipartParser() { Reset(); }
+
+/**
+ * @brief 从Content-Type中取出boundary， 开始解析新的内容实体
+ *
+ * @param contentType
+ * @param tmpDir 临时文件目录
+ * @param maxUpload 全部文件合计的字节数上限
+ * @return true
+ * @return false 不是multipart/form-data或boundary非法
+ */
+bool MultipartParser::Init(std::string_view contentType,
+                           const std::string &tmpDir,
+                           size_t maxUpload)
+{
+    Reset();
+    std::string_view boundary = HeaderParam(contentType, "boundary");
+    if (!IsMultipart(contentType) || boundary.empty() ||
+        boundary.size() > MAX_BOUNDARY)
+    {
+        return false;
+    }
+    tmpDir_ = tmpDir;
+    maxUpload_ = maxUpload;
+    delim_ = "\r\n--";
+    delim_.append(boundary);
+    static_assert(MAX_BOUNDARY + 4 <= UINT8_MAX, "skip_ holds the delimiter length");
+    size_t m = delim_.size();
+    for (uint8_t &skip : skip_)
+    {
+        skip = m;
+    }
+    for (size_t i = 0; i + 1 < m; i++)
+    {
+        skip_[static_cast<unsigned char>(delim_[i])] = m - 1 - i;
+    }
+    /* 第一个分隔符前没有CRLF， 补上后与其余分隔符一样处理 */
+    pending_ = "\r\n";
+    state_ = PREAMBLE;
+    return true;
+}
+
+/**
+ * @brief 解析一段内容实体
+ *
+ * 只有不足一个分隔符长度的尾部会被拷贝保留， 其余数据直接在data上处理。
+ *
+ * @param data
+ * @param len
+ * @return true
+ * @return false 格式错误、超出上限或写入临时文件失败
+ */
+bool MultipartParser::Feed(const char *data, size_t len)
+{
+    if (error_ || state_ == IDLE)
+    {
+        return false;
+    }
+    if (!pending_.empty())
+    {
+        /* 保留的尾部与新数据的开头拼接后处理， 尾部不超过delim_.size() + 2 */
+        size_t kept = pending_.size();
+        size_t take = std::min(len, delim_.size() + 2);
+        pending_.append(data, take);
+        size_t used = Consume_(pending_.data(), pending_.size());
+        if (error_)
+        {
+            return false;
+        }
+        if (used < kept)
+        {
+            pending_.erase(0, used);
+            pending_.append(data + take, len - take);
+            return true;
+        }
+        data += used - kept;
+        len -= used - kept;
+        pending_.clear();
+    }
+    size_t used = Consume_(data, len);
+    if (error_)
+    {
+        return false;
+    }
+    pending_.assign(data + used, len - used);
+    return true;
+}
+
+/**
+ * @brief 内容实体结束
+ *
+ * @return true 已收到结束分隔符
+ * @return false
+ */
+bool MultipartParser::Finish() { return !error_ && state_ == END; }
+
+/**
+ * @brief 关闭并删除临时文件， 回到未初始化状态
+ *
+ */
+void MultipartParser::Reset()
+{
+    if (fd_ >= 0)
+    {
+        close(fd_);
+        fd_ = -1;
+    }
+    for (auto &file : files_)
+    {
+        unlink(file.path.c_str());
+    }
+    files_.clear();
+    fields_.clear();
+    pending_.clear();
+    header_.clear();
+    disposition_.clear();
+    partType_.clear();
+    spill_.clear();
+    state_ = IDLE;
+    error_ = false;
+    tooLarge_ = false;
+    uploaded_ = 0;
+    fieldBytes_ = 0;
+}
+
+/**
+ * @brief 是否为multipart/form-data， 不区分大小写
+ *
+ * @param contentType
+ * @return true
+ * @return false
+ */
+bool MultipartParser::IsMultipart(std::string_view contentType)
+{
+    return HttpParser::EqualsIgnoreCase(
+        Trim(contentType.substr(0, contentType.find(';'))), "multipart/form-data");
+}
+
+/**
+ * @brief 取首部字段值中;分隔的参数， 如 form-data; name="a"; filename="b"
+ *
+ * @param value 首部字段值
+ * @param key 参数名， 不区分大小写
+ * @return std::string_view 去掉引号的参数值； 参数不存在时data()为nullptr
+ */
+std::string_view MultipartParser::HeaderParam(std::string_view value,
+                                              std::string_view key)
+{
+    size_t pos = value.find(';');
+    while (pos != std::string_view::npos)
+    {
+        size_t eq = value.find('=', pos + 1);
+        if (eq == std::string_view::npos)
+        {
+            break;
+        }
+        std::string_view name = Trim(value.substr(pos + 1, eq - pos - 1));
+        std::string_view param;
+        size_t begin = eq + 1;
+        while (begin < value.size() && value[begin] == ' ')
+        {
+            begin++;
+        }
+        if (begin < value.size() && value[begin] == '"')
+        {
+            size_t quote = value.find('"', begin + 1);
+            if (quote == std::string_view::npos)
+            {
+                break;
+            }
+            param = value.substr(begin + 1, quote - begin - 1);
+            pos = value.find(';', quote);
+        }
+        else
+        {
+            pos = value.find(';', begin);
+            param = Trim(value.substr(begin, pos - begin));
+        }
+        if (HttpParser::EqualsIgnoreCase(name, key))
+        {
+            return param;
+        }
+    }
+    return std::string_view();
+}
+
+/**
+ * @brief 处理一段连续的数据
+ *
+ * @param data
+ * @param len
+ * @return size_t 处理的字节数， 剩余部分不足以判断， 需等待更多数据
+ */
+size_t MultipartParser::Consume_(const char *data, size_t len)
+{
+    size_t pos = 0;
+    while (pos < len && !error_)
+    {
+        switch (state_)
+        {
+        case PREAMBLE:
+        case DATA:
+        {
+            size_t n = ConsumeData_(data + pos, len - pos);
+            if (n == 0)
+            {
+                return pos;
+            }
+            pos += n;
+            break;
+        }
+        case AFTER_BOUNDARY:
+            if (len - pos < 2)
+            {
+                return pos;
+            }
+            if (data[pos] == '-' && data[pos + 1] == '-')
+            {
+                state_ = END;
+            }
+            else if (data[pos] == '\r' && data[pos + 1] == '\n')
+            {
+                state_ = HEADERS;
+            }
+            else
+            {
+                error_ = true;
+            }
+            pos += 2;
+            break;
+        case HEADERS:
+        {
+            const char *begin = data + pos;
+            const char *end = data + len;
+            const char *eol = HttpParser::FindEol(begin, end);
+            size_t lineLen = eol - begin;
+            if (header_.size() + lineLen > MAX_PART_HEADER)
+            {
+                error_ = true;
+                break;
+            }
+            header_.append(begin, lineLen);
+            if (eol == end)
+            {
+                return len;
+            }
+            if (eol + 1 == end)
+            {
+                /* 等待CR之后的LF */
+                return eol - data;
+            }
+            if (eol[0] != '\r' || eol[1] != '\n')
+            {
+                error_ = true;
+                break;
+            }
+            error_ = !HeaderLine_(header_);
+            header_.clear();
+            pos = eol + 2 - data;
+            break;
+        }
+        case END:
+            /* 忽略结束分隔符之后的内容 */
+            return len;
+        case IDLE:
+            error_ = true;
+            break;
+        }
+    }
+    return pos;
+}
+
+/**
+ * @brief 在部分的内容中查找分隔符， 之前的数据交给当前部分
+ *
+ * @param data
+ * @param len
+ * @return size_t 处理的字节数， 为0时需要更多数据
+ */
+size_t MultipartParser::ConsumeData_(const char *data, size_t len)
+{
+    size_t found = Find_(data, len);
+    if (found != std::string::npos)
+    {
+        if (state_ == DATA && (!OnData_(data, found) || !EndPart_()))
+        {
+            error_ = true;
+            return 0;
+        }
+        state_ = AFTER_BOUNDARY;
+        return found + delim_.size();
+    }
+    /* 末尾可能是下一段中分隔符的开头， 留待下次处理 */
+    size_t m = delim_.size();
+    size_t safe = len >= m ? len - (m - 1) : 0;
+    while (safe < len &&
+           !(data[safe] == '\r' && memcmp(data + safe, delim_.data(), len - safe) == 0))
+    {
+        safe++;
+    }
+    if (safe > 0 && state_ == DATA && !OnData_(data, safe))
+    {
+        error_ = true;
+        return 0;
+    }
+    return safe;
+}
+
+/**
+ * @brief 处理部分的一行首部， 空行表示首部结束
+ *
+ * @param line 不含CRLF
+ * @return true
+ * @return false
+ */
+bool MultipartParser::HeaderLine_(std::string_view line)
+{
+    if (line.empty())
+    {
+        state_ = DATA;
+        return BeginPart_();
+    }
+    size_t colon = line.find(':');
+    if (colon == std::string_view::npos)
+    {
+        return false;
+    }
+    std::string_view name = Trim(line.substr(0, colon));
+    std::string_view value = Trim(line.substr(colon + 1));
+    if (HttpParser::EqualsIgnoreCase(name, "Content-Disposition"))
+    {
+        disposition_.assign(value);
+    }
+    else if (HttpParser::EqualsIgnoreCase(name, "Content-Type"))
+    {
+        partType_.assign(value);
+    }
+    return true;
+}
+
+/**
+ * @brief 首部结束， 有filename时创建临时文件， 否则作为表单字段
+ *
+ * @return true
+ * @return false 缺少name、部分过多或无法创建临时文件
+ */
+bool MultipartParser::BeginPart_()
+{
+    std::string_view name = HeaderParam(disposition_, "name");
+    std::string_view filename = HeaderParam(disposition_, "filename");
+    if (name.data() == nullptr)
+    {
+        return false;
+    }
+    if (files_.size() + fields_.size() >= MAX_PARTS)
+    {
+        tooLarge_ = true;
+        return false;
+    }
+    isFile_ = filename.data() != nullptr;
+    if (isFile_)
+    {
+        File file;
+        file.name.assign(name);
+        file.filename.assign(filename);
+        file.contentType = partType_;
+        file.path = tmpDir_ + "/upload-XXXXXX";
+        fd_ = mkostemp(&file.path[0], O_CLOEXEC);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        files_.push_back(std::move(file));
+        spill_.reserve(SPILL_SIZE);
+    }
+    else
+    {
+        fields_.emplace_back(std::string(name), std::string());
+    }
+    disposition_.clear();
+    partType_.clear();
+    return true;
+}
+
+/**
+ * @brief 当前部分的一段内容
+ *
+ * @param data 指向读缓冲区
+ * @param len
+ * @return true
+ * @return false
+ */
+bool MultipartParser::OnData_(const char *data, size_t len)
+{
+    if (!isFile_)
+    {
+        std::string &value = fields_.back().second;
+        if (value.size() + len > MAX_FIELD || fieldBytes_ + len > MAX_FIELDS)
+        {
+            tooLarge_ = true;
+            return false;
+        }
+        value.append(data, len);
+        fieldBytes_ += len;
+        return true;
+    }
+    if (len > maxUpload_ - uploaded_)
+    {
+        tooLarge_ = true;
+        return false;
+    }
+    uploaded_ += len;
+    files_.back().size += len;
+    if (spill_.size() + len < SPILL_SIZE)
+    {
+        spill_.append(data, len);
+        return true;
+    }
+    if (!Flush_())
+    {
+        return false;
+    }
+    if (len >= SPILL_SIZE)
+    {
+        /* 大片段不经拷贝直接写入 */
+        return WriteAll(fd_, data, len);
+    }
+    spill_.append(data, len);
+    return true;
+}
+
+bool MultipartParser::EndPart_()
+{
+    if (!isFile_)
+    {
+        return true;
+    }
+    bool ok = Flush_();
+    close(fd_);
+    fd_ = -1;
+    return ok;
+}
+
+bool MultipartParser::Flush_()
+{
+    bool ok = WriteAll(fd_, spill_.data(), spill_.size());
+    spill_.clear();
+    return ok;
+}
+
+/**
+ * @brief Boyer-Moore-Horspool查找分隔符
+ *
+ * @param data
+ * @param len
+ * @return size_t 找不到时为npos
+ */
+size_t MultipartParser::Find_(const char *data, size_t len) const
+{
+    size_t m = delim_.size();
+    const char *d = delim_.data();
+    size_t i = 0;
+    while (i + m <= len)
+    {
+        unsigned char last = data[i + m - 1];
+        if (last == static_cast<unsigned char>(d[m - 1]) &&
+            memcmp(data + i, d, m - 1) == 0)
+        {
+            return i;
+        }
+        i += skip_[last];
+    }
+    return std::string::npos;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file multipart.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 流式multipart/form-data解析器， 文件直接写入临时文件
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(MULTIPART_H)
+#define MULTIPART_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 内容实体分段到达时逐段解析
+ *
+ * 分隔符用Boyer-Moore-Horspool查找， 跨段的分隔符只保留不足一个分隔符长度的
+ * 尾部。 带filename的部分写入临时文件： 小片段先攒到SPILL_SIZE再写，
+ * 大片段直接从读缓冲区写入， 内存占用与上传大小无关。 其余部分作为表单字段。
+ * 文件总大小、部分数与表单字段总大小都有上限， 超出时TooLarge为true。
+ * 临时文件在Reset或析构时删除， 需要保留时由调用方rename。
+ */
+class MultipartParser
+{
+public:
+    struct File
+    {
+        std::string name;        // 表单字段名
+        std::string filename;    // 客户端提供的文件名
+        std::string contentType;
+        std::string path;        // 临时文件路径
+        size_t size = 0;
+    };
+
+    static const size_t MAX_BOUNDARY = 70;       // RFC 2046
+    static const size_t MAX_PART_HEADER = 8192;  // 单个部分的首部上限
+    static const size_t MAX_FIELD = 64 * 1024;   // 单个表单字段上限
+    static const size_t MAX_FIELDS = 256 * 1024; // 全部表单字段合计上限
+    static const size_t MAX_PARTS = 64;          // 部分数上限
+    static const size_t SPILL_SIZE = 64 * 1024;  // 写入临时文件的块大小
+
+    MultipartParser();
+    ~MultipartParser();
+    MultipartParser(const MultipartParser &) = delete;
+    MultipartParser &operator=(const MultipartParser &) = delete;
+
+    bool Init(std::string_view contentType,
+              const std::string &tmpDir,
+              size_t maxUpload = SIZE_MAX);
+    bool Feed(const char *data, size_t len);
+    bool Finish();
+    void Reset();
+
+    bool Active() const { return state_ != IDLE; }
+    bool TooLarge() const { return tooLarge_; }
+    const std::vector<File> &Files() const { return files_; }
+    const std::vector<std::pair<std::string, std::string>> &Fields() const
+    {
+        return fields_;
+    }
+
+    static bool IsMultipart(std::string_view contentType);
+    static std::string_view HeaderParam(std::string_view value,
+                                        std::string_view key);
+
+private:
+    enum STATE
+    {
+        IDLE,           // 未初始化
+        PREAMBLE,       // 第一个分隔符之前
+        AFTER_BOUNDARY, // 分隔符之后的CRLF或结束标记--
+        HEADERS,        // 部分的首部
+        DATA,           // 部分的内容
+        END,            // 结束分隔符之后
+    };
+
+    size_t Consume_(const char *data, size_t len);
+    size_t ConsumeData_(const char *data, size_t len);
+    bool HeaderLine_(std::string_view line);
+    bool BeginPart_();
+    bool OnData_(const char *data, size_t len);
+    bool EndPart_();
+    bool Flush_();
+    size_t Find_(const char *data, size_t len) const;
+
+    STATE state_;
+    bool error_;
+    bool tooLarge_;
+    std::string tmpDir_;
+    size_t maxUpload_;  // 全部文件合计上限
+    size_t uploaded_;   // 已写入临时文件的字节数
+    size_t fieldBytes_; // 全部表单字段的字节数
+    std::string delim_; // CRLF + "--" + boundary
+    uint8_t skip_[256]; // Horspool坏字符表， 分隔符不超过MAX_BOUNDARY + 4字节
+    std::string pending_; // 上一段末尾可能属于分隔符的数据
+    std::string header_;  // 当前部分未完成的首部行
+    std::string disposition_, partType_;
+    bool isFile_;
+    int fd_;
+    std::string spill_;
+    std::vector<File> files_;
+    std::vector<std::pair<std::string, std::string>> fields_;
+};
+
+#endif // MULTIPART_H
@@ -0,0 +1,236 @@
+/**
+ * @file router.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 基于压缩前缀树(radix tree)的路由表实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "router.h"
+
+/**
+ * @brief 前缀树节点
+ *
+ * 静态子节点的前缀首字符互不相同， 记录在indices中， 查找时按首字符定位。
+ * 参数与通配符子节点各至多一个， 其后的静态部分挂在参数节点之下。
+ */
+struct Router::Node
+{
+    std::string prefix;  // 静态节点： 压缩后的路径片段
+    std::string name;    // 参数/通配符节点： 参数名
+    std::string indices; // 各静态子节点前缀的首字符
+    std::vector<std::unique_ptr<Node>> children;
+    std::unique_ptr<Node> param;    // :name
+    std::unique_ptr<Node> wildcard; // *name
+    std::vector<std::pair<std::string, std::unique_ptr<Route>>> routes;
+};
+
+Router::Router() : root_(std::make_unique<Node>()) {}
+
+Router::~Router() = default;
+
+Router::Router(Router &&) = default;
+
+Router &Router::operator=(Router &&) = default;
+
+/**
+ * @brief 注册路由， 已存在时返回原有的路由
+ *
+ * @param method 请求方法
+ * @param pattern 以/开头的路径模式
+ * @return Route& 在Router销毁前地址不变
+ */
+Router::Route &Router::Add(std::string_view method, std::string_view pattern)
+{
+    assert(!pattern.empty() && pattern[0] == '/');
+    Node *node = root_.get();
+    size_t i = 0;
+    while (i < pattern.size())
+    {
+        size_t j = pattern.find_first_of(":*", i);
+        if (j == std::string_view::npos)
+        {
+            j = pattern.size();
+        }
+        if (j > i)
+        {
+            node = InsertStatic_(node, pattern.substr(i, j - i));
+        }
+        if (j == pattern.size())
+        {
+            break;
+        }
+        /* 参数占据完整的路径段 */
+        assert(pattern[j - 1] == '/');
+        size_t k = pattern.find('/', j);
+        if (k == std::string_view::npos)
+        {
+            k = pattern.size();
+        }
+        std::string_view name = pattern.substr(j + 1, k - j - 1);
+        assert(!name.empty());
+        std::unique_ptr<Node> &child =
+            pattern[j] == ':' ? node->param : node->wildcard;
+        if (!child)
+        {
+            child = std::make_unique<Node>();
+            child->name = name;
+        }
+        /* 同一位置的参数名必须一致， 通配符只能在末尾 */
+        assert(child->name == name);
+        assert(pattern[j] == ':' || k == pattern.size());
+        node = child.get();
+        i = k;
+    }
+    for (auto &route : node->routes)
+    {
+        if (route.first == method)
+        {
+            return *route.second;
+        }
+    }
+    node->routes.emplace_back(std::string(method), std::make_unique<Route>());
+    return *node->routes.back().second;
+}
+
+/**
+ * @brief 查找路由， 时间与路径长度成正比， 不分配内存
+ *
+ * @param method 请求方法
+ * @param path 请求路径(不含查询字符串)
+ * @param match 查找结果， 参数值指向path
+ * @return true
+ * @return false 没有匹配的路由
+ */
+bool Router::Find(std::string_view method,
+                  std::string_view path,
+                  Match &match) const
+{
+    match.route = nullptr;
+    match.paramCount = 0;
+    return Find_(root_.get(), path, method, match);
+}
+
+/**
+ * @brief 插入静态路径片段， 与已有前缀部分重合时拆分节点
+ *
+ * @param node
+ * @param prefix
+ * @return Node* 片段结束处的节点
+ */
+Router::Node *Router::InsertStatic_(Node *node, std::string_view prefix)
+{
+    while (!prefix.empty())
+    {
+        size_t idx = node->indices.find(prefix[0]);
+        if (idx == std::string::npos)
+        {
+            auto child = std::make_unique<Node>();
+            child->prefix = prefix;
+            node->indices.push_back(prefix[0]);
+            node->children.push_back(std::move(child));
+            return node->children.back().get();
+        }
+        std::unique_ptr<Node> &child = node->children[idx];
+        size_t common = 0;
+        while (common < prefix.size() && common < child->prefix.size() &&
+               prefix[common] == child->prefix[common])
+        {
+            common++;
+        }
+        if (common < child->prefix.size())
+        {
+            /* 拆分为公共部分与剩余部分 */
+            auto mid = std::make_unique<Node>();
+            mid->prefix = child->prefix.substr(0, common);
+            child->prefix.erase(0, common);
+            mid->indices.push_back(child->prefix[0]);
+            mid->children.push_back(std::move(child));
+            child = std::move(mid);
+        }
+        node = child.get();
+        prefix.remove_prefix(common);
+    }
+    return node;
+}
+
+const Router::Route *Router::FindMethod_(const Node *node,
+                                         std::string_view method)
+{
+    for (auto &route : node->routes)
+    {
+        if (route.first == method)
+        {
+            return route.second.get();
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 从node开始匹配剩余路径， 依次尝试静态、参数与通配符子节点
+ *
+ * @param node 已匹配到的节点
+ * @param path 剩余路径
+ * @param method
+ * @param match
+ * @return true
+ * @return false
+ */
+bool Router::Find_(const Node *node,
+                   std::string_view path,
+                   std::string_view method,
+                   Match &match)
+{
+    if (path.empty())
+    {
+        match.route = FindMethod_(node, method);
+        if (match.route)
+        {
+            return true;
+        }
+    }
+    else
+    {
+        size_t idx = node->indices.find(path[0]);
+        if (idx != std::string::npos)
+        {
+            const Node *child = node->children[idx].get();
+            if (path.substr(0, child->prefix.size()) == child->prefix &&
+                Find_(child, path.substr(child->prefix.size()), method, match))
+            {
+                return true;
+            }
+        }
+        if (node->param && match.paramCount < MAX_PARAMS)
+        {
+            size_t end = path.find('/');
+            if (end == std::string_view::npos)
+            {
+                end = path.size();
+            }
+            if (end > 0)
+            {
+                match.params[match.paramCount++] = {node->param->name,
+                                                    path.substr(0, end)};
+                if (Find_(node->param.get(), path.substr(end), method, match))
+                {
+                    return true;
+                }
+                match.paramCount--;
+            }
+        }
+    }
+    if (node->wildcard && match.paramCount < MAX_PARAMS)
+    {
+        match.route = FindMethod_(node->wildcard.get(), method);
+        if (match.route)
+        {
+            match.params[match.paramCount++] = {node->wildcard->name, path};
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file router.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 基于压缩前缀树(radix tree)的路由表
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(ROUTER_H)
+#define ROUTER_H
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <assert.h>
+
+class HttpRequest;
+class HttpResponse;
+
+/**
+ * @brief 按"方法 + 路径模式"注册处理函数
+ *
+ * 路径模式由静态部分与参数组成：
+ *   /user/:id       :id匹配一个路径段
+ *   /static/{*file} 即/static/后接*file， *file匹配剩余的全部路径， 只能出现在末尾
+ * 同一位置静态部分优先于参数， 参数优先于通配符。
+ * 路由须在服务器启动前注册， 之后只读， 可被多个线程同时查找。
+ */
+class Router
+{
+public:
+    /* 请求完整后调用， 通过response指定响应的文件或内容 */
+    typedef std::function<void(HttpRequest &request, HttpResponse &response)>
+        Handler;
+    /* 内容实体处理函数， 见HttpRequest::BodyHandler */
+    typedef std::function<bool(HttpRequest &request,
+                               std::string_view data,
+                               bool last)>
+        BodyHandler;
+
+    struct Route
+    {
+        Handler handler;
+        BodyHandler bodyHandler;
+        bool upload = false; // 接受multipart/form-data文件上传
+    };
+
+    struct Param
+    {
+        std::string_view name;
+        std::string_view value; // 指向被查找的路径
+    };
+
+    static const size_t MAX_PARAMS = 8;
+
+    /* 查找结果， 不分配内存 */
+    struct Match
+    {
+        const Route *route = nullptr;
+        std::array<Param, MAX_PARAMS> params;
+        size_t paramCount = 0;
+
+        std::string_view Get(std::string_view name) const
+        {
+            for (size_t i = 0; i < paramCount; i++)
+            {
+                if (params[i].name == name)
+                {
+                    return params[i].value;
+                }
+            }
+            return std::string_view();
+        }
+    };
+
+    Router();
+    ~Router();
+    Router(Router &&);
+    Router &operator=(Router &&);
+
+    Route &Add(std::string_view method, std::string_view pattern);
+    void Add(std::string_view method, std::string_view pattern, Handler handler)
+    {
+        Add(method, pattern).handler = std::move(handler);
+    }
+    bool Find(std::string_view method, std::string_view path, Match &match) const;
+
+private:
+    struct Node;
+
+    static Node *InsertStatic_(Node *node, std::string_view prefix);
+    static const Route *FindMethod_(const Node *node, std::string_view method);
+    static bool Find_(const Node *node,
+                      std::string_view path,
+                      std::string_view method,
+                      Match &match);
+
+    std::unique_ptr<Node> root_;
+};
+
+#endif // ROUTER_H
@@ -155,6 +155,7 @@ void Log::write(LogLevel level, const char *format, ...)
     {
         std::unique_lock<std::mutex> locker(mtx_);
         lineCount_++;
+        buff_.EnsureWriteable(128);
         int n = snprintf(buff_.BeginWrite(),
                          128,
                          "%d-%02d-%02d %02d:%02d:%02d.%06ld ",
@@ -14,6 +14,10 @@
 Epoller::Epoller(int maxEvent)
 : epollFd_(epoll_create(512))
 , events_(maxEvent)
+, fds_(MAX_FD)
+, loopThread_(std::thread::id())
+, ctlIssued_(0)
+, ctlAvoided_(0)
 {
     assert(epollFd_ >= 0 && events_.size() > 0);
 }
@@ -30,12 +34,15 @@ Epoller::~Epoller() { close(epollFd_); }
  */
 bool Epoller::AddFd(int fd, uint32_t events)
 {
-    if (fd < 0)
+    if (fd < 0 || fd >= MAX_FD)
         return false;
-    struct epoll_event ev = {0};
-    ev.data.fd = fd;
-    ev.events = events;
-    return 0 == epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    if (!Ctl_(EPOLL_CTL_ADD, fd, events))
+        return false;
+    FdState &st = fds_[fd];
+    st.kernel = events;
+    st.want = events;
+    st.registered = true;
+    return true;
 }
 
 /**
@@ -48,12 +55,36 @@ bool Epoller::AddFd(int fd, uint32_t events)
  */
 bool Epoller::ModFd(int fd, uint32_t events)
 {
-    if (fd < 0)
+    if (fd < 0 || fd >= MAX_FD || !fds_[fd].registered)
         return false;
-    struct epoll_event ev = {0};
-    ev.data.fd = fd;
-    ev.events = events;
-    return 0 == epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+    FdState &st = fds_[fd];
+    st.want = events;
+    if (!st.queued && st.kernel == events)
+    {
+        /* 掩码未变化 */
+        ctlAvoided_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    if (std::this_thread::get_id() != loopThread_.load(std::memory_order_relaxed))
+    {
+        /* 先记录掩码再提交， 否则事件可能在记录前就已触发并被Wait清零 */
+        st.kernel = events;
+        if (!Ctl_(EPOLL_CTL_MOD, fd, events))
+        {
+            st.kernel = 0;
+            return false;
+        }
+        return true;
+    }
+    if (st.queued)
+    {
+        /* 与本轮已排队的修改合并 */
+        ctlAvoided_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    st.queued = true;
+    pending_.push_back(fd);
+    return true;
 }
 
 /**
@@ -65,10 +96,13 @@ bool Epoller::ModFd(int fd, uint32_t events)
  */
 bool Epoller::DelFd(int fd)
 {
-    if (fd < 0)
+    if (fd < 0 || fd >= MAX_FD)
         return false;
-    struct epoll_event ev = {0};
-    return 0 == epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, &ev);
+    FdState &st = fds_[fd];
+    st.registered = false;
+    st.kernel = 0;
+    st.want = 0;
+    return Ctl_(EPOLL_CTL_DEL, fd, 0);
 }
 
 /**
@@ -79,8 +113,25 @@ bool Epoller::DelFd(int fd)
  */
 int Epoller::Wait(int timeoutMs)
 {
-    return epoll_wait(
+    /* 线程池模式下工作线程在ModFd中读取， 只在首次或换线程时写入 */
+    std::thread::id self = std::this_thread::get_id();
+    if (loopThread_.load(std::memory_order_relaxed) != self)
+    {
+        loopThread_.store(self, std::memory_order_relaxed);
+    }
+    FlushPending_();
+    int n = epoll_wait(
         epollFd_, &events_[0], static_cast<int>(events_.size()), timeoutMs);
+    for (int i = 0; i < n; i++)
+    {
+        /* EPOLLONESHOT触发后内核已禁用该fd， 下一次ModFd必须真正提交 */
+        FdState &st = fds_[events_[i].data.fd];
+        if (st.kernel & EPOLLONESHOT)
+        {
+            st.kernel = 0;
+        }
+    }
+    return n;
 }
 
 /**
@@ -91,7 +142,7 @@ int Epoller::Wait(int timeoutMs)
  */
 int Epoller::GetEventFd(size_t i) const
 {
-    assert(i < events_.size() && i >= 0);
+    assert(i < events_.size());
     return events_[i].data.fd;
 }
 
@@ -103,6 +154,56 @@ int Epoller::GetEventFd(size_t i) const
  */
 uint32_t Epoller::GetEvents(size_t i) const
 {
-    assert(i < events_.size() && i >= 0);
+    assert(i < events_.size());
     return events_[i].events;
 }
+
+/**
+ * @brief 调用epoll_ctl并计数
+ * 
+ * @param op 
+ * @param fd 
+ * @param events 
+ * @return true 
+ * @return false 
+ */
+bool Epoller::Ctl_(int op, int fd, uint32_t events)
+{
+    struct epoll_event ev = {};
+    ev.data.fd = fd;
+    ev.events = events;
+    ctlIssued_.fetch_add(1, std::memory_order_relaxed);
+    return 0 == epoll_ctl(epollFd_, op, fd, &ev);
+}
+
+/**
+ * @brief 提交本轮排队的修改
+ * 
+ */
+void Epoller::FlushPending_()
+{
+    for (int fd : pending_)
+    {
+        FdState &st = fds_[fd];
+        if (!st.queued)
+        {
+            continue;
+        }
+        st.queued = false;
+        if (!st.registered)
+        {
+            continue;
+        }
+        if (st.want == st.kernel)
+        {
+            /* 排队期间又改回了原掩码 */
+            ctlAvoided_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (Ctl_(EPOLL_CTL_MOD, fd, st.want))
+        {
+            st.kernel = st.want;
+        }
+    }
+    pending_.clear();
+}
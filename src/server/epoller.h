@@ -17,24 +17,58 @@
 #include <unistd.h>
 #include <assert.h>
 #include <vector>
+#include <atomic>
+#include <thread>
 #include <errno.h>
 
-class Epoller
+#include "poller.h"
+
+/**
+ * @brief 基于epoll的事件引擎
+ *
+ * 记录每个fd当前注册到内核的事件掩码， 掩码未变化的ModFd直接跳过；
+ * 事件循环线程内的修改先排队， 在下一次Wait开始时统一提交。
+ * 其他线程(线程池模式)的修改立即提交， 避免Reactor阻塞在Wait中。
+ */
+class Epoller : public Poller
 {
 public:
     explicit Epoller(int maxEvent = 1024);
-    ~Epoller();
+    ~Epoller() override;
+
+    bool AddFd(int fd, uint32_t events) override;
+    bool ModFd(int fd, uint32_t events) override;
+    bool DelFd(int fd) override;
+    int Wait(int timeoutMs = -1) override;
+    int GetEventFd(size_t i) const override;
+    uint32_t GetEvents(size_t i) const override;
 
-    bool AddFd(int fd, uint32_t events);
-    bool ModFd(int fd, uint32_t events);
-    bool DelFd(int fd);
-    int Wait(int timeoutMs = -1);
-    int GetEventFd(size_t i) const;
-    uint32_t GetEvents(size_t i) const;
+    uint64_t CtlIssued() const { return ctlIssued_; }
+    uint64_t CtlAvoided() const { return ctlAvoided_; }
 
 private:
+    struct FdState
+    {
+        /* 内核中生效的事件掩码， EPOLLONESHOT触发后为0
+         * 工作线程提交与Reactor线程清零可能交错， 因此使用原子变量 */
+        std::atomic<uint32_t> kernel{0};
+        uint32_t want = 0; // 期望的事件掩码
+        bool registered = false;
+        bool queued = false; // 是否已在pending_中
+    };
+
+    bool Ctl_(int op, int fd, uint32_t events);
+    void FlushPending_();
+
+    static const int MAX_FD = 65536;
+
     int epollFd_;
     std::vector<struct epoll_event> events_;
+    std::vector<FdState> fds_;
+    std::vector<int> pending_; // 等待提交的修改
+    std::atomic<std::thread::id> loopThread_; // Wait所在线程， 工作线程ModFd时读取
+    std::atomic<uint64_t> ctlIssued_;  // 实际发出的epoll_ctl次数
+    std::atomic<uint64_t> ctlAvoided_; // 被跳过或合并的epoll_ctl次数
 };
 
 #endif // EPOLLER_H
@@ -0,0 +1,36 @@
+/**
+ * @file poller.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief I/O多路复用引擎工厂
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "poller.h"
+#include "epoller.h"
+#include "uringpoller.h"
+#include "log.h"
+
+/**
+ * @brief 创建事件引擎， io_uring不可用时退回epoll
+ *
+ * @param engine 引擎类型
+ * @param maxEvent 单次Wait返回的最大事件数
+ * @return std::unique_ptr<Poller>
+ */
+std::unique_ptr<Poller> Poller::Create(EventEngine engine, int maxEvent)
+{
+    if (engine == EventEngine::IO_URING)
+    {
+        auto poller = std::make_unique<UringPoller>(maxEvent);
+        if (poller->IsValid())
+        {
+            return poller;
+        }
+        LOG_WARN("io_uring unavailable, fall back to epoll!");
+    }
+    return std::make_unique<Epoller>(maxEvent);
+}
@@ -0,0 +1,52 @@
+/**
+ * @file poller.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief I/O多路复用引擎接口
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#if !defined(POLLER_H)
+#define POLLER_H
+
+#include <sys/epoll.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+
+/**
+ * @brief 事件引擎类型
+ *
+ */
+enum class EventEngine
+{
+    EPOLL = 0,
+    IO_URING = 1,
+};
+
+/**
+ * @brief 就绪事件通知接口
+ *
+ * 事件掩码统一使用EPOLLIN、EPOLLOUT、EPOLLET、EPOLLONESHOT等epoll标志，
+ * 由具体引擎负责转换。
+ */
+class Poller
+{
+public:
+    virtual ~Poller() = default;
+
+    virtual bool AddFd(int fd, uint32_t events) = 0;
+    virtual bool ModFd(int fd, uint32_t events) = 0;
+    virtual bool DelFd(int fd) = 0;
+    virtual int Wait(int timeoutMs = -1) = 0;
+    virtual int GetEventFd(size_t i) const = 0;
+    virtual uint32_t GetEvents(size_t i) const = 0;
+
+    static std::unique_ptr<Poller> Create(EventEngine engine,
+                                          int maxEvent = 1024);
+};
+
+#endif // POLLER_H
@@ -0,0 +1,909 @@
+/**
+ * @file reactor.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 事件循环(Reactor)实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "reactor.h"
+#include "uringpoller.h"
+
+/**
+ * @brief Construct a new Reactor:: Reactor object
+ *
+ * @param port 监听端口
+ * @param timeoutMS 连接超时时间
+ * @param openLinger 是否开启优雅关闭
+ * @param listenEvent 监听套接字的事件模式
+ * @param connEvent 连接套接字的事件模式
+ * @param reusePort 是否开启SO_REUSEPORT 多Reactor共享端口时使用
+ * @param listenOpts 监听套接字参数
+ * @param users 以fd为下标的连接表
+ * @param engine 事件引擎
+ * @param threadpool 工作线程池， 为空时在Reactor线程内处理读写
+ * @param timerType 超时定时器实现
+ * @param timerTickMS 时间轮刻度
+ * @param lazyTimeout 是否使用惰性超时
+ */
+Reactor::Reactor(int port,
+                 int timeoutMS,
+                 bool openLinger,
+                 uint32_t listenEvent,
+                 uint32_t connEvent,
+                 bool reusePort,
+                 const ListenOptions &listenOpts,
+                 std::vector<HttpConn> &users,
+                 EventEngine engine,
+                 ThreadPool *threadpool,
+                 TimerType timerType,
+                 int timerTickMS,
+                 bool lazyTimeout)
+: port_(port)
+, openLinger_(openLinger)
+, reusePort_(reusePort)
+, timeoutMS_(timeoutMS)
+, lazyTimeout_(lazyTimeout)
+, isClose_(false)
+, stopListen_(false)
+, listening_(false)
+, wakeupFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+, listenFd_(-1)
+, listenOpts_(listenOpts)
+, acceptPending_(false)
+, acceptPaused_(false)
+, listenEvent_(listenEvent)
+, connEvent_(connEvent)
+, threadpool_(threadpool)
+, timer_(Timer::Create(timerType, timerTickMS))
+, poller_(Poller::Create(engine))
+, uring_(nullptr)
+, users_(users)
+{
+    assert(wakeupFd_ >= 0);
+    if (!threadpool_)
+    {
+        /* 读写都在本线程完成时， 直接向io_uring提交收发请求 */
+        uring_ = dynamic_cast<UringPoller *>(poller_.get());
+        if (uring_ && !uring_->CompletionIO())
+        {
+            uring_ = nullptr;
+        }
+    }
+    poller_->AddFd(wakeupFd_, EPOLLIN);
+}
+
+/**
+ * @brief Destroy the Reactor:: Reactor object
+ *
+ */
+Reactor::~Reactor()
+{
+    if (listenFd_ >= 0)
+    {
+        close(listenFd_);
+    }
+    close(wakeupFd_);
+}
+
+/**
+ * @brief 初始化网络套接字
+ *
+ * @param inheritedFd 热升级时从旧进程接收的监听套接字， -1表示新建
+ * @return true
+ * @return false
+ */
+bool Reactor::InitSocket(int inheritedFd)
+{
+    int ret;
+    struct sockaddr_in addr;
+    if (port_ > 65535 || port_ < 1024)
+    {
+        LOG_ERROR("Port:%d error!", port_);
+        return false;
+    }
+    if (inheritedFd >= 0)
+    {
+        socklen_t len = sizeof(addr);
+        ret = getsockname(inheritedFd, (struct sockaddr *)&addr, &len);
+        if (ret == 0 && addr.sin_family == AF_INET &&
+            ntohs(addr.sin_port) == port_ && ArmListen_(inheritedFd))
+        {
+            /* 沿用旧进程的监听队列， 只按新配置调整backlog */
+            listenFd_ = inheritedFd;
+            listen(listenFd_, listenOpts_.backlog);
+            listening_ = true;
+            LOG_INFO("Server port:%d, inherited listen fd:%d", port_, listenFd_);
+            return true;
+        }
+        LOG_WARN("Inherited listen fd:%d mismatch, create new one", inheritedFd);
+        close(inheritedFd);
+    }
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port_);
+    struct linger optLinger = {0};
+    if (openLinger_)
+    {
+        optLinger.l_onoff = 1;
+        optLinger.l_linger = 1;
+    }
+    listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0)
+    {
+        LOG_ERROR("Create socket error!", port_);
+        return false;
+    }
+    ret = setsockopt(
+        listenFd_, SOL_SOCKET, SO_LINGER, &optLinger, sizeof(optLinger));
+    if (ret < 0)
+    {
+        close(listenFd_);
+        LOG_ERROR("Init linger error!");
+        return false;
+    }
+    int optval = 1;
+    ret = setsockopt(listenFd_,
+                     SOL_SOCKET,
+                     SO_REUSEADDR,
+                     (const void *)&optval,
+                     sizeof(int));
+    if (ret == -1)
+    {
+        close(listenFd_);
+        LOG_ERROR("Set reuse address error!");
+        return false;
+    }
+    if (reusePort_)
+    {
+        /* 每个Reactor绑定同一端口， 由内核在监听队列间做负载均衡 */
+        ret = setsockopt(listenFd_,
+                         SOL_SOCKET,
+                         SO_REUSEPORT,
+                         (const void *)&optval,
+                         sizeof(int));
+        if (ret == -1)
+        {
+            close(listenFd_);
+            LOG_ERROR("Set reuse port error!");
+            return false;
+        }
+    }
+    ret = bind(listenFd_, (struct sockaddr *)&addr, sizeof(addr));
+    if (ret < 0)
+    {
+        close(listenFd_);
+        LOG_ERROR("Bind Port:%d error!", port_);
+        return false;
+    }
+    ret = listen(listenFd_, listenOpts_.backlog);
+    if (ret < 0)
+    {
+        close(listenFd_);
+        LOG_ERROR("Listen port:%d error!", port_);
+        return false;
+    }
+    if (listenOpts_.deferAcceptSec > 0)
+    {
+        /* 连接在收到首个数据包后才进入全连接队列 */
+        ret = setsockopt(listenFd_,
+                         IPPROTO_TCP,
+                         TCP_DEFER_ACCEPT,
+                         &listenOpts_.deferAcceptSec,
+                         sizeof(int));
+        if (ret == -1)
+        {
+            LOG_WARN("Set TCP_DEFER_ACCEPT error: %s", strerror(errno));
+        }
+    }
+    if (listenOpts_.fastOpenQueue > 0)
+    {
+        /* 允许客户端在SYN中携带请求数据， 失败不影响正常监听 */
+        ret = setsockopt(listenFd_,
+                         IPPROTO_TCP,
+                         TCP_FASTOPEN,
+                         &listenOpts_.fastOpenQueue,
+                         sizeof(int));
+        if (ret == -1)
+        {
+            LOG_WARN("Set TCP_FASTOPEN error: %s", strerror(errno));
+        }
+    }
+    if (!ArmListen_(listenFd_))
+    {
+        close(listenFd_);
+        LOG_ERROR("Add listen error!");
+        return false;
+    }
+    listening_ = true;
+    LOG_INFO("Server port:%d, backlog:%d", port_, listenOpts_.backlog);
+    return true;
+}
+
+/**
+ * @brief 运行事件循环， 直到Stop被调用
+ *
+ */
+void Reactor::Loop()
+{
+    while (!isClose_)
+    {
+        int timeMS = -1; // epoll wait timeout
+        if (timeoutMS_ > 0)
+        {
+            std::lock_guard<std::mutex> locker(timerMtx_);
+            timeMS = timer_->GetNextTick();
+            if (threadpool_ && (timeMS < 0 || timeMS > timeoutMS_))
+            {
+                /* 工作线程挂回的定时器不会唤醒Wait， 最多等待一个超时周期 */
+                timeMS = timeoutMS_;
+            }
+        }
+        if (acceptPending_)
+        {
+            /* 还有连接未接受， 不能阻塞等待 */
+            timeMS = 0;
+        }
+        if (acceptPaused_)
+        {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(
+                            acceptResume_ - std::chrono::steady_clock::now())
+                            .count();
+            if (left <= 0)
+            {
+                ResumeAccept_();
+            }
+            else if (timeMS < 0 || timeMS > left)
+            {
+                timeMS = static_cast<int>(left);
+            }
+        }
+        int eventCnt = poller_->Wait(timeMS);
+        if (timeoutMS_ > 0)
+        {
+            /* 每轮只读取一次时钟， 本轮所有定时器操作都使用该时间 */
+            std::lock_guard<std::mutex> locker(timerMtx_);
+            timer_->UpdateNow();
+        }
+        bool listened = false;
+        for (int i = 0; i < eventCnt; i++)
+        {
+            int fd = poller_->GetEventFd(i);
+            uint32_t events = poller_->GetEvents(i);
+            if (fd == listenFd_ && uring_)
+            {
+                OnAccept_(uring_->GetResult(i));
+            }
+            else if (fd == listenFd_)
+            {
+                // 处理监听事件 接受连接
+                DealListen_();
+                listened = true;
+            }
+            else if (fd == wakeupFd_)
+            {
+                uint64_t one;
+                while (read(wakeupFd_, &one, sizeof(one)) > 0)
+                {
+                }
+            }
+            else if (uring_)
+            {
+                assert(fd < static_cast<int>(users_.size()));
+                DealCompletion_(&users_[fd], i);
+            }
+            else if (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                // 处理错误 关闭连接
+                assert(fd < static_cast<int>(users_.size()));
+                CloseConn_(&users_[fd]);
+            }
+            else if (events & EPOLLIN)
+            {
+                // 处理读事件
+                assert(fd < static_cast<int>(users_.size()));
+                DealRead_(&users_[fd]);
+            }
+            else if (events & EPOLLOUT)
+            {
+                // 处理写事件
+                assert(fd < static_cast<int>(users_.size()));
+                DealWrite_(&users_[fd]);
+            }
+            else
+            {
+                LOG_ERROR("Unexpected event");
+            }
+        }
+        if (acceptPending_ && !listened)
+        {
+            /* 边沿触发不会再次通知， 在处理完已有连接后继续接受 */
+            DealListen_();
+        }
+        if (stopListen_ && listenFd_ >= 0)
+        {
+            /* 监听套接字已移交给新进程， 只关闭本进程的引用 */
+            poller_->DelFd(listenFd_);
+            close(listenFd_);
+            listenFd_ = -1;
+            acceptPending_ = false;
+            acceptPaused_ = false;
+            listening_ = false;
+            LOG_INFO("Stop listening on port:%d", port_);
+        }
+    }
+}
+
+/**
+ * @brief 停止事件循环
+ *
+ */
+void Reactor::Stop()
+{
+    isClose_ = true;
+    Wakeup();
+}
+
+/**
+ * @brief 停止接受新连接， 已有连接继续处理
+ *
+ */
+void Reactor::StopListen()
+{
+    stopListen_ = true;
+    Wakeup();
+}
+
+/**
+ * @brief 唤醒阻塞在Wait中的事件循环， 可在任意线程调用
+ *
+ */
+void Reactor::Wakeup()
+{
+    uint64_t one = 1;
+    ssize_t n = write(wakeupFd_, &one, sizeof(one));
+    (void)n;
+}
+
+/**
+ * @brief 添加一个客户端连接
+ *
+ * @param fd
+ * @param addr
+ */
+void Reactor::AddClient_(int fd, sockaddr_in addr)
+{
+    assert(fd > 0);
+    users_[fd].init(fd, addr);
+    AddTimer_(&users_[fd]);
+    if (uring_)
+    {
+        uring_->Recv(fd);
+    }
+    else
+    {
+        // 绑定客户端的读事件和触发模式
+        poller_->AddFd(fd, EPOLLIN | connEvent_);
+    }
+    LOG_INFO("Client[%d] in!", users_[fd].getFd());
+}
+
+/**
+ * @brief 接受连接
+ *
+ * 每次最多接受acceptBudget个连接， 避免大量新连接饿死已有连接。
+ * 边沿触发下未读到EAGAIN就返回时记录acceptPending_， 由Loop在本轮结束后
+ * 继续接受； fd耗尽时暂停接受。
+ */
+void Reactor::DealListen_()
+{
+    struct sockaddr_in addr;
+    acceptPending_ = false;
+    for (int i = 0; i < listenOpts_.acceptBudget; i++)
+    {
+        socklen_t len = sizeof(addr);
+        int fd = accept4(listenFd_,
+                         (struct sockaddr *)&addr,
+                         &len,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || PauseAccept_(errno))
+            {
+                return;
+            }
+            LOG_WARN("Accept error: %s", strerror(errno));
+            acceptPending_ = (listenEvent_ & EPOLLET);
+            return;
+        }
+        else if (fd >= static_cast<int>(users_.size()))
+        {
+            SendError_(fd, "Server busy!");
+            LOG_WARN("Clients is full!");
+            acceptPending_ = (listenEvent_ & EPOLLET);
+            return;
+        }
+        AddClient_(fd, addr);
+    }
+    acceptPending_ = (listenEvent_ & EPOLLET);
+}
+
+/**
+ * @brief fd或内存耗尽时暂停接受连接
+ *
+ * 此时accept会一直失败， 水平触发的监听事件或立即重新提交的accept请求
+ * 都会使事件循环空转。 暂停ACCEPT_BACKOFF_MS， 期间关闭的连接释放出fd，
+ * 之后由Loop调用ResumeAccept_恢复。
+ *
+ * @param err accept的错误码
+ * @return true 已暂停
+ * @return false 不是资源耗尽的错误
+ */
+bool Reactor::PauseAccept_(int err)
+{
+    if (err != EMFILE && err != ENFILE && err != ENOBUFS && err != ENOMEM)
+    {
+        return false;
+    }
+    LOG_WARN("Accept error: %s, pause %dms", strerror(err), ACCEPT_BACKOFF_MS);
+    acceptPending_ = false;
+    acceptPaused_ = true;
+    acceptResume_ = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(ACCEPT_BACKOFF_MS);
+    if (!uring_)
+    {
+        /* io_uring的multishot accept出错时已经结束 */
+        poller_->DelFd(listenFd_);
+    }
+    return true;
+}
+
+/**
+ * @brief 暂停结束后重新注册监听套接字
+ *
+ * 注册时已在全连接队列中的连接会立即上报， 边沿触发也不会遗漏。
+ */
+void Reactor::ResumeAccept_()
+{
+    acceptPaused_ = false;
+    if (listenFd_ >= 0 && !stopListen_)
+    {
+        ArmListen_(listenFd_);
+    }
+}
+
+/**
+ * @brief 处理写事件
+ *
+ * @param client
+ */
+void Reactor::DealWrite_(HttpConn *client)
+{
+    assert(client);
+    if (threadpool_)
+    {
+        /* 连接交给工作线程期间不参与超时检查， 由工作线程重新挂上定时器 */
+        std::lock_guard<std::mutex> locker(timerMtx_);
+        timer_->cancel(client->getFd());
+        threadpool_->AddTask(std::bind(&Reactor::OnWrite_, this, client));
+        return;
+    }
+    ExtentTime_(client);
+    OnWrite_(client);
+}
+
+/**
+ * @brief 处理读事件
+ *
+ * @param client
+ */
+void Reactor::DealRead_(HttpConn *client)
+{
+    assert(client);
+    if (threadpool_)
+    {
+        std::lock_guard<std::mutex> locker(timerMtx_);
+        timer_->cancel(client->getFd());
+        threadpool_->AddTask(std::bind(&Reactor::OnRead_, this, client));
+        return;
+    }
+    ExtentTime_(client);
+    OnRead_(client);
+}
+
+/**
+ * @brief 发送错误信息
+ *
+ * @param fd
+ * @param info
+ */
+void Reactor::SendError_(int fd, const char *info)
+{
+    assert(fd > 0);
+    int ret = send(fd, info, strlen(info), 0);
+    if (ret < 0)
+    {
+        LOG_WARN("send error to client[%d] error!", fd);
+    }
+    close(fd);
+}
+
+/**
+ * @brief 为客户端连接添加超时定时器
+ *
+ * @param client
+ */
+void Reactor::AddTimer_(HttpConn *client)
+{
+    assert(client);
+    if (timeoutMS_ > 0)
+    {
+        std::lock_guard<std::mutex> locker(timerMtx_);
+        AddTimerLocked_(client);
+    }
+}
+
+/**
+ * @brief 同AddTimer_， 调用者须已持有timerMtx_且timeoutMS_ > 0
+ *
+ * @param client
+ */
+void Reactor::AddTimerLocked_(HttpConn *client)
+{
+    client->SetLastActive(timer_->Now());
+    timer_->add(client->getFd(),
+                timeoutMS_,
+                std::bind(&Reactor::OnTimeout_, this, client));
+}
+
+/**
+ * @brief 延长客户端连接时间
+ *
+ * @param client
+ */
+void Reactor::ExtentTime_(HttpConn *client)
+{
+    assert(client);
+    if (timeoutMS_ <= 0)
+    {
+        return;
+    }
+    if (lazyTimeout_)
+    {
+        /* 只在Reactor线程调用， 缓存时间也只由本线程更新， 无需加锁 */
+        client->SetLastActive(timer_->Now());
+        return;
+    }
+    std::lock_guard<std::mutex> locker(timerMtx_);
+    timer_->adjust(client->getFd(), timeoutMS_);
+}
+
+/**
+ * @brief 连接定时器到期
+ *
+ * 惰性超时模式下， 若连接在此期间活跃过， 则按剩余时间重新挂上定时器。
+ * 由定时器在持有timerMtx_时回调。
+ *
+ * @param client
+ */
+void Reactor::OnTimeout_(HttpConn *client)
+{
+    assert(client);
+    if (lazyTimeout_)
+    {
+        auto idle = std::chrono::duration_cast<MS>(timer_->Now() -
+                                                   client->LastActive())
+                        .count();
+        if (idle < timeoutMS_)
+        {
+            timer_->add(client->getFd(),
+                        timeoutMS_ - idle,
+                        std::bind(&Reactor::OnTimeout_, this, client));
+            return;
+        }
+    }
+    CloseConn_(client);
+}
+
+/**
+ * @brief 重新注册连接的事件
+ *
+ * 线程池模式下由工作线程调用， 挂回定时器并通过ModFd归还连接，
+ * 此后连接重新由Reactor线程管理。 两者在同一个timerMtx_临界区内完成，
+ * 否则定时器可能在两者之间到期并关闭连接， 之后的ModFd就会作用于已关闭
+ * 甚至已被新连接复用的fd。
+ *
+ * @param client
+ * @param events 期望的读写事件
+ */
+void Reactor::Rearm_(HttpConn *client, uint32_t events)
+{
+    assert(client);
+    if (threadpool_ && timeoutMS_ > 0)
+    {
+        std::lock_guard<std::mutex> locker(timerMtx_);
+        AddTimerLocked_(client);
+        poller_->ModFd(client->getFd(), connEvent_ | events);
+        return;
+    }
+    poller_->ModFd(client->getFd(), connEvent_ | events);
+}
+
+/**
+ * @brief 关闭与客户端的连接
+ *
+ * @param client
+ */
+void Reactor::CloseConn_(HttpConn *client)
+{
+    assert(client);
+    LOG_INFO("Client[%d] quit!", client->getFd());
+    if (uring_)
+    {
+        /* 撤销在下一次提交时才生效， 先关闭套接字的收发， 使未完成的发送
+           不再读取即将释放的响应数据 */
+        shutdown(client->getFd(), SHUT_RDWR);
+    }
+    poller_->DelFd(client->getFd());
+    client->Close();
+}
+
+/**
+ * @brief 处理读事件
+ *
+ * @param client
+ */
+void Reactor::OnRead_(HttpConn *client)
+{
+    assert(client);
+    int ret = -1;
+    int readErrno = 0;
+    ret = client->read(&readErrno);
+    // 读失败且错误码不是EAGAIN 说明对端关闭连接
+    if (ret <= 0 && readErrno != EAGAIN)
+    {
+        CloseConn_(client);
+        return;
+    }
+    OnProcess(client);
+}
+
+/**
+ * @brief 处理写事件
+ *
+ * @param client
+ */
+void Reactor::OnWrite_(HttpConn *client)
+{
+    assert(client);
+    int ret = -1;
+    int writeErrno = 0;
+    ret = client->write(&writeErrno);
+    if (client->ToWriteBytes() == 0)
+    {
+        // 传输完成
+        if (client->isKeepAlive())
+        {
+            OnProcess(client);
+            return;
+        }
+    }
+    else if (ret >= 0 || writeErrno == EAGAIN)
+    {
+        // 继续传输
+        Rearm_(client, EPOLLOUT);
+        return;
+    }
+    CloseConn_(client);
+}
+
+/**
+ * @brief 处理客户端请求
+ *
+ * @param client
+ */
+void Reactor::OnProcess(HttpConn *client)
+{
+    if (client->process())
+    {
+        /* 处理请求成功， 直接尝试写回， 写不完时再注册写就绪事件 */
+        uring_ ? Send_(client) : OnWrite_(client);
+    }
+    else if (!uring_)
+    {
+        /* 处理请求失败， 需要继续读取， multishot recv则一直有效 */
+        Rearm_(client, EPOLLIN);
+    }
+}
+
+/**
+ * @brief 开始在监听套接字上接受连接
+ *
+ * @param fd 监听套接字
+ * @return true
+ * @return false
+ */
+bool Reactor::ArmListen_(int fd)
+{
+    if (uring_)
+    {
+        return uring_->Accept(fd);
+    }
+    return poller_->AddFd(fd, listenEvent_ | EPOLLIN);
+}
+
+/**
+ * @brief 处理multishot accept的完成事件
+ *
+ * @param fd 新连接， 出错时为负的错误码
+ */
+void Reactor::OnAccept_(int fd)
+{
+    if (fd < 0)
+    {
+        /* 出错后multishot accept已结束， fd耗尽时暂停后再提交 */
+        if (PauseAccept_(-fd))
+        {
+            return;
+        }
+        if (fd != -ECONNABORTED && fd != -EINTR)
+        {
+            LOG_WARN("Accept error: %s", strerror(-fd));
+        }
+        uring_->Accept(listenFd_);
+        return;
+    }
+    if (fd >= static_cast<int>(users_.size()))
+    {
+        SendError_(fd, "Server busy!");
+        LOG_WARN("Clients is full!");
+        return;
+    }
+    /* multishot accept不返回对端地址 */
+    struct sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    getpeername(fd, (struct sockaddr *)&addr, &len);
+    AddClient_(fd, addr);
+}
+
+/**
+ * @brief 处理连接上的完成事件
+ *
+ * @param client
+ * @param i 事件下标
+ */
+void Reactor::DealCompletion_(HttpConn *client, size_t i)
+{
+    assert(client);
+    if (uring_->IsExpired(i))
+    {
+        /* 连接已在本轮处理之前的事件时关闭 */
+        return;
+    }
+    switch (uring_->GetOp(i))
+    {
+    case UringPoller::RECV:
+        OnRecv_(client, uring_->GetResult(i), uring_->GetData(i));
+        break;
+    case UringPoller::SEND:
+        OnSent_(client, uring_->GetResult(i));
+        break;
+    default:
+        /* 用sendfile发送的文件在套接字可写后继续发送 */
+        Send_(client);
+        break;
+    }
+}
+
+/**
+ * @brief 处理multishot recv读取的数据
+ *
+ * 发送响应期间到达的数据只追加到读缓冲区， 发送完成后再处理。
+ *
+ * @param client
+ * @param len 读取的字节数， 0表示对端关闭， 出错时为负的错误码
+ * @param data
+ */
+void Reactor::OnRecv_(HttpConn *client, int len, const char *data)
+{
+    if (len <= 0)
+    {
+        CloseConn_(client);
+        return;
+    }
+    client->Append(data, len);
+    ExtentTime_(client);
+    if (client->ToWriteBytes() == 0)
+    {
+        OnProcess(client);
+    }
+}
+
+/**
+ * @brief 发送响应
+ *
+ * 内存中的数据作为SENDMSG请求在下一次Wait时批量提交； 用sendfile发送的
+ * 文件直接发送， 套接字写满时提交单次poll等待可写。
+ *
+ * @param client
+ */
+void Reactor::Send_(HttpConn *client)
+{
+    while (true)
+    {
+        int flags = 0;
+        const struct msghdr *msg = client->PrepareSend(&flags);
+        if (msg)
+        {
+            /* MSG_WAITALL使内核在部分发送后继续等待， 减少完成事件 */
+            if (!uring_->Send(client->getFd(), msg, flags | MSG_WAITALL))
+            {
+                CloseConn_(client);
+            }
+            return;
+        }
+        int writeErrno = 0;
+        ssize_t ret = client->WriteFile(&writeErrno);
+        if (client->ToWriteBytes() == 0)
+        {
+            OnSendDone_(client);
+            return;
+        }
+        if (ret < 0)
+        {
+            if (writeErrno == EAGAIN)
+            {
+                poller_->ModFd(client->getFd(), EPOLLOUT | EPOLLONESHOT);
+            }
+            else
+            {
+                CloseConn_(client);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 处理SENDMSG的完成事件
+ *
+ * @param client
+ * @param len 发送的字节数， 出错时为负的错误码
+ */
+void Reactor::OnSent_(HttpConn *client, int len)
+{
+    if (len <= 0)
+    {
+        CloseConn_(client);
+        return;
+    }
+    client->Sent(len);
+    ExtentTime_(client);
+    if (client->ToWriteBytes() > 0)
+    {
+        Send_(client);
+        return;
+    }
+    OnSendDone_(client);
+}
+
+/**
+ * @brief 响应发送完毕， 保持连接时继续处理已读到的请求
+ *
+ * @param client
+ */
+void Reactor::OnSendDone_(HttpConn *client)
+{
+    if (client->isKeepAlive())
+    {
+        OnProcess(client);
+        return;
+    }
+    CloseConn_(client);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file reactor.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 事件循环(Reactor)声明
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#if !defined(REACTOR_H)
+#define REACTOR_H
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+#include <assert.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+
+#include "poller.h"
+#include "log.h"
+#include "timer.h"
+#include "threadpool.h"
+#include "httpconn.h"
+
+class UringPoller;
+
+/**
+ * @brief 监听套接字参数
+ *
+ */
+struct ListenOptions
+{
+    int backlog = 1024;     // listen的全连接队列长度
+    int deferAcceptSec = 0; // TCP_DEFER_ACCEPT等待首包的秒数， 0为关闭
+    int fastOpenQueue = 0;  // TCP_FASTOPEN队列长度， 0为关闭
+    int acceptBudget = 64;  // 每轮事件循环最多接受的连接数
+};
+
+/**
+ * @brief 一个独立的事件循环
+ *
+ * 每个Reactor拥有自己的监听套接字、事件引擎和定时器，
+ * 多个Reactor通过SO_REUSEPORT监听同一端口，由内核分发新连接。
+ * 若指定了线程池， 则Reactor只负责接受连接和分发事件， 读取、解析和写回
+ * 交由工作线程完成， 工作线程通过ModFd重新注册事件后归还连接。
+ * 不使用线程池且io_uring支持完成语义的请求时， 接受连接、读取和发送都
+ * 作为请求提交给io_uring， 每轮事件循环只有一次io_uring_enter。
+ */
+class Reactor
+{
+public:
+    Reactor(int port,
+            int timeoutMS,
+            bool openLinger,
+            uint32_t listenEvent,
+            uint32_t connEvent,
+            bool reusePort,
+            const ListenOptions &listenOpts,
+            std::vector<HttpConn> &users,
+            EventEngine engine = EventEngine::EPOLL,
+            ThreadPool *threadpool = nullptr,
+            TimerType timerType = TimerType::HEAP,
+            int timerTickMS = 1,
+            bool lazyTimeout = false);
+
+    ~Reactor();
+
+    bool InitSocket(int inheritedFd = -1);
+
+    void Loop();
+
+    void Stop();
+
+    void StopListen();
+
+    void Wakeup();
+
+    int ListenFd() const { return listenFd_; }
+    /* StopListen后， 监听套接字真正关闭前为true */
+    bool IsListening() const { return listening_; }
+
+    static const int MAX_FD = 65536;
+    /* fd或内存耗尽时暂停接受连接的时间 */
+    static constexpr int ACCEPT_BACKOFF_MS = 100;
+
+private:
+    void AddClient_(int fd, sockaddr_in addr);
+
+    void DealListen_();
+
+    bool PauseAccept_(int err);
+
+    void ResumeAccept_();
+
+    void DealWrite_(HttpConn *client);
+
+    void DealRead_(HttpConn *client);
+
+    void SendError_(int fd, const char *info);
+
+    void AddTimer_(HttpConn *client);
+    void AddTimerLocked_(HttpConn *client);
+
+    void ExtentTime_(HttpConn *client);
+
+    void OnTimeout_(HttpConn *client);
+
+    void Rearm_(HttpConn *client, uint32_t events);
+
+    void CloseConn_(HttpConn *client);
+
+    void OnRead_(HttpConn *client);
+
+    void OnWrite_(HttpConn *client);
+
+    void OnProcess(HttpConn *client);
+
+    bool ArmListen_(int fd);
+
+    void OnAccept_(int fd);
+
+    void DealCompletion_(HttpConn *client, size_t i);
+
+    void OnRecv_(HttpConn *client, int len, const char *data);
+
+    void Send_(HttpConn *client);
+
+    void OnSent_(HttpConn *client, int len);
+
+    void OnSendDone_(HttpConn *client);
+
+    int port_;
+    bool openLinger_;
+    bool reusePort_;
+    int timeoutMS_;
+    bool lazyTimeout_; // 只记录活跃时间， 到期时再判断是否真正超时
+    std::atomic<bool> isClose_;
+    std::atomic<bool> stopListen_; // 热升级后不再接受新连接
+    std::atomic<bool> listening_;
+    int wakeupFd_;                 // 用于从其他线程唤醒Wait
+    int listenFd_;
+    ListenOptions listenOpts_;
+    bool acceptPending_; // 边沿触发下本轮未接受完的连接
+    bool acceptPaused_;  // fd耗尽， 暂停接受直到acceptResume_
+    std::chrono::steady_clock::time_point acceptResume_;
+    uint32_t listenEvent_;
+    uint32_t connEvent_;
+    ThreadPool *threadpool_;
+    std::mutex timerMtx_; // 工作线程与Reactor线程都会操作定时器
+    std::unique_ptr<Timer> timer_;
+    std::unique_ptr<Poller> poller_;
+    UringPoller *uring_; // 使用完成语义的请求时指向poller_， 否则为空
+    std::vector<HttpConn> &users_; // 以fd为下标的连接表， 由所有Reactor共享
+};
+
+#endif // REACTOR_H
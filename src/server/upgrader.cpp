@@ -0,0 +1,265 @@
+/**
+ * @file upgrader.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 热升级： 通过Unix套接字移交监听套接字
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "upgrader.h"
+
+extern char **environ;
+
+const char *const Upgrader::UPGRADE_ENV = "WEBSERVER_UPGRADE_FD";
+
+/**
+ * @brief Construct a new Upgrader:: Upgrader object
+ *
+ * 记录可执行文件路径； 若由旧进程启动， 则接收其监听套接字。
+ */
+Upgrader::Upgrader()
+: channel_(-1)
+{
+    char exePath[256] = {0};
+    ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+    if (len > 0)
+    {
+        exePath_.assign(exePath, len);
+        /* 可执行文件被替换后readlink会带上" (deleted)"后缀 */
+        const std::string deleted = " (deleted)";
+        if (exePath_.size() > deleted.size() &&
+            exePath_.compare(exePath_.size() - deleted.size(),
+                             deleted.size(),
+                             deleted) == 0)
+        {
+            exePath_.resize(exePath_.size() - deleted.size());
+        }
+    }
+
+    const char *env = getenv(UPGRADE_ENV);
+    if (!env)
+    {
+        return;
+    }
+    channel_ = atoi(env);
+    unsetenv(UPGRADE_ENV);
+    fcntl(channel_, F_SETFD, FD_CLOEXEC);
+    if (!RecvFds_(channel_, inherited_))
+    {
+        LOG_ERROR("Receive listen fds from old process error!");
+        close(channel_);
+        channel_ = -1;
+    }
+}
+
+/**
+ * @brief Destroy the Upgrader:: Upgrader object
+ *
+ */
+Upgrader::~Upgrader()
+{
+    if (channel_ >= 0)
+    {
+        close(channel_);
+    }
+}
+
+/**
+ * @brief 新进程初始化完成后通知旧进程
+ *
+ * @param ok 初始化是否成功， 失败时旧进程继续服务
+ */
+void Upgrader::NotifyReady(bool ok)
+{
+    if (channel_ < 0)
+    {
+        return;
+    }
+    if (ok)
+    {
+        char ready = 'R';
+        if (write(channel_, &ready, 1) != 1)
+        {
+            LOG_ERROR("Notify old process error!");
+        }
+    }
+    close(channel_);
+    channel_ = -1;
+}
+
+/**
+ * @brief 启动新进程并移交监听套接字
+ *
+ * @param listenFds 监听套接字
+ * @param timeoutMs 等待新进程就绪的时间
+ * @return true 新进程已接管监听套接字
+ * @return false 升级失败， 本进程应继续服务
+ */
+bool Upgrader::Spawn(const std::vector<int> &listenFds, int timeoutMs)
+{
+    if (exePath_.empty() || listenFds.empty() ||
+        listenFds.size() > static_cast<size_t>(MAX_LISTEN))
+    {
+        LOG_ERROR("Upgrade: nothing to hand over!");
+        return false;
+    }
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0)
+    {
+        LOG_ERROR("Upgrade: socketpair error: %s", strerror(errno));
+        return false;
+    }
+
+    /* fork后的子进程只能调用异步信号安全函数， 参数提前准备好 */
+    std::vector<std::string> envs;
+    for (char **e = environ; *e; e++)
+    {
+        if (strncmp(*e, UPGRADE_ENV, strlen(UPGRADE_ENV)) != 0)
+        {
+            envs.emplace_back(*e);
+        }
+    }
+    envs.push_back(std::string(UPGRADE_ENV) + "=" +
+                   std::to_string(CHANNEL_FD));
+    std::vector<char *> envp;
+    for (auto &e : envs)
+    {
+        envp.push_back(&e[0]);
+    }
+    envp.push_back(nullptr);
+    char *argv[] = {&exePath_[0], nullptr};
+    struct rlimit limit;
+    int maxFd = 65536;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+    {
+        maxFd = static_cast<int>(limit.rlim_cur);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        LOG_ERROR("Upgrade: fork error: %s", strerror(errno));
+        close(sv[0]);
+        close(sv[1]);
+        return false;
+    }
+    if (pid == 0)
+    {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigprocmask(SIG_SETMASK, &mask, nullptr);
+        if (sv[1] == CHANNEL_FD)
+        {
+            fcntl(CHANNEL_FD, F_SETFD, 0);
+        }
+        else if (dup2(sv[1], CHANNEL_FD) < 0)
+        {
+            _exit(127);
+        }
+        /* 不把连接、日志、数据库等描述符泄漏给新进程 */
+#if defined(SYS_close_range)
+        if (syscall(SYS_close_range, CHANNEL_FD + 1, ~0U, 0) < 0)
+#endif
+        {
+            for (int fd = CHANNEL_FD + 1; fd < maxFd; fd++)
+            {
+                close(fd);
+            }
+        }
+        execve(argv[0], argv, envp.data());
+        _exit(127);
+    }
+
+    close(sv[1]);
+    bool ok = SendFds_(sv[0], listenFds);
+    if (ok)
+    {
+        struct pollfd pfd = {sv[0], POLLIN, 0};
+        char ready = 0;
+        ok = poll(&pfd, 1, timeoutMs) == 1 && read(sv[0], &ready, 1) == 1 &&
+             ready == 'R';
+    }
+    close(sv[0]);
+    if (!ok)
+    {
+        LOG_ERROR("Upgrade: new process %d not ready, keep serving!", pid);
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        return false;
+    }
+    LOG_INFO("Upgrade: new process %d took over %d listen fd(s)",
+             pid,
+             static_cast<int>(listenFds.size()));
+    return true;
+}
+
+/**
+ * @brief 以SCM_RIGHTS发送描述符
+ *
+ * @param sock Unix套接字
+ * @param fds 待发送的描述符
+ * @return true
+ * @return false
+ */
+bool Upgrader::SendFds_(int sock, const std::vector<int> &fds)
+{
+    uint32_t count = fds.size();
+    struct iovec iov = {&count, sizeof(count)};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == sizeof(count);
+}
+
+/**
+ * @brief 接收SCM_RIGHTS描述符， 接收到的描述符带有FD_CLOEXEC
+ *
+ * @param sock Unix套接字
+ * @param fds 接收到的描述符
+ * @return true
+ * @return false
+ */
+bool Upgrader::RecvFds_(int sock, std::vector<int> &fds)
+{
+    uint32_t count = 0;
+    struct iovec iov = {&count, sizeof(count)};
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * MAX_LISTEN));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data();
+    msg.msg_controllen = control.size();
+    ssize_t n;
+    do
+    {
+        n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n != sizeof(count))
+    {
+        return false;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            size_t num = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const int *data = reinterpret_cast<const int *>(CMSG_DATA(cmsg));
+            fds.insert(fds.end(), data, data + num);
+        }
+    }
+    return fds.size() == count;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file upgrader.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 热升级： 通过Unix套接字移交监听套接字
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#if !defined(UPGRADER_H)
+#define UPGRADER_H
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "log.h"
+
+/**
+ * @brief 监听套接字移交
+ *
+ * 旧进程收到SIGUSR2后调用Spawn： fork并exec磁盘上的(新)可执行文件，
+ * 通过socketpair以SCM_RIGHTS发送所有监听套接字， 等待新进程确认。
+ * 新进程构造Upgrader时从环境变量UPGRADE_ENV找到该socketpair并接收
+ * 监听套接字， 初始化完成后调用NotifyReady通知旧进程停止接受并退出。
+ * 整个过程中监听队列始终有进程在accept， 新连接不会被拒绝。
+ */
+class Upgrader
+{
+public:
+    Upgrader();
+    ~Upgrader();
+
+    const std::vector<int> &InheritedFds() const { return inherited_; }
+
+    void NotifyReady(bool ok);
+
+    bool Spawn(const std::vector<int> &listenFds, int timeoutMs);
+
+    static const char *const UPGRADE_ENV;
+
+private:
+    static bool SendFds_(int sock, const std::vector<int> &fds);
+    static bool RecvFds_(int sock, std::vector<int> &fds);
+
+    static const int CHANNEL_FD = 3;   // 新进程中socketpair的fd
+    static const int MAX_LISTEN = 253; // SCM_RIGHTS单条消息的上限
+
+    int channel_; // 新进程中与旧进程通信的套接字
+    std::vector<int> inherited_;
+    std::string exePath_;
+};
+
+#endif // UPGRADER_H
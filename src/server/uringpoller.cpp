@@ -0,0 +1,936 @@
+/**
+ * @file uringpoller.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 基于io_uring的事件引擎实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "uringpoller.h"
+
+UringPoller::UringPoller(int maxEvent)
+: ringFd_(-1)
+, sqRing_(nullptr)
+, sqRingSize_(0)
+, sqes_(nullptr)
+, sqesSize_(0)
+, cqRing_(nullptr)
+, cqRingSize_(0)
+, bufRing_(nullptr)
+, bufRingSize_(0)
+, fds_(MAX_FD, FdState{0, 0, false, 0, false})
+, slot_(MAX_FD, -1)
+, events_(maxEvent)
+, eventCnt_(0)
+{
+    assert(events_.size() > 0);
+    if (!InitRing_(static_cast<unsigned>(maxEvent)))
+    {
+        ReleaseRing_();
+    }
+}
+
+UringPoller::~UringPoller() { ReleaseRing_(); }
+
+/**
+ * @brief 创建io_uring实例并映射提交队列和完成队列
+ *
+ * @param entries 提交队列长度
+ * @return true
+ * @return false 内核不支持io_uring或缺少所需特性(需5.13+)
+ */
+bool UringPoller::InitRing_(unsigned entries)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    /* multishot poll会产生较多完成事件， 完成队列适当放大 */
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 4;
+    ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd_ < 0)
+    {
+        return false;
+    }
+    /* Wait的超时依赖IORING_ENTER_EXT_ARG(5.11+) */
+    if (!(params.features & IORING_FEAT_EXT_ARG))
+    {
+        return false;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+    {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+    sqRing_ = mmap(nullptr,
+                   sqRingSize_,
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE,
+                   ringFd_,
+                   IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED)
+    {
+        sqRing_ = nullptr;
+        return false;
+    }
+    if (singleMmap)
+    {
+        cqRing_ = sqRing_;
+    }
+    else
+    {
+        cqRing_ = mmap(nullptr,
+                       cqRingSize_,
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE,
+                       ringFd_,
+                       IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED)
+        {
+            cqRing_ = nullptr;
+            return false;
+        }
+    }
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr,
+                      sqesSize_,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      ringFd_,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqEntries_ = params.sq_entries;
+
+    char *cq = static_cast<char *>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    /* EXT_ARG(5.11)之后multishot poll(5.13)才可用， 需单独探测 */
+    if (!ProbeMultishot_())
+    {
+        return false;
+    }
+    /* 完成语义的请求不可用时仍作为就绪事件引擎使用 */
+    InitBufs_();
+    return true;
+}
+
+/**
+ * @brief 探测内核是否支持multishot poll
+ *
+ * 对可读的eventfd提交一次multishot poll， 5.13之前的内核以-EINVAL拒绝，
+ * 支持时完成事件带有IORING_CQE_F_MORE。 探测请求随后撤销， 迟到的完成
+ * 事件由Harvest_按PROBE_TAG丢弃。
+ *
+ * @return true
+ * @return false
+ */
+bool UringPoller::ProbeMultishot_()
+{
+    int efd = eventfd(1, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (efd < 0)
+    {
+        return false;
+    }
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = efd;
+    sqe.poll32_events = EPOLLIN;
+    sqe.len = IORING_POLL_ADD_MULTI;
+    sqe.user_data = PROBE_TAG;
+    bool supported = false;
+    if (PushSqe_(sqe) && Enter_(1, 1, 1000) >= 0 &&
+        __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) != *cqHead_)
+    {
+        const io_uring_cqe &cqe = cqes_[*cqHead_ & *cqMask_];
+        supported = cqe.user_data == PROBE_TAG && cqe.res >= 0 &&
+                    (cqe.flags & IORING_CQE_F_MORE);
+    }
+    if (supported)
+    {
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_POLL_REMOVE;
+        sqe.fd = -1;
+        sqe.addr = PROBE_TAG;
+        sqe.user_data = REMOVE_TAG;
+        PushSqe_(sqe);
+        Enter_(1, 0, -1);
+    }
+    __atomic_store_n(cqHead_, __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    close(efd);
+    return supported;
+}
+
+/**
+ * @brief 准备multishot recv使用的provided buffer
+ *
+ * 优先使用buffer ring(5.19+)， 归还缓冲区只需写入共享内存。 注册成功但
+ * 探测时内核取不到其中的缓冲区时， 退回IORING_OP_PROVIDE_BUFFERS， 此时
+ * 归还缓冲区需要一个请求， 与其他请求一起提交。 都不可用时CompletionIO
+ * 为false。
+ */
+void UringPoller::InitBufs_()
+{
+    bufs_.resize(static_cast<size_t>(BUF_COUNT) * BUF_SIZE);
+    if (InitBufRing_())
+    {
+        if (ProbeRecv_())
+        {
+            return;
+        }
+        io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.bgid = BUF_GROUP;
+        syscall(__NR_io_uring_register, ringFd_, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        munmap(bufRing_, bufRingSize_);
+        bufRing_ = nullptr;
+    }
+    /* 丢弃探测留下的完成事件， 其中没有缓冲区 */
+    __atomic_store_n(cqHead_, __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe.fd = BUF_COUNT;
+    sqe.addr = reinterpret_cast<uint64_t>(bufs_.data());
+    sqe.len = BUF_SIZE;
+    sqe.off = 0;
+    sqe.buf_group = BUF_GROUP;
+    sqe.user_data = PROBE_TAG;
+    bool provided = false;
+    if (PushSqe_(sqe) && Enter_(1, 1, 1000) >= 0 &&
+        __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) != *cqHead_)
+    {
+        const io_uring_cqe &cqe = cqes_[*cqHead_ & *cqMask_];
+        provided = cqe.user_data == PROBE_TAG && cqe.res >= 0;
+        __atomic_store_n(cqHead_, *cqHead_ + 1, __ATOMIC_RELEASE);
+    }
+    if (!provided || !ProbeRecv_())
+    {
+        bufs_.clear();
+        bufs_.shrink_to_fit();
+    }
+}
+
+/**
+ * @brief 创建并注册provided buffer ring(需5.19+)
+ *
+ * @return true
+ * @return false
+ */
+bool UringPoller::InitBufRing_()
+{
+    bufRingSize_ = BUF_COUNT * sizeof(io_uring_buf);
+    void *ring = mmap(nullptr,
+                      bufRingSize_,
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS,
+                      -1,
+                      0);
+    if (ring == MAP_FAILED)
+    {
+        return false;
+    }
+    io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = BUF_COUNT;
+    reg.bgid = BUF_GROUP;
+    if (syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        munmap(ring, bufRingSize_);
+        return false;
+    }
+    bufRing_ = static_cast<io_uring_buf_ring *>(ring);
+    for (unsigned bid = 0; bid < BUF_COUNT; bid++)
+    {
+        RecycleBuf_(static_cast<uint16_t>(bid));
+    }
+    return true;
+}
+
+/**
+ * @brief 探测内核是否支持multishot recv(需6.0+)
+ *
+ * 对已有数据的socketpair提交一次multishot recv， 支持时完成事件同时带有
+ * IORING_CQE_F_MORE和IORING_CQE_F_BUFFER。 探测请求随后撤销。
+ *
+ * @return true
+ * @return false
+ */
+bool UringPoller::ProbeRecv_()
+{
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sv) < 0)
+    {
+        return false;
+    }
+    bool supported = false;
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = sv[0];
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUF_GROUP;
+    sqe.user_data = PROBE_TAG;
+    if (write(sv[1], "p", 1) == 1 && PushSqe_(sqe) && Enter_(1, 1, 1000) >= 0 &&
+        __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) != *cqHead_)
+    {
+        const io_uring_cqe &cqe = cqes_[*cqHead_ & *cqMask_];
+        supported = cqe.user_data == PROBE_TAG && cqe.res == 1 &&
+                    (cqe.flags & IORING_CQE_F_MORE) &&
+                    (cqe.flags & IORING_CQE_F_BUFFER);
+        if (cqe.flags & IORING_CQE_F_BUFFER)
+        {
+            RecycleBuf_(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+        __atomic_store_n(cqHead_, *cqHead_ + 1, __ATOMIC_RELEASE);
+    }
+    /* 撤销后迟到的完成事件由Harvest_按PROBE_TAG丢弃 */
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = -1;
+    sqe.addr = PROBE_TAG;
+    sqe.user_data = REMOVE_TAG;
+    PushSqe_(sqe);
+    Enter_(*sqTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE), 0, -1);
+    close(sv[0]);
+    close(sv[1]);
+    return supported;
+}
+
+/**
+ * @brief 释放io_uring实例
+ *
+ */
+void UringPoller::ReleaseRing_()
+{
+    if (sqes_)
+    {
+        munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+    if (cqRing_ && cqRing_ != sqRing_)
+    {
+        munmap(cqRing_, cqRingSize_);
+    }
+    cqRing_ = nullptr;
+    if (sqRing_)
+    {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = nullptr;
+    }
+    if (ringFd_ >= 0)
+    {
+        close(ringFd_);
+        ringFd_ = -1;
+    }
+    if (bufRing_)
+    {
+        munmap(bufRing_, bufRingSize_);
+        bufRing_ = nullptr;
+    }
+}
+
+/**
+ * @brief 注册文件描述符
+ *
+ * @param fd
+ * @param events
+ * @return true
+ * @return false
+ */
+bool UringPoller::AddFd(int fd, uint32_t events)
+{
+    if (fd < 0 || fd >= MAX_FD)
+        return false;
+    std::lock_guard<std::mutex> locker(mtx_);
+    FdState &st = fds_[fd];
+    if (st.armed)
+    {
+        PrepPollRemove_(fd);
+    }
+    st.events = events;
+    st.gen++;
+    PrepPollAdd_(fd);
+    SubmitIfForeign_();
+    return st.armed;
+}
+
+/**
+ * @brief 修改文件描述符的事件
+ *
+ * @param fd
+ * @param events
+ * @return true
+ * @return false
+ */
+bool UringPoller::ModFd(int fd, uint32_t events)
+{
+    if (fd < 0 || fd >= MAX_FD)
+        return false;
+    std::lock_guard<std::mutex> locker(mtx_);
+    FdState &st = fds_[fd];
+    if (st.armed)
+    {
+        /* 仍在内核中的poll先撤销， 过期的完成事件按代数丢弃 */
+        PrepPollRemove_(fd);
+    }
+    st.events = events;
+    PrepPollAdd_(fd);
+    SubmitIfForeign_();
+    return st.armed;
+}
+
+/**
+ * @brief 删除文件描述符
+ *
+ * @param fd
+ * @return true
+ * @return false
+ */
+bool UringPoller::DelFd(int fd)
+{
+    if (fd < 0 || fd >= MAX_FD)
+        return false;
+    std::lock_guard<std::mutex> locker(mtx_);
+    FdState &st = fds_[fd];
+    if (st.io)
+    {
+        /* 一次撤销fd上的所有请求， 包括poll */
+        PrepCancel_(fd);
+    }
+    else if (st.armed)
+    {
+        PrepPollRemove_(fd);
+    }
+    else
+    {
+        st.gen++;
+    }
+    st.events = 0;
+    SubmitIfForeign_();
+    return true;
+}
+
+/**
+ * @brief 在监听套接字上提交multishot accept
+ *
+ * 每个新连接产生一个完成事件， 结果为新连接的fd， 已设置SOCK_NONBLOCK
+ * 与SOCK_CLOEXEC。 出错时请求结束， 由调用方决定何时重新提交。
+ *
+ * @param listenFd
+ * @return true
+ * @return false
+ */
+bool UringPoller::Accept(int listenFd)
+{
+    if (listenFd < 0 || listenFd >= MAX_FD || !CompletionIO())
+        return false;
+    std::lock_guard<std::mutex> locker(mtx_);
+    PrepAccept_(listenFd);
+    SubmitIfForeign_();
+    return fds_[listenFd].io;
+}
+
+/**
+ * @brief 在连接上提交multishot recv
+ *
+ * 数据读入provided buffer， 在下一次Wait之前有效。 缓冲区暂时用尽或请求
+ * 意外结束时自动重新提交； 对端关闭(结果为0)或出错时请求结束。
+ *
+ * @param fd
+ * @return true
+ * @return false
+ */
+bool UringPoller::Recv(int fd)
+{
+    if (fd < 0 || fd >= MAX_FD || !CompletionIO())
+        return false;
+    std::lock_guard<std::mutex> locker(mtx_);
+    PrepRecv_(fd);
+    SubmitIfForeign_();
+    return fds_[fd].io;
+}
+
+/**
+ * @brief 提交一个SENDMSG请求， 在下一次Wait时与其他请求一起提交
+ *
+ * msg本身在提交时由内核复制， 其指向的数据须保持有效直到完成事件返回。
+ * 同一连接同时只应有一个发送请求。
+ *
+ * @param fd
+ * @param msg
+ * @param flags sendmsg的flags
+ * @return true
+ * @return false
+ */
+bool UringPoller::Send(int fd, const struct msghdr *msg, int flags)
+{
+    if (fd < 0 || fd >= MAX_FD || !CompletionIO())
+        return false;
+    std::lock_guard<std::mutex> locker(mtx_);
+    FdState &st = fds_[fd];
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_SENDMSG;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(msg);
+    sqe.len = 1;
+    sqe.msg_flags = static_cast<uint32_t>(flags);
+    sqe.user_data = UserData_(fd, st.ioGen, SEND);
+    if (!PushSqe_(sqe))
+    {
+        return false;
+    }
+    st.io = true;
+    SubmitIfForeign_();
+    return true;
+}
+
+/**
+ * @brief 提交本轮积累的请求并等待事件
+ *
+ * @param timeoutMs
+ * @return int 就绪的文件描述符数量
+ */
+int UringPoller::Wait(int timeoutMs)
+{
+    unsigned toSubmit;
+    {
+        std::lock_guard<std::mutex> locker(mtx_);
+        loopThread_ = std::this_thread::get_id();
+        /* 上一轮交给调用方的数据已处理完 */
+        for (uint16_t bid : usedBufs_)
+        {
+            RecycleBuf_(bid);
+        }
+        usedBufs_.clear();
+        for (const Rearm &r : rearmIo_)
+        {
+            if (fds_[r.fd].io && fds_[r.fd].ioGen == r.ioGen)
+            {
+                r.op == ACCEPT ? PrepAccept_(r.fd) : PrepRecv_(r.fd);
+            }
+        }
+        rearmIo_.clear();
+        for (int fd : rearm_)
+        {
+            if (fds_[fd].events && !fds_[fd].armed)
+            {
+                PrepPollAdd_(fd);
+            }
+        }
+        rearm_.clear();
+        toSubmit = *sqTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    }
+    /* 完成队列中已有事件时只提交不等待 */
+    unsigned ready = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) - *cqHead_;
+    int ret = Enter_(toSubmit, ready ? 0 : 1, timeoutMs);
+    if (ret < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN &&
+        errno != EBUSY)
+    {
+        return -1;
+    }
+    return Harvest_();
+}
+
+/**
+ * @brief 获取事件的文件描述符
+ *
+ * @param i
+ * @return int
+ */
+int UringPoller::GetEventFd(size_t i) const
+{
+    assert(i < events_.size());
+    return events_[i].fd;
+}
+
+/**
+ * @brief 获取事件的类型
+ *
+ * @param i
+ * @return uint32_t
+ */
+uint32_t UringPoller::GetEvents(size_t i) const
+{
+    assert(i < events_.size());
+    return events_[i].events;
+}
+
+/**
+ * @brief 获取事件对应的请求类型
+ *
+ * @param i
+ * @return UringPoller::OP 就绪事件为POLL
+ */
+UringPoller::OP UringPoller::GetOp(size_t i) const
+{
+    assert(i < events_.size());
+    return events_[i].op;
+}
+
+/**
+ * @brief 获取完成事件的结果， 出错时为负的错误码
+ *
+ * @param i
+ * @return int
+ */
+int UringPoller::GetResult(size_t i) const
+{
+    assert(i < events_.size());
+    return events_[i].res;
+}
+
+/**
+ * @brief 获取RECV完成事件读取的数据， 在下一次Wait之前有效
+ *
+ * @param i
+ * @return const char*
+ */
+const char *UringPoller::GetData(size_t i) const
+{
+    assert(i < events_.size());
+    return events_[i].data;
+}
+
+/**
+ * @brief 事件返回后fd是否已被删除， 本轮之后的事件需要丢弃
+ *
+ * 只在事件循环线程调用。
+ *
+ * @param i
+ * @return true
+ * @return false
+ */
+bool UringPoller::IsExpired(size_t i) const
+{
+    assert(i < events_.size());
+    const Event &e = events_[i];
+    const FdState &st = fds_[e.fd];
+    return e.gen != ((e.op == POLL ? st.gen : st.ioGen) & GEN_MASK);
+}
+
+/**
+ * @brief 将请求写入提交队列(需持有mtx_)
+ *
+ * @param sqe
+ * @return true
+ * @return false 提交队列已满且无法腾出空间
+ */
+bool UringPoller::PushSqe_(const io_uring_sqe &sqe)
+{
+    unsigned tail = *sqTail_;
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    if (tail - head >= sqEntries_)
+    {
+        /* 提交队列已满， 先交给内核 */
+        Enter_(tail - head, 0, -1);
+        head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (tail - head >= sqEntries_)
+        {
+            return false;
+        }
+    }
+    unsigned idx = tail & *sqMask_;
+    sqes_[idx] = sqe;
+    sqArray_[idx] = idx;
+    /* 先填好请求再发布队尾 */
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief 为fd提交poll请求(需持有mtx_)
+ *
+ * @param fd
+ */
+void UringPoller::PrepPollAdd_(int fd)
+{
+    FdState &st = fds_[fd];
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = fd;
+    sqe.poll32_events = st.events & (EPOLLIN | EPOLLOUT | EPOLLPRI |
+                                     EPOLLRDHUP | EPOLLERR | EPOLLHUP);
+    /* 边沿触发使用multishot， 否则为单次poll */
+    if ((st.events & EPOLLET) && !(st.events & EPOLLONESHOT))
+    {
+        sqe.len = IORING_POLL_ADD_MULTI;
+    }
+    sqe.user_data = UserData_(fd, st.gen);
+    st.armed = PushSqe_(sqe);
+}
+
+/**
+ * @brief 撤销fd当前的poll请求(需持有mtx_)
+ *
+ * @param fd
+ */
+void UringPoller::PrepPollRemove_(int fd)
+{
+    FdState &st = fds_[fd];
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_POLL_REMOVE;
+    sqe.fd = -1;
+    sqe.addr = UserData_(fd, st.gen);
+    sqe.user_data = REMOVE_TAG;
+    PushSqe_(sqe);
+    st.gen++;
+    st.armed = false;
+}
+
+/**
+ * @brief 提交multishot accept(需持有mtx_)
+ *
+ * @param fd
+ */
+void UringPoller::PrepAccept_(int fd)
+{
+    FdState &st = fds_[fd];
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.fd = fd;
+    sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe.user_data = UserData_(fd, st.ioGen, ACCEPT);
+    if (PushSqe_(sqe))
+    {
+        st.io = true;
+    }
+}
+
+/**
+ * @brief 提交使用provided buffer的multishot recv(需持有mtx_)
+ *
+ * @param fd
+ */
+void UringPoller::PrepRecv_(int fd)
+{
+    FdState &st = fds_[fd];
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_RECV;
+    sqe.fd = fd;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags = IOSQE_BUFFER_SELECT;
+    sqe.buf_group = BUF_GROUP;
+    sqe.user_data = UserData_(fd, st.ioGen, RECV);
+    if (PushSqe_(sqe))
+    {
+        st.io = true;
+    }
+}
+
+/**
+ * @brief 撤销fd上的所有请求(需持有mtx_)
+ *
+ * 撤销在下一次提交时才生效， 之前的完成事件按代数丢弃。
+ *
+ * @param fd
+ */
+void UringPoller::PrepCancel_(int fd)
+{
+    FdState &st = fds_[fd];
+    io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.fd = fd;
+    sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    sqe.user_data = REMOVE_TAG;
+    PushSqe_(sqe);
+    st.gen++;
+    st.armed = false;
+    st.ioGen++;
+    st.io = false;
+}
+
+/**
+ * @brief 归还provided buffer(需持有mtx_)
+ *
+ * @param bid
+ */
+void UringPoller::RecycleBuf_(uint16_t bid)
+{
+    if (!bufRing_)
+    {
+        io_uring_sqe sqe;
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe.fd = 1;
+        sqe.addr = reinterpret_cast<uint64_t>(bufs_.data() + static_cast<size_t>(bid) * BUF_SIZE);
+        sqe.len = BUF_SIZE;
+        sqe.off = bid;
+        sqe.buf_group = BUF_GROUP;
+        sqe.user_data = REMOVE_TAG;
+        PushSqe_(sqe);
+        return;
+    }
+    /* 队尾与第一项的resv重叠， 只能逐个字段赋值 */
+    uint16_t tail = bufRing_->tail;
+    io_uring_buf &buf = bufRing_->bufs[tail & (BUF_COUNT - 1)];
+    buf.addr = reinterpret_cast<uint64_t>(bufs_.data() + static_cast<size_t>(bid) * BUF_SIZE);
+    buf.len = BUF_SIZE;
+    buf.bid = bid;
+    __atomic_store_n(&bufRing_->tail, static_cast<uint16_t>(tail + 1), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 非事件循环线程立即提交(需持有mtx_)
+ *
+ */
+void UringPoller::SubmitIfForeign_()
+{
+    if (std::this_thread::get_id() != loopThread_)
+    {
+        Enter_(*sqTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE), 0, -1);
+    }
+}
+
+/**
+ * @brief 调用io_uring_enter提交请求并等待完成事件
+ *
+ * @param toSubmit 待提交的请求数
+ * @param minComplete 至少等待的完成事件数， 为0时只提交
+ * @param timeoutMs 等待超时时间， 小于0表示一直等待
+ * @return int
+ */
+int UringPoller::Enter_(unsigned toSubmit, unsigned minComplete, int timeoutMs)
+{
+    if (toSubmit == 0 && minComplete == 0)
+    {
+        return 0;
+    }
+    unsigned flags = 0;
+    io_uring_getevents_arg arg;
+    __kernel_timespec ts;
+    memset(&arg, 0, sizeof(arg));
+    if (minComplete > 0)
+    {
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        if (timeoutMs >= 0)
+        {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+    }
+    return static_cast<int>(syscall(__NR_io_uring_enter,
+                                    ringFd_,
+                                    toSubmit,
+                                    minComplete,
+                                    flags,
+                                    flags ? &arg : nullptr,
+                                    flags ? sizeof(arg) : 0));
+}
+
+/**
+ * @brief 收割完成队列
+ *
+ * 同一fd的多个就绪事件合并为一个， 完成语义请求的每个完成事件单独上报。
+ * 过期的完成事件丢弃， 但其中的缓冲区要归还， 接受的连接要关闭。
+ *
+ * @return int 事件数量
+ */
+int UringPoller::Harvest_()
+{
+    std::lock_guard<std::mutex> locker(mtx_);
+    eventCnt_ = 0;
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    while (head != tail && eventCnt_ < static_cast<int>(events_.size()))
+    {
+        const io_uring_cqe &cqe = cqes_[head & *cqMask_];
+        head++;
+        bool hasBuf = cqe.flags & IORING_CQE_F_BUFFER;
+        uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        bool more = cqe.flags & IORING_CQE_F_MORE;
+        OP op = static_cast<OP>(cqe.user_data >> 56);
+        int fd = static_cast<int>(static_cast<uint32_t>(cqe.user_data));
+        uint32_t gen = static_cast<uint32_t>(cqe.user_data >> 32) & GEN_MASK;
+        bool current = cqe.user_data != REMOVE_TAG && cqe.user_data != PROBE_TAG &&
+                       cqe.res != -ECANCELED &&
+                       gen == ((op == POLL ? fds_[fd].gen : fds_[fd].ioGen) & GEN_MASK);
+        if (!current)
+        {
+            if (hasBuf)
+            {
+                RecycleBuf_(bid);
+            }
+            if (op == ACCEPT && cqe.res >= 0 && cqe.user_data != REMOVE_TAG &&
+                cqe.user_data != PROBE_TAG)
+            {
+                /* 撤销之前已接受的连接 */
+                close(cqe.res);
+            }
+            continue;
+        }
+        FdState &st = fds_[fd];
+        if (op != POLL)
+        {
+            if (op != SEND && !more && (cqe.res > 0 || cqe.res == -ENOBUFS ||
+                                        (op == ACCEPT && cqe.res == 0)))
+            {
+                /* multishot请求因缓冲区用尽等原因结束， 连接仍然有效 */
+                rearmIo_.push_back({fd, op, st.ioGen});
+            }
+            if (cqe.res == -ENOBUFS)
+            {
+                continue;
+            }
+            const char *data = nullptr;
+            if (hasBuf)
+            {
+                data = bufs_.data() + static_cast<size_t>(bid) * BUF_SIZE;
+                usedBufs_.push_back(bid);
+            }
+            uint32_t events = op == SEND ? EPOLLOUT : EPOLLIN;
+            events_[eventCnt_++] = {fd, events, op, cqe.res, data, gen};
+            continue;
+        }
+        if (!more)
+        {
+            /* poll已结束， 除EPOLLONESHOT外都需要重新提交 */
+            st.armed = false;
+            if (!(st.events & EPOLLONESHOT))
+            {
+                rearm_.push_back(fd);
+            }
+        }
+        uint32_t revents =
+            cqe.res < 0 ? EPOLLERR : static_cast<uint32_t>(cqe.res);
+        int s = slot_[fd];
+        if (s >= 0 && s < eventCnt_ && events_[s].fd == fd && events_[s].op == POLL)
+        {
+            events_[s].events |= revents;
+        }
+        else
+        {
+            slot_[fd] = eventCnt_;
+            events_[eventCnt_++] = {fd, revents, POLL, 0, nullptr, gen};
+        }
+    }
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    return eventCnt_;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file uringpoller.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 基于io_uring的事件引擎声明
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#if !defined(URINGPOLLER_H)
+#define URINGPOLLER_H
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <mutex>
+#include <thread>
+
+#include "poller.h"
+
+/**
+ * @brief 基于io_uring的事件引擎
+ *
+ * 对外提供与Epoller相同的就绪接口。注册、修改、删除操作只写入提交队列，
+ * 在下一次Wait时与等待合并为一次io_uring_enter调用。
+ * EPOLLET映射为multishot poll， EPOLLONESHOT映射为单次poll，
+ * 水平触发通过每轮Wait自动重新提交单次poll实现。
+ * 其他线程调用时(线程池模式)立即提交， 避免Reactor阻塞在Wait中。
+ *
+ * CompletionIO为true时(需6.0+)还提供基于完成语义的请求， 供单线程的
+ * Reactor直接收发数据： 监听套接字使用multishot accept， 连接使用
+ * multishot recv从provided buffer中取缓冲区， 发送为SENDMSG请求，
+ * 与其他请求一起在下一次Wait时批量提交。 这些请求的完成事件同样由Wait
+ * 返回， 通过GetOp、GetResult、GetData取得结果， 每个完成事件单独上报。
+ */
+class UringPoller : public Poller
+{
+public:
+    explicit UringPoller(int maxEvent = 1024);
+    ~UringPoller() override;
+
+    /* 完成事件对应的请求 */
+    enum OP : uint8_t
+    {
+        POLL = 0, // 就绪事件
+        ACCEPT,   // 结果为新连接的fd
+        RECV,     // 结果为读取的字节数， 数据由GetData取得
+        SEND,     // 结果为发送的字节数
+    };
+
+    bool IsValid() const { return ringFd_ >= 0; }
+    bool CompletionIO() const { return !bufs_.empty(); }
+
+    bool AddFd(int fd, uint32_t events) override;
+    bool ModFd(int fd, uint32_t events) override;
+    bool DelFd(int fd) override;
+    int Wait(int timeoutMs = -1) override;
+    int GetEventFd(size_t i) const override;
+    uint32_t GetEvents(size_t i) const override;
+
+    bool Accept(int listenFd);
+    bool Recv(int fd);
+    bool Send(int fd, const struct msghdr *msg, int flags);
+    OP GetOp(size_t i) const;
+    int GetResult(size_t i) const;
+    const char *GetData(size_t i) const;
+    bool IsExpired(size_t i) const;
+
+    static const unsigned BUF_COUNT = 512; // provided buffer数量， 须为2的幂
+    static const unsigned BUF_SIZE = 4096; // 单个provided buffer大小
+
+private:
+    struct FdState
+    {
+        uint32_t events; // 注册的事件掩码
+        uint32_t gen;    // 代数， 用于丢弃过期的完成事件
+        bool armed;      // 内核中是否有生效的poll请求
+        uint32_t ioGen;  // 完成语义请求的代数
+        bool io;         // 是否提交过完成语义的请求
+    };
+
+    struct Event
+    {
+        int fd;
+        uint32_t events;
+        OP op;
+        int res;
+        const char *data;
+        uint32_t gen;
+    };
+
+    /* multishot请求意外结束， 需要在下一次Wait时重新提交 */
+    struct Rearm
+    {
+        int fd;
+        OP op;
+        uint32_t ioGen;
+    };
+
+    bool InitRing_(unsigned entries);
+    bool ProbeMultishot_();
+    void InitBufs_();
+    bool InitBufRing_();
+    bool ProbeRecv_();
+    void ReleaseRing_();
+
+    bool PushSqe_(const io_uring_sqe &sqe);
+    void PrepPollAdd_(int fd);
+    void PrepPollRemove_(int fd);
+    void PrepAccept_(int fd);
+    void PrepRecv_(int fd);
+    void PrepCancel_(int fd);
+    void RecycleBuf_(uint16_t bid);
+    void SubmitIfForeign_();
+    int Enter_(unsigned toSubmit, unsigned minComplete, int timeoutMs);
+    int Harvest_();
+
+    /* 高8位为请求类型， 其后24位为代数， 低32位为fd */
+    static uint64_t UserData_(int fd, uint32_t gen, OP op = POLL)
+    {
+        return (static_cast<uint64_t>(op) << 56) |
+               (static_cast<uint64_t>(gen & GEN_MASK) << 32) |
+               static_cast<uint32_t>(fd);
+    }
+
+    static const int MAX_FD = 65536;
+    static const uint32_t GEN_MASK = 0xFFFFFF;
+    static const uint16_t BUF_GROUP = 0;
+    static const uint64_t REMOVE_TAG = ~0ULL;
+    static const uint64_t PROBE_TAG = ~0ULL - 1;
+
+    int ringFd_;
+
+    /* 提交队列 */
+    void *sqRing_;
+    size_t sqRingSize_;
+    unsigned *sqHead_;
+    unsigned *sqTail_;
+    unsigned *sqMask_;
+    unsigned *sqArray_;
+    unsigned sqEntries_;
+    io_uring_sqe *sqes_;
+    size_t sqesSize_;
+
+    /* 完成队列 */
+    void *cqRing_;
+    size_t cqRingSize_;
+    unsigned *cqHead_;
+    unsigned *cqTail_;
+    unsigned *cqMask_;
+    io_uring_cqe *cqes_;
+
+    /* provided buffer， bufRing_为空时使用IORING_OP_PROVIDE_BUFFERS */
+    io_uring_buf_ring *bufRing_;
+    size_t bufRingSize_;
+    std::vector<char> bufs_;
+    std::vector<uint16_t> usedBufs_; // 本轮交给调用方的缓冲区， 下一次Wait时归还
+
+    std::mutex mtx_; // 保护提交队列及fd状态
+    std::thread::id loopThread_;
+
+    std::vector<FdState> fds_;
+    std::vector<int> slot_;       // fd在本轮events_中的位置
+    std::vector<int> rearm_;      // poll已结束、需要重新提交的fd
+    std::vector<Rearm> rearmIo_;
+    std::vector<Event> events_;
+    int eventCnt_;
+};
+
+#endif // URINGPOLLER_H
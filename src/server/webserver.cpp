@@ -44,10 +44,16 @@ WebServer::WebServer(int port,
 , openLinger_(OptLinger)
 , timeoutMS_(timeoutMS)
 , isClose_(false)
-, timer_(new HeapTimer())
-, epoller_(new Epoller())
-, threadpool_(new ThreadPool(threadNum))
+, users_(MaxConn_())
 {
+    /* 在创建任何线程之前屏蔽SIGUSR2， 由WaitUpgrade_线程同步等待 */
+    sigset_t upgradeSig;
+    sigemptyset(&upgradeSig);
+    sigaddset(&upgradeSig, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &upgradeSig, nullptr);
+    /* sendfile不能带MSG_NOSIGNAL， 对端已重置时由返回的EPIPE处理 */
+    signal(SIGPIPE, SIG_IGN);
+
     /* 解析resouces目录位置*/
     char exePath[256] = {0};
     ssize_t len = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
@@ -64,8 +70,50 @@ WebServer::WebServer(int port,
     SqlConnPool::Instance()->Init(
         "localhost", sqlPort, sqlUser, sqlPwd, dbName, connPoolNum);
 
+    /* 读取并发模型， 缺省为单Reactor */
+    auto &cfg = configMgr::Instance();
+    model_ = ParseModel_(cfg["server"]["model"]("single-reactor"));
+    engine_ = ParseEngine_(cfg["server"]["engine"]("epoll"));
+    timerType_ = ParseTimer_(cfg["server"]["timer"]("heap"));
+    timerTickMS_ = std::max(1, cfg["server"]["timerTickMS"](1));
+    lazyTimeout_ = cfg["server"]["lazyTimeout"](false);
+    listenOpts_.backlog = cfg["server"]["backlog"](listenOpts_.backlog);
+    listenOpts_.deferAcceptSec =
+        cfg["server"]["deferAcceptSec"](listenOpts_.deferAcceptSec);
+    listenOpts_.fastOpenQueue =
+        cfg["server"]["fastOpenQueue"](listenOpts_.fastOpenQueue);
+    listenOpts_.acceptBudget =
+        std::max(1, cfg["server"]["acceptBudget"](listenOpts_.acceptBudget));
+    drainTimeoutMS_ = std::max(0, cfg["server"]["drainTimeoutMS"](30000));
+    HttpRequest::uploadDir = cfg["server"]["uploadDir"](HttpRequest::uploadDir);
+    HttpRequest::maxUpload =
+        static_cast<size_t>(std::max(0, cfg["server"]["maxUploadMB"](16))) << 20;
+    /* 空闲连接由定时器在timeoutMS后关闭， Keep-Alive首部如实公布 */
+    HttpConn::keepAliveMax = std::max(0, cfg["server"]["keepAliveMax"](1000));
+    HttpConn::keepAliveTimeout = timeoutMS > 0 ? timeoutMS / 1000 : 0;
+    HttpResponse::sendfileThreshold = cfg["server"]["sendfileThreshold"](0);
+    /* 缓存resources下的文件， 由inotify通知文件变化 */
+    FileCache::Instance()->Init(
+        static_cast<size_t>(std::max(0, cfg["server"]["fileCacheMB"](64))) << 20);
+    /* 可压缩的文件按Accept-Encoding发送.gz/.br文件或压缩一次后缓存的内容 */
+    FileCache::Instance()->SetCompress(
+        std::max(0, cfg["server"]["compressMinSize"](1024)),
+        cfg["server"]["compressTypes"](std::string(
+            "text/html,text/css,text/javascript,text/plain,text/xml,"
+            "application/xhtml+xml,application/json,image/svg+xml")));
+    HttpResponse::SetCacheControl(
+        cfg["server"]["cacheControl"](std::string(".html:no-cache")));
+    if (!FileCache::Instance()->Watch(srcDir_))
+    {
+        LOG_WARN("Watch %s error, static files are not cached", srcDir_);
+    }
+    if (model_ == ServerModel::THREAD_POOL)
+    {
+        threadpool_ = std::make_unique<ThreadPool>(threadNum);
+    }
+
     InitEventMode_(trigMode);
-    if (!InitSocket_())
+    if (!InitReactors_(model_ == ServerModel::MULTI_REACTOR ? threadNum : 1))
     {
         isClose_ = true;
     }
@@ -91,13 +139,38 @@ WebServer::WebServer(int port,
             LOG_INFO("Listen Mode: %s, OpenConn Mode: %s",
                      (listenEvent_ & EPOLLET ? "ET" : "LT"),
                      (connEvent_ & EPOLLET ? "ET" : "LT"));
+            LOG_INFO("Server model: %s, Reactor num: %d, Engine: %s",
+                     ModelName_(model_),
+                     static_cast<int>(reactors_.size()),
+                     (engine_ == EventEngine::IO_URING ? "io_uring" : "epoll"));
+            LOG_INFO("Timer: %s, TickMS: %d, LazyTimeout: %s",
+                     (timerType_ == TimerType::WHEEL ? "wheel" : "heap"),
+                     timerTickMS_,
+                     (lazyTimeout_ ? "true" : "false"));
+            LOG_INFO("MaxConn: %d, Backlog: %d, DeferAccept: %ds, "
+                     "FastOpen: %d, AcceptBudget: %d",
+                     static_cast<int>(users_.size()),
+                     listenOpts_.backlog,
+                     listenOpts_.deferAcceptSec,
+                     listenOpts_.fastOpenQueue,
+                     listenOpts_.acceptBudget);
             LOG_INFO("LogSys level: %d", logLevel);
             LOG_INFO("srcDir: %s", HttpConn::srcDir);
             LOG_INFO("SqlConnPool num: %d, ThreadPool num: %d",
                      connPoolNum,
                      threadNum);
+            LOG_INFO("KeepAliveMax: %d, KeepAliveTimeout: %ds, "
+                     "SendfileThreshold: %ld",
+                     HttpConn::keepAliveMax,
+                     HttpConn::keepAliveTimeout,
+                     HttpResponse::sendfileThreshold);
+            LOG_INFO("DrainTimeoutMS: %d, Upgraded: %s",
+                     drainTimeoutMS_,
+                     (upgrader_.InheritedFds().empty() ? "false" : "true"));
         }
     }
+    /* 由旧进程启动时， 初始化完成后通知其停止接受连接 */
+    upgrader_.NotifyReady(!isClose_);
 }
 
 /**
@@ -106,7 +179,7 @@ WebServer::WebServer(int port,
  */
 WebServer::~WebServer()
 {
-    close(listenFd_);
+    reactors_.clear();
     isClose_ = true;
     delete[] srcDir_;
     SqlConnPool::Instance()->ClosePool();
@@ -179,133 +252,203 @@ WebServer::getServerConfig()
                            logQueSize);
 }
 
+/**
+ * @brief 注册路由， 需在Start之前调用
+ *
+ * @param method 请求方法
+ * @param pattern 路径模式， 如/user/:id， 或/files/后接通配符*path
+ * @param handler
+ */
+void WebServer::Route(const std::string &method,
+                      const std::string &pattern,
+                      Router::Handler handler)
+{
+    HttpRequest::router.Add(method, pattern, std::move(handler));
+}
+
+/**
+ * @brief 将目录挂载到指定前缀下， GET prefix/xxx 响应 dir/xxx
+ *
+ * @param prefix 路径前缀
+ * @param dir 目录
+ */
+void WebServer::Mount(const std::string &prefix, const std::string &dir)
+{
+    std::string pattern = prefix;
+    if (pattern.empty() || pattern.back() != '/')
+    {
+        pattern += '/';
+    }
+    FileCache::Instance()->Watch(dir);
+    HttpRequest::router.Add(
+        "GET", pattern + "*file", [dir](HttpRequest &request, HttpResponse &response) {
+            std::string_view file = request.GetParam("file");
+            /* 不允许访问挂载目录之外的文件 */
+            if (file.find("..") != std::string_view::npos)
+            {
+                response.SetPath("/403.html");
+                response.SetCode(403);
+                return;
+            }
+            response.SetFile(dir, "/" + std::string(file));
+        });
+}
+
 /**
  * @brief 启动web服务器
  * 
  */
 void WebServer::Start()
 {
-    int timeMS = -1; // epoll wait timeout
-    if (!isClose_)
+    if (isClose_)
+    {
+        return;
+    }
+    LOG_INFO("========== Server start ==========");
+    std::thread upgrade(&WebServer::WaitUpgrade_, this);
+    /* 除第一个Reactor外， 其余Reactor各自运行在独立线程中 */
+    std::vector<std::thread> loops;
+    for (size_t i = 1; i < reactors_.size(); i++)
     {
-        LOG_INFO("========== Server start ==========");
+        loops.emplace_back(&Reactor::Loop, reactors_[i].get());
     }
+    reactors_[0]->Loop();
+    for (auto &t : loops)
+    {
+        t.join();
+    }
+    isClose_ = true;
+    pthread_kill(upgrade.native_handle(), SIGUSR2);
+    upgrade.join();
+    LOG_INFO("========== Server stop ==========");
+}
+
+/**
+ * @brief 等待SIGUSR2并执行热升级
+ *
+ * 新进程接管监听套接字后， 本进程停止接受连接， 排空已有连接后退出；
+ * 升级失败时继续服务。
+ */
+void WebServer::WaitUpgrade_()
+{
+    sigset_t upgradeSig;
+    sigemptyset(&upgradeSig);
+    sigaddset(&upgradeSig, SIGUSR2);
     while (!isClose_)
     {
-        if (timeoutMS_ > 0)
+        int sig = 0;
+        if (sigwait(&upgradeSig, &sig) != 0 || isClose_)
         {
-            timeMS = timer_->GetNextTick();
+            continue;
         }
-        int eventCnt = epoller_->Wait(timeMS);
-        for (int i = 0; i < eventCnt; i++)
+        LOG_INFO("========== Server upgrade ==========");
+        std::vector<int> listenFds;
+        for (auto &reactor : reactors_)
         {
-            int fd = epoller_->GetEventFd(i);
-            uint32_t events = epoller_->GetEvents(i);
-            if (fd == listenFd_)
-            {
-                // 处理监听事件 接受连接
-                DealListen_();
-            }
-            else if (events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
-            {
-                // 处理错误 关闭连接
-                assert(users_.count(fd) > 0);
-                CloseConn_(&users_[fd]);
-            }
-            else if (events & EPOLLIN)
-            {
-                // 处理读事件
-                assert(users_.count(fd) > 0);
-                OnRead_(&users_[fd]);
-            }
-            else if (events & EPOLLOUT)
-            {
-                // 处理写事件
-                assert(users_.count(fd) > 0);
-                OnWrite_(&users_[fd]);
-            }
-            else
-            {
-                LOG_ERROR("Unexpected event");
-            }
+            listenFds.push_back(reactor->ListenFd());
+        }
+        if (upgrader_.Spawn(listenFds, UPGRADE_READY_TIMEOUT_MS))
+        {
+            Drain_();
+            return;
         }
     }
 }
 
 /**
- * @brief 初始化网络套接字
- * 
- * @return true 
- * @return false 
+ * @brief 停止接受连接， 等待已有连接处理完毕或超时后停止所有Reactor
+ *
  */
-bool WebServer::InitSocket_()
+void WebServer::Drain_()
 {
-    int ret;
-    struct sockaddr_in addr;
-    if (port_ > 65535 || port_ < 1024)
+    HttpConn::isDraining = true;
+    for (auto &reactor : reactors_)
     {
-        LOG_ERROR("Port:%d error!", port_);
-        return false;
+        reactor->StopListen();
     }
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = htonl(INADDR_ANY);
-    addr.sin_port = htons(port_);
-    struct linger optLinger = {0};
-    if (openLinger_)
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(drainTimeoutMS_);
+    /* 先等待各Reactor真正关闭监听套接字， 期间仍可能接受新连接 */
+    auto listening = [this]() {
+        return std::any_of(reactors_.begin(), reactors_.end(), [](auto &r) {
+            return r->IsListening();
+        });
+    };
+    while ((listening() || HttpConn::userCount > 0) &&
+           std::chrono::steady_clock::now() < deadline)
     {
-        optLinger.l_onoff = 1;
-        optLinger.l_linger = 1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
-    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (listenFd_ < 0)
-    {
-        LOG_ERROR("Create socket error!", port_);
-        return false;
-    }
-    ret = setsockopt(
-        listenFd_, SOL_SOCKET, SO_LINGER, &optLinger, sizeof(optLinger));
-    if (ret < 0)
-    {
-        close(listenFd_);
-        LOG_ERROR("Init linger error!");
-        return false;
-    }
-    int optval = 1;
-    ret = setsockopt(listenFd_,
-                     SOL_SOCKET,
-                     SO_REUSEADDR,
-                     (const void *)&optval,
-                     sizeof(int));
-    if (ret == -1)
+    LOG_INFO("Drain finished, userCount:%d",
+             static_cast<int>(HttpConn::userCount));
+    isClose_ = true;
+    for (auto &reactor : reactors_)
     {
-        close(listenFd_);
-        LOG_ERROR("Set reuse address error!");
-        return false;
+        reactor->Stop();
     }
-    ret = bind(listenFd_, (struct sockaddr *)&addr, sizeof(addr));
-    if (ret < 0)
+}
+
+/**
+ * @brief 创建并初始化Reactor
+ * 
+ * @param reactorNum Reactor数量， 大于1时开启SO_REUSEPORT
+ * @return true 
+ * @return false 
+ */
+bool WebServer::InitReactors_(int reactorNum)
+{
+    assert(reactorNum > 0);
+    bool reusePort = reactorNum > 1;
+    const std::vector<int> &inherited = upgrader_.InheritedFds();
+    for (size_t i = reactorNum; i < inherited.size(); i++)
     {
-        close(listenFd_);
-        LOG_ERROR("Bind Port:%d error!", port_);
-        return false;
+        /* 新配置的Reactor数量变少， 多余的监听套接字关闭后由其余套接字接收连接 */
+        LOG_WARN("Close extra inherited listen fd %d", inherited[i]);
+        close(inherited[i]);
     }
-    ret = listen(listenFd_, 6);
-    if (ret < 0)
+    for (int i = 0; i < reactorNum; i++)
     {
-        close(listenFd_);
-        LOG_ERROR("Listen port:%d error!", port_);
-        return false;
+        auto reactor = std::make_unique<Reactor>(port_,
+                                                 timeoutMS_,
+                                                 openLinger_,
+                                                 listenEvent_,
+                                                 connEvent_,
+                                                 reusePort,
+                                                 listenOpts_,
+                                                 users_,
+                                                 engine_,
+                                                 threadpool_.get(),
+                                                 timerType_,
+                                                 timerTickMS_,
+                                                 lazyTimeout_);
+        int inheritedFd =
+            static_cast<size_t>(i) < inherited.size() ? inherited[i] : -1;
+        if (!reactor->InitSocket(inheritedFd))
+        {
+            reactors_.clear();
+            return false;
+        }
+        reactors_.push_back(std::move(reactor));
     }
-    ret = epoller_->AddFd(listenFd_, listenEvent_ | EPOLLIN);
-    if (ret == 0)
+    return true;
+}
+
+/**
+ * @brief 连接表大小
+ *
+ * 取进程可打开的文件描述符上限， 但不超过Reactor::MAX_FD。
+ *
+ * @return int
+ */
+int WebServer::MaxConn_()
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) < 0 || limit.rlim_cur == RLIM_INFINITY)
     {
-        close(listenFd_);
-        LOG_ERROR("Add listen error!");
-        return false;
+        return Reactor::MAX_FD;
     }
-    SetFdNonblock(listenFd_);
-    LOG_INFO("Server port:%d", port_);
-    return true;
+    return static_cast<int>(
+        std::min<rlim_t>(limit.rlim_cur, Reactor::MAX_FD));
 }
 
 /**
@@ -316,7 +459,12 @@ bool WebServer::InitSocket_()
 void WebServer::InitEventMode_(int trigMode)
 {
     listenEvent_ = EPOLLRDHUP; // 被挂断事件
-    connEvent_ = EPOLLONESHOT | EPOLLRDHUP; // 保证多线程下只有一个线程处理一个连接
+    connEvent_ = EPOLLRDHUP;
+    if (model_ == ServerModel::THREAD_POOL)
+    {
+        /* 保证多线程下只有一个线程处理一个连接 */
+        connEvent_ |= EPOLLONESHOT;
+    }
     switch (trigMode)
     {
     case 0:
@@ -337,207 +485,68 @@ void WebServer::InitEventMode_(int trigMode)
     // 默认：ET + ET
     default:
         listenEvent_ |= EPOLLET;
-        connEvent_ = EPOLLET;
+        connEvent_ |= EPOLLET;
         break;
     }
     HttpConn::isET = (connEvent_ & EPOLLET);
 }
 
 /**
- * @brief 添加一个客户端连接
+ * @brief 解析并发模型
  * 
- * @param fd 
- * @param addr 
+ * @param model 配置文件中的模型名称
+ * @return ServerModel 
  */
-void WebServer::AddClient_(int fd, sockaddr_in addr)
+ServerModel WebServer::ParseModel_(const std::string &model)
 {
-    assert(fd > 0);
-    users_[fd].init(fd, addr);
-    if (timeoutMS_ > 0)
-    {
-        timer_->add(fd,
-                    timeoutMS_,
-                    std::bind(&WebServer::CloseConn_, this, &users_[fd]));
-    }
-    // 绑定客户端的读事件和触发模式
-    epoller_->AddFd(fd, EPOLLIN | connEvent_);
-    // 将文件描述符设置为非阻塞
-    SetFdNonblock(fd);
-    LOG_INFO("Client[%d] in!", users_[fd].getFd());
-}
-
-/**
- * @brief 接受连接
- * 
- */
-void WebServer::DealListen_()
-{
-    struct sockaddr_in addr;
-    socklen_t len = sizeof(addr);
-    do
-    {
-        int fd = accept(listenFd_, (struct sockaddr *)&addr, &len);
-        if (fd <= 0)
-        {
-            return;
-        }
-        else if (HttpConn::userCount >= MAX_FD)
-        {
-            SendError_(fd, "Server busy!");
-            LOG_WARN("Clients is full!");
-            return;
-        }
-        AddClient_(fd, addr);
-    } while (listenEvent_ & EPOLLET);
-}
-
-/**
- * @brief 处理写事件
- * 
- * @param client 
- */
-void WebServer::DealWrite_(HttpConn *client)
-{
-    assert(client);
-    ExtentTime_(client);
-    threadpool_->AddTask(std::bind(&WebServer::OnWrite_, this, client));
-}
-
-/**
- * @brief 处理读事件
- * 
- * @param client 
- */
-void WebServer::DealRead_(HttpConn *client)
-{
-    assert(client);
-    ExtentTime_(client);
-    threadpool_->AddTask(std::bind(&WebServer::OnRead_, this, client));
-}
-
-/**
- * @brief 发送错误信息
- * 
- * @param fd 
- * @param info 
- */
-void WebServer::SendError_(int fd, const char *info)
-{
-    assert(fd > 0);
-    int ret = send(fd, info, strlen(info), 0);
-    if (ret < 0)
-    {
-        LOG_WARN("send error to client[%d] error!", fd);
-    }
-    close(fd);
-}
-
-/**
- * @brief 延长客户端连接时间
- * 
- * @param client 
- */
-void WebServer::ExtentTime_(HttpConn *client)
-{
-    assert(client);
-    if (timeoutMS_ > 0)
-    {
-        timer_->adjust(client->getFd(), timeoutMS_);
-    }
-}
-
-/**
- * @brief 关闭与客户端的连接
- * 
- * @param client 
- */
-void WebServer::CloseConn_(HttpConn *client)
-{
-    assert(client);
-    LOG_INFO("Client[%d] quit!", client->getFd());
-    epoller_->DelFd(client->getFd());
-    client->Close();
-}
-
-/**
- * @brief 处理读事件
- * 
- * @param client 
- */
-void WebServer::OnRead_(HttpConn *client)
-{
-    assert(client);
-    int ret = -1;
-    int readErrno = 0;
-    ret = client->read(&readErrno);
-    // 读失败且错误码不是EAGAIN 说明对端关闭连接
-    if (ret <= 0 && readErrno != EAGAIN)
-    {
-        CloseConn_(client);
-        return;
-    }
-    OnProcess(client);
+    if (model == "multi-reactor")
+        return ServerModel::MULTI_REACTOR;
+    if (model == "thread-pool")
+        return ServerModel::THREAD_POOL;
+    return ServerModel::SINGLE_REACTOR;
 }
 
 /**
- * @brief 处理写事件
+ * @brief 获取并发模型名称
  * 
- * @param client 
+ * @param model 
+ * @return const char* 
  */
-void WebServer::OnWrite_(HttpConn *client)
+const char *WebServer::ModelName_(ServerModel model)
 {
-    assert(client);
-    int ret = -1;
-    int writeErrno = 0;
-    ret = client->write(&writeErrno);
-    if (client->ToWriteBytes() == 0)
-    {
-        // 传输完成
-        if (client->isKeepAlive())
-        {
-            OnProcess(client);
-            return;
-        }
-    }
-    else if (ret < 0)
+    switch (model)
     {
-        if (writeErrno == EAGAIN)
-        {
-            // 继续传输
-            epoller_->ModFd(client->getFd(), connEvent_ | EPOLLOUT);
-            return;
-        }
+    case ServerModel::MULTI_REACTOR:
+        return "multi-reactor";
+    case ServerModel::THREAD_POOL:
+        return "thread-pool";
+    default:
+        return "single-reactor";
     }
-    CloseConn_(client);
 }
 
 /**
- * @brief 处理客户端请求
+ * @brief 解析事件引擎
  * 
- * @param client 
+ * @param engine 配置文件中的引擎名称
+ * @return EventEngine 
  */
-void WebServer::OnProcess(HttpConn *client)
+EventEngine WebServer::ParseEngine_(const std::string &engine)
 {
-    if (client->process())
-    {
-        /* 处理请求成功， 绑定写就绪事件 */
-        epoller_->ModFd(client->getFd(), connEvent_ | EPOLLOUT);
-    }
-    else
-    {
-        /* 处理请求失败， 需要继续读取*/
-        epoller_->ModFd(client->getFd(), connEvent_ | EPOLLIN);
-    }
+    if (engine == "io_uring")
+        return EventEngine::IO_URING;
+    return EventEngine::EPOLL;
 }
 
 /**
- * @brief 设置文件描述符为非阻塞
- * 
- * @param fd 
- * @return int 
+ * @brief 解析定时器类型
+ *
+ * @param timer 配置文件中的定时器名称
+ * @return TimerType
  */
-int WebServer::SetFdNonblock(int fd)
+TimerType WebServer::ParseTimer_(const std::string &timer)
 {
-    assert(fd > 0);
-    return fcntl(fd, F_SETFL, fcntl(fd, F_GETFD, 0) | O_NONBLOCK);
+    if (timer == "wheel")
+        return TimerType::WHEEL;
+    return TimerType::HEAP;
 }
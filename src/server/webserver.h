@@ -12,23 +12,38 @@
 #if !defined(WEBSERVER_H)
 #define WEBSERVER_H
 
-#include <unordered_map>
+#include <vector>
+#include <thread>
 #include <fcntl.h>
 #include <unistd.h>
 #include <assert.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
+#include <sys/resource.h>
 #include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <signal.h>
+#include <pthread.h>
 
-#include "epoller.h"
+#include "reactor.h"
 #include "log.h"
-#include "heaptimer.h"
 #include "sqlconnpool.h"
 #include "threadpool.h"
 #include "sqlconnRAII.h"
 #include "httpconn.h"
 #include "configMgr.h"
+#include "upgrader.h"
+
+/**
+ * @brief 服务器并发模型
+ *
+ */
+enum class ServerModel
+{
+    SINGLE_REACTOR = 0, // 单线程事件循环
+    MULTI_REACTOR = 1,  // 每个线程一个事件循环， 通过SO_REUSEPORT分发连接
+    THREAD_POOL = 2,    // 主Reactor接受连接， 工作线程池处理读写
+};
 
 class WebServer
 {
@@ -64,49 +79,52 @@ public:
                       int>
     getServerConfig();
 
+    void Route(const std::string &method,
+               const std::string &pattern,
+               Router::Handler handler);
+    void Mount(const std::string &prefix, const std::string &dir);
+
     void Start();
 
 private:
-    bool InitSocket_();
-
-    void InitEventMode_(int trigMode);
-
-    void AddClient_(int fd, sockaddr_in addr);
-
-    void DealListen_();
-
-    void DealWrite_(HttpConn *client);
+    bool InitReactors_(int reactorNum);
 
-    void DealRead_(HttpConn *client);
+    static int MaxConn_();
 
-    void SendError_(int fd, const char *info);
-
-    void ExtentTime_(HttpConn *client);
+    void InitEventMode_(int trigMode);
 
-    void CloseConn_(HttpConn *client);
+    static ServerModel ParseModel_(const std::string &model);
 
-    void OnRead_(HttpConn *client);
+    static const char *ModelName_(ServerModel model);
 
-    void OnWrite_(HttpConn *client);
+    static EventEngine ParseEngine_(const std::string &engine);
 
-    void OnProcess(HttpConn *client);
+    static TimerType ParseTimer_(const std::string &timer);
 
-    static const int MAX_FD = 65536;
+    void WaitUpgrade_();
 
-    static int SetFdNonblock(int fd);
+    void Drain_();
 
     int port_;
     bool openLinger_;
     int timeoutMS_;
-    bool isClose_;
-    int listenFd_;
+    std::atomic<bool> isClose_;
     char *srcDir_;
     uint32_t listenEvent_;
     uint32_t connEvent_;
-    std::unique_ptr<HeapTimer> timer_;
+    ServerModel model_;
+    EventEngine engine_;
+    TimerType timerType_;
+    int timerTickMS_;
+    bool lazyTimeout_;
+    ListenOptions listenOpts_;
+    int drainTimeoutMS_;
+    Upgrader upgrader_; // 需在初始化Reactor之前接收旧进程的监听套接字
     std::unique_ptr<ThreadPool> threadpool_;
-    std::unique_ptr<Epoller> epoller_;
-    std::unordered_map<int, HttpConn> users_;
+    std::vector<HttpConn> users_; // 预分配的连接表， 需在reactors_之前构造
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+
+    static const int UPGRADE_READY_TIMEOUT_MS = 10000;
 };
 
 #endif // WEBSERVER_H
@@ -17,7 +17,7 @@
  */
 void HeapTimer::del_(size_t index)
 {
-    assert(!heap_.empty() && index >= 0 && index < heap_.size());
+    assert(!heap_.empty() && index < heap_.size());
     size_t i = index;
     size_t n = heap_.size() - 1;
     assert(i <= n);
@@ -40,22 +40,17 @@ void HeapTimer::del_(size_t index)
  */
 void HeapTimer::siftup_(size_t i)
 {
-    if (i == 0)
+    assert(i < heap_.size());
+    /* 到达根节点时停止， 超时时间相同的节点不交换 */
+    while (i > 0)
     {
-        return;
-    }
-    assert(i >= 0 && i < heap_.size());
-    size_t j = (i - 1) / 2;
-
-    while (j >= 0)
-    {
-        if (heap_[j] < heap_[i])
+        size_t j = (i - 1) / 2;
+        if (!(heap_[i] < heap_[j]))
         {
             break;
         }
         SwapNode_(i, j);
         i = j;
-        j = (i - 1) / 2;
     }
 }
 
@@ -69,8 +64,8 @@ void HeapTimer::siftup_(size_t i)
  */
 bool HeapTimer::siftdown_(size_t index, size_t n)
 {
-    assert(index >= 0 && index < heap_.size());
-    assert(n >= 0 && n <= heap_.size());
+    assert(index < heap_.size());
+    assert(n <= heap_.size());
     size_t i = index;
     size_t j = i * 2 + 1;
     while (j < n)
@@ -94,8 +89,8 @@ bool HeapTimer::siftdown_(size_t index, size_t n)
  */
 void HeapTimer::SwapNode_(size_t i, size_t j)
 {
-    assert(i >= 0 && i < heap_.size());
-    assert(j >= 0 && j < heap_.size());
+    assert(i < heap_.size());
+    assert(j < heap_.size());
     std::swap(heap_[i], heap_[j]);
     ref_[heap_[i].id] = i;
     ref_[heap_[j].id] = j;
@@ -110,7 +105,7 @@ void HeapTimer::SwapNode_(size_t i, size_t j)
 void HeapTimer::adjust(int id, int newExpires)
 {
     assert(!heap_.empty() && ref_.count(id) > 0);
-    heap_[ref_[id]].expires = Clock::now() + MS(newExpires);
+    heap_[ref_[id]].expires = now_ + MS(newExpires);
     siftdown_(ref_[id], heap_.size());
 }
 
@@ -130,14 +125,14 @@ void HeapTimer::add(int id, int timeOut, const TimeOutCallBack &cb)
         // 新节点：堆尾插入， 调整堆
         i = heap_.size();
         ref_[id] = i;
-        heap_.push_back({id, Clock::now() + MS(timeOut), cb});
+        heap_.push_back({id, now_ + MS(timeOut), cb});
         siftup_(i);
     }
     else
     {
         /* 已有节点： 调整堆*/
         i = ref_[id];
-        heap_[i].expires = Clock::now() + MS(timeOut);
+        heap_[i].expires = now_ + MS(timeOut);
         heap_[i].cb = cb;
         if (!siftdown_(i, heap_.size()))
         {
@@ -159,8 +154,22 @@ void HeapTimer::doWork(int id)
     }
     size_t i = ref_[id];
     TimerNode node = heap_[i];
-    node.cb();
     del_(i);
+    node.cb();
+}
+
+/**
+ * @brief 删除指定id节点，不调用回调函数
+ *
+ * @param id 待删除节点的id
+ */
+void HeapTimer::cancel(int id)
+{
+    if (heap_.empty() || ref_.count(id) == 0)
+    {
+        return;
+    }
+    del_(ref_[id]);
 }
 
 /**
@@ -186,13 +195,14 @@ void HeapTimer::tick()
     while (!heap_.empty())
     {
         TimerNode node = heap_.front();
-        if (std::chrono::duration_cast<MS>(node.expires - Clock::now())
-                .count() > 0)
+        /* 不提前到期， 与GetNextTick向上取整的等待时间一致 */
+        if (node.expires > now_)
         {
             break;
         }
-        node.cb();
+        /* 先出堆再回调， 回调中可以安全地重新添加定时器 */
         pop();
+        node.cb();
     }
 }
 
@@ -214,17 +224,16 @@ void HeapTimer::pop()
 int HeapTimer::GetNextTick()
 {
     tick();
-    size_t res = -1;
-    if (!heap_.empty())
+    if (heap_.empty())
     {
-        res =
-            std::chrono::duration_cast<MS>(heap_.front().expires - Clock::now())
-                .count();
-        if (res < 0)
-        {
-            res = 0;
-        }
+        return -1;
     }
-
-    return res;
+    /* 向上取整， 否则不足1ms的剩余时间会使epoll_wait立即返回而空转 */
+    int64_t res = std::chrono::ceil<MS>(heap_.front().expires - now_).count();
+    if (res < 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(
+        std::min<int64_t>(res, std::numeric_limits<int>::max()));
 }
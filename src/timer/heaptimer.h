@@ -15,14 +15,11 @@
 #include <unordered_map>
 #include <time.h>
 #include <algorithm>
-#include <functional>
+#include <limits>
+#include <stdint.h>
 #include <assert.h>
-#include <chrono>
 
-typedef std::function<void()> TimeOutCallBack;
-typedef std::chrono::high_resolution_clock Clock;
-typedef std::chrono::milliseconds MS;
-typedef Clock::time_point TimeStamp;
+#include "timer.h"
 
 struct TimerNode
 {
@@ -32,26 +29,28 @@ struct TimerNode
     bool operator<(const TimerNode &t) const { return expires < t.expires; }
 };
 
-class HeapTimer
+class HeapTimer : public Timer
 {
 public:
     HeapTimer() { heap_.reserve(64); }
 
-    ~HeapTimer() { clear(); }
+    ~HeapTimer() override { clear(); }
 
-    void adjust(int id, int newExpires);
+    void adjust(int id, int newExpires) override;
 
-    void add(int id, int timeOut, const TimeOutCallBack &cb);
+    void add(int id, int timeOut, const TimeOutCallBack &cb) override;
 
-    void doWork(int id);
+    void doWork(int id) override;
 
-    void clear();
+    void cancel(int id) override;
 
-    void tick();
+    void clear() override;
+
+    void tick() override;
 
     void pop();
 
-    int GetNextTick();
+    int GetNextTick() override;
 
 private:
     void del_(size_t index);
@@ -0,0 +1,29 @@
+/**
+ * @file timer.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 定时器工厂
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "timer.h"
+#include "heaptimer.h"
+#include "timingwheel.h"
+
+/**
+ * @brief 创建定时器
+ *
+ * @param type 定时器类型
+ * @param tickMs 时间轮的刻度(毫秒)， 小根堆忽略该参数
+ * @return std::unique_ptr<Timer>
+ */
+std::unique_ptr<Timer> Timer::Create(TimerType type, int tickMs)
+{
+    if (type == TimerType::WHEEL)
+    {
+        return std::make_unique<TimingWheel>(tickMs);
+    }
+    return std::make_unique<HeapTimer>();
+}
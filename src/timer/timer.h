@@ -0,0 +1,62 @@
+/**
+ * @file timer.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 定时器接口
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(TIMER_H)
+#define TIMER_H
+
+#include <functional>
+#include <chrono>
+#include <memory>
+
+typedef std::function<void()> TimeOutCallBack;
+typedef std::chrono::high_resolution_clock Clock;
+typedef std::chrono::milliseconds MS;
+typedef Clock::time_point TimeStamp;
+
+/**
+ * @brief 定时器类型
+ *
+ */
+enum class TimerType
+{
+    HEAP = 0,  // 小根堆
+    WHEEL = 1, // 分层时间轮
+};
+
+/**
+ * @brief 以id标识的超时定时器接口
+ *
+ * 同一id最多存在一个定时器， add对已存在的id等同于重设超时时间和回调。
+ * 所有操作都以缓存的当前时间为准， 由调用者在每轮事件循环中通过
+ * UpdateNow刷新一次， 避免每次操作都读取时钟。
+ */
+class Timer
+{
+public:
+    virtual ~Timer() = default;
+
+    void UpdateNow() { now_ = Clock::now(); }
+    TimeStamp Now() const { return now_; }
+
+    virtual void adjust(int id, int newExpires) = 0;
+    virtual void add(int id, int timeOut, const TimeOutCallBack &cb) = 0;
+    virtual void doWork(int id) = 0;
+    virtual void cancel(int id) = 0;
+    virtual void clear() = 0;
+    virtual void tick() = 0;
+    virtual int GetNextTick() = 0;
+
+    static std::unique_ptr<Timer> Create(TimerType type, int tickMs = 1);
+
+protected:
+    TimeStamp now_ = Clock::now(); // 缓存的当前时间
+};
+
+#endif // TIMER_H
@@ -0,0 +1,389 @@
+/**
+ * @file timingwheel.cpp
+ * @author xiaqy (792155443@qq.com)
+ * @brief 分层时间轮定时器实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#include "timingwheel.h"
+
+/**
+ * @brief Construct a new Timing Wheel:: Timing Wheel object
+ *
+ * @param tickMs 刻度(毫秒)， 即超时精度
+ */
+TimingWheel::TimingWheel(int tickMs)
+: tickMs_(tickMs > 0 ? tickMs : 1)
+, start_(now_)
+, cur_(0)
+, count_(0)
+, heads_(SLOT_NUM + 1, -1)
+, bitmap_((SLOT_NUM + 63) / 64, 0)
+{
+}
+
+/**
+ * @brief 调整指定id节点的超时时间
+ *
+ * 新的到期刻度仍落在原槽中时只更新刻度， 不改动链表。
+ *
+ * @param id 节点id
+ * @param newExpires 新的超时时间
+ */
+void TimingWheel::adjust(int id, int newExpires)
+{
+    if (id < 0 || static_cast<size_t>(id) >= nodes_.size() ||
+        nodes_[id].slot < 0)
+    {
+        return;
+    }
+    Node &node = nodes_[id];
+    uint64_t expires = ExpiresOf_(newExpires);
+    if (expires == node.expires && node.slot != EXPIRED_SLOT)
+    {
+        return;
+    }
+    node.expires = expires;
+    int slot = SlotOf_(expires);
+    if (slot != node.slot)
+    {
+        Unlink_(id);
+        Link_(id, slot);
+    }
+}
+
+/**
+ * @brief 添加新的超时节点， id已存在时重设超时时间和回调
+ *
+ * @param id
+ * @param timeOut
+ * @param cb 超时回调函数
+ */
+void TimingWheel::add(int id, int timeOut, const TimeOutCallBack &cb)
+{
+    assert(id >= 0);
+    if (static_cast<size_t>(id) >= nodes_.size())
+    {
+        nodes_.resize(id + 1);
+    }
+    nodes_[id].cb = cb;
+    if (nodes_[id].slot >= 0)
+    {
+        adjust(id, timeOut);
+        return;
+    }
+    if (count_ == 0)
+    {
+        /* 时间轮为空时直接对齐到当前刻度， 避免tick补转空槽 */
+        cur_ = std::max(cur_, NowTick_());
+    }
+    nodes_[id].expires = ExpiresOf_(timeOut);
+    Link_(id, SlotOf_(nodes_[id].expires));
+    count_++;
+}
+
+/**
+ * @brief 删除指定id节点，并调用回调函数
+ *
+ * @param id 待删除节点的id
+ */
+void TimingWheel::doWork(int id)
+{
+    if (id < 0 || static_cast<size_t>(id) >= nodes_.size() ||
+        nodes_[id].slot < 0)
+    {
+        return;
+    }
+    Unlink_(id);
+    count_--;
+    TimeOutCallBack cb = std::move(nodes_[id].cb);
+    nodes_[id].cb = nullptr;
+    cb();
+}
+
+/**
+ * @brief 删除指定id节点，不调用回调函数
+ *
+ * @param id 待删除节点的id
+ */
+void TimingWheel::cancel(int id)
+{
+    if (id < 0 || static_cast<size_t>(id) >= nodes_.size() ||
+        nodes_[id].slot < 0)
+    {
+        return;
+    }
+    Unlink_(id);
+    count_--;
+    nodes_[id].cb = nullptr;
+}
+
+/**
+ * @brief 清空时间轮
+ *
+ */
+void TimingWheel::clear()
+{
+    nodes_.clear();
+    std::fill(heads_.begin(), heads_.end(), -1);
+    std::fill(bitmap_.begin(), bitmap_.end(), 0);
+    count_ = 0;
+}
+
+/**
+ * @brief 超时处理函数， 逐个刻度推进到当前时间
+ *
+ */
+void TimingWheel::tick()
+{
+    uint64_t now = NowTick_();
+    while (count_ > 0 && cur_ <= now)
+    {
+        int index = cur_ & (ROOT_SIZE - 1);
+        if (index == 0)
+        {
+            /* 第0层转完一圈， 依次从上层级联 */
+            for (int level = 1; level < LEVELS; level++)
+            {
+                int i = (cur_ >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) &
+                        (LEVEL_SIZE - 1);
+                Cascade_(level, i);
+                if (i != 0)
+                {
+                    break;
+                }
+            }
+        }
+        /* 整槽移入到期链表后再回调， 回调中可以安全地增删定时器 */
+        for (int id = heads_[index]; id != -1; id = nodes_[id].next)
+        {
+            nodes_[id].slot = EXPIRED_SLOT;
+        }
+        heads_[EXPIRED_SLOT] = heads_[index];
+        heads_[index] = -1;
+        bitmap_[index >> 6] &= ~(1ULL << (index & 63));
+        cur_++;
+        while (heads_[EXPIRED_SLOT] != -1)
+        {
+            int id = heads_[EXPIRED_SLOT];
+            Unlink_(id);
+            count_--;
+            TimeOutCallBack cb = std::move(nodes_[id].cb);
+            nodes_[id].cb = nullptr;
+            cb();
+        }
+    }
+    if (count_ == 0 && cur_ <= now)
+    {
+        cur_ = now + 1;
+    }
+}
+
+/**
+ * @brief 获取距离下一次需要处理的时间
+ *
+ * 只在第0层和第1层中查找， 更远的节点最晚在第1层转完一圈时级联下来，
+ * 因此返回值是一个下界， 到时再重新计算。
+ *
+ * @return int 应该设置的定时器超时时间， 没有定时器时返回-1
+ */
+int TimingWheel::GetNextTick()
+{
+    tick();
+    if (count_ == 0)
+    {
+        return -1;
+    }
+    TimeStamp deadline = start_ + MS(NextExpires_() * tickMs_);
+    auto res = std::chrono::ceil<MS>(deadline - now_).count();
+    if (res < 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(
+        std::min<int64_t>(res, std::numeric_limits<int>::max()));
+}
+
+/**
+ * @brief 当前时间对应的刻度
+ *
+ * @return uint64_t
+ */
+uint64_t TimingWheel::NowTick_() const
+{
+    return std::chrono::duration_cast<MS>(now_ - start_).count() / tickMs_;
+}
+
+/**
+ * @brief 计算超时时间对应的到期刻度， 向上取整保证不会提前触发
+ *
+ * @param timeOut 超时时间(毫秒)
+ * @return uint64_t
+ */
+uint64_t TimingWheel::ExpiresOf_(int timeOut) const
+{
+    uint64_t elapsed = std::chrono::duration_cast<MS>(now_ - start_).count();
+    uint64_t expires =
+        (elapsed + std::max(timeOut, 0) + tickMs_ - 1) / tickMs_;
+    return std::max(expires, cur_);
+}
+
+/**
+ * @brief 根据到期刻度计算所在的槽
+ *
+ * @param expires 到期刻度
+ * @return int
+ */
+int TimingWheel::SlotOf_(uint64_t expires) const
+{
+    expires = std::max(expires, cur_);
+    uint64_t delta = expires - cur_;
+    if (delta < ROOT_SIZE)
+    {
+        return expires & (ROOT_SIZE - 1);
+    }
+    int base = ROOT_SIZE;
+    for (int level = 1; level < LEVELS; level++)
+    {
+        int shift = ROOT_BITS + (level - 1) * LEVEL_BITS;
+        uint64_t range = 1ULL << (shift + LEVEL_BITS);
+        if (delta < range || level == LEVELS - 1)
+        {
+            if (delta >= range)
+            {
+                /* 超出时间轮范围， 先放在最远处 */
+                expires = cur_ + range - 1;
+            }
+            return base + ((expires >> shift) & (LEVEL_SIZE - 1));
+        }
+        base += LEVEL_SIZE;
+    }
+    return -1;
+}
+
+/**
+ * @brief 查找[begin, end)范围内第一个非空槽
+ *
+ * @param begin
+ * @param end
+ * @return int 槽号， 没有时返回-1
+ */
+int TimingWheel::FindSlot_(int begin, int end) const
+{
+    int i = begin;
+    while (i < end)
+    {
+        uint64_t bits = bitmap_[i >> 6] >> (i & 63);
+        if (bits)
+        {
+            int slot = i + __builtin_ctzll(bits);
+            return slot < end ? slot : -1;
+        }
+        i = ((i >> 6) + 1) << 6;
+    }
+    return -1;
+}
+
+/**
+ * @brief 下一次可能有节点到期或级联的刻度
+ *
+ * @return uint64_t
+ */
+uint64_t TimingWheel::NextExpires_() const
+{
+    int index = cur_ & (ROOT_SIZE - 1);
+    int slot = FindSlot_(index, ROOT_SIZE);
+    if (slot >= 0)
+    {
+        return cur_ + (slot - index);
+    }
+    /* 第0层本圈已空， 下一次级联发生在第0层转完一圈时 */
+    uint64_t next = cur_ + (ROOT_SIZE - index);
+    if (FindSlot_(0, index) >= 0)
+    {
+        return next;
+    }
+    int index1 = (cur_ >> ROOT_BITS) & (LEVEL_SIZE - 1);
+    slot = FindSlot_(ROOT_SIZE + index1 + 1, ROOT_SIZE + LEVEL_SIZE);
+    if (slot >= 0)
+    {
+        return next +
+               static_cast<uint64_t>(slot - ROOT_SIZE - index1 - 1) * ROOT_SIZE;
+    }
+    return next + static_cast<uint64_t>(LEVEL_SIZE - 1 - index1) * ROOT_SIZE;
+}
+
+/**
+ * @brief 将节点挂到槽的链表头
+ *
+ * @param id
+ * @param slot
+ */
+void TimingWheel::Link_(int id, int slot)
+{
+    assert(slot >= 0 && slot <= EXPIRED_SLOT);
+    Node &node = nodes_[id];
+    node.prev = -1;
+    node.next = heads_[slot];
+    node.slot = slot;
+    if (node.next != -1)
+    {
+        nodes_[node.next].prev = id;
+    }
+    heads_[slot] = id;
+    if (slot < SLOT_NUM)
+    {
+        bitmap_[slot >> 6] |= 1ULL << (slot & 63);
+    }
+}
+
+/**
+ * @brief 将节点从所在槽中摘除
+ *
+ * @param id
+ */
+void TimingWheel::Unlink_(int id)
+{
+    Node &node = nodes_[id];
+    assert(node.slot >= 0);
+    if (node.prev != -1)
+    {
+        nodes_[node.prev].next = node.next;
+    }
+    else
+    {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != -1)
+    {
+        nodes_[node.next].prev = node.prev;
+    }
+    if (heads_[node.slot] == -1 && node.slot < SLOT_NUM)
+    {
+        bitmap_[node.slot >> 6] &= ~(1ULL << (node.slot & 63));
+    }
+    node.prev = node.next = node.slot = -1;
+}
+
+/**
+ * @brief 将上层某个槽中的节点重新放入时间轮
+ *
+ * @param level 层号， 从1开始
+ * @param index 槽在该层中的下标
+ */
+void TimingWheel::Cascade_(int level, int index)
+{
+    int slot = ROOT_SIZE + (level - 1) * LEVEL_SIZE + index;
+    int id = heads_[slot];
+    heads_[slot] = -1;
+    bitmap_[slot >> 6] &= ~(1ULL << (slot & 63));
+    while (id != -1)
+    {
+        int next = nodes_[id].next;
+        Link_(id, SlotOf_(nodes_[id].expires));
+        id = next;
+    }
+}
@@ -0,0 +1,89 @@
+/**
+ * @file timingwheel.h
+ * @author xiaqy (792155443@qq.com)
+ * @brief 分层时间轮定时器声明
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+#if !defined(TIMING_WHEEL_H)
+#define TIMING_WHEEL_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdint.h>
+#include <assert.h>
+
+#include "timer.h"
+
+/**
+ * @brief 分层时间轮
+ *
+ * 第0层256个槽， 每槽一个刻度； 其余3层各64个槽， 每槽覆盖下一层一整圈。
+ * 节点按id存放在数组中， 通过下标组成双向链表挂在槽上，
+ * 因此添加、刷新、取消都是O(1)， 刷新时不会移动回调对象。
+ * 高层的节点在下一层转完一圈时级联到下一层， 超出最高层范围的节点
+ * 暂存在最高层最远的槽中， 级联时重新计算位置。
+ */
+class TimingWheel : public Timer
+{
+public:
+    explicit TimingWheel(int tickMs = 1);
+
+    ~TimingWheel() override { clear(); }
+
+    void adjust(int id, int newExpires) override;
+
+    void add(int id, int timeOut, const TimeOutCallBack &cb) override;
+
+    void doWork(int id) override;
+
+    void cancel(int id) override;
+
+    void clear() override;
+
+    void tick() override;
+
+    int GetNextTick() override;
+
+private:
+    struct Node
+    {
+        int prev = -1;
+        int next = -1;
+        int slot = -1;        // 所在槽， -1表示未激活
+        uint64_t expires = 0; // 到期刻度
+        TimeOutCallBack cb;
+    };
+
+    static const int ROOT_BITS = 8;
+    static const int LEVEL_BITS = 6;
+    static const int LEVELS = 4;
+    static const int ROOT_SIZE = 1 << ROOT_BITS;
+    static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+    static const int SLOT_NUM = ROOT_SIZE + (LEVELS - 1) * LEVEL_SIZE;
+    static const int EXPIRED_SLOT = SLOT_NUM; // 当前刻度已到期、等待回调的节点
+
+    uint64_t NowTick_() const;
+    uint64_t ExpiresOf_(int timeOut) const;
+    int SlotOf_(uint64_t expires) const;
+    int FindSlot_(int begin, int end) const;
+    uint64_t NextExpires_() const;
+
+    void Link_(int id, int slot);
+    void Unlink_(int id);
+    void Cascade_(int level, int index);
+
+    int tickMs_;
+    TimeStamp start_;
+    uint64_t cur_; // 下一个待处理的刻度
+    size_t count_;
+    std::vector<Node> nodes_;
+    std::vector<int> heads_;       // 各槽链表头
+    std::vector<uint64_t> bitmap_; // 非空槽位图
+};
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+
+/* 服务器进程的fd上限， 启动后约占用十个 */
+const int FD_LIMIT = 64;
+
+/* 绑定0端口获取一个空闲端口 */
+int FreePort()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+int Connect(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    /* 服务器异常时不让测试一直阻塞 */
+    struct timeval tv = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+/* 发送一个请求并读取完整的响应， 收到200响应时返回true */
+bool Request(int fd)
+{
+    const char req[] = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    if (send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL) != sizeof(req) - 1)
+    {
+        return false;
+    }
+    std::string resp;
+    size_t total = std::string::npos;
+    char buf[16384];
+    while (total == std::string::npos || resp.size() < total)
+    {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            return false;
+        }
+        resp.append(buf, n);
+        size_t headEnd = resp.find("\r\n\r\n");
+        size_t lenPos = resp.find("Content-length: ");
+        if (total == std::string::npos && headEnd != std::string::npos &&
+            lenPos < headEnd)
+        {
+            total = headEnd + 4 + std::stoul(resp.substr(lenPos + 16));
+        }
+    }
+    return resp.compare(0, 15, "HTTP/1.1 200 OK") == 0;
+}
+
+/* 进程已使用的CPU时间， 单位为时钟滴答 */
+long CpuTicks(pid_t pid)
+{
+    std::ifstream in("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::istringstream fields(stat.substr(stat.rfind(')') + 2));
+    std::string field;
+    long utime = 0, stime = 0;
+    /* state之后第12、13个字段为utime和stime */
+    for (int i = 1; i <= 13 && fields >> field; i++)
+    {
+        if (i == 12)
+            utime = std::stol(field);
+        else if (i == 13)
+            stime = std::stol(field);
+    }
+    return utime + stime;
+}
+
+/* 以构建目录中的config.ini为模板， 生成每轮只接受一个连接的单Reactor配置 */
+std::string MakeConfigDir(int port, const std::string &engine, int trigMode)
+{
+    std::string bin = SERVER_BIN;
+    std::ifstream in(bin.substr(0, bin.find_last_of('/')) + "/config.ini");
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string cfg = ss.str();
+    const std::pair<const char *, std::string> keys[] = {
+        {"port", std::to_string(port)},
+        {"model", "single-reactor"},
+        {"engine", engine},
+        {"trigMode", std::to_string(trigMode)},
+        {"acceptBudget", "1"},
+        {"deferAcceptSec", "0"},
+        {"open", "false"},
+    };
+    for (auto &key : keys)
+    {
+        cfg = std::regex_replace(cfg,
+                                 std::regex(std::string("\n") + key.first + " = [^\n]*"),
+                                 std::string("\n") + key.first + " = " + key.second);
+    }
+    char tmpl[] = "/tmp/accept_testXXXXXX";
+    std::string dir = mkdtemp(tmpl);
+    std::ofstream(dir + "/config.ini") << cfg;
+    return dir;
+}
+
+/* 参数为事件引擎和trigMode： 3时监听套接字为边沿触发， 0时为水平触发 */
+class AcceptServer_TEST : public ::testing::TestWithParam<std::tuple<const char *, int>>
+{
+protected:
+    void SetUp() override
+    {
+        port_ = FreePort();
+        dir_ = MakeConfigDir(port_, std::get<0>(GetParam()), std::get<1>(GetParam()));
+        pid_ = fork();
+        ASSERT_GE(pid_, 0);
+        if (pid_ == 0)
+        {
+            setpgid(0, 0);
+            struct rlimit limit = {FD_LIMIT, FD_LIMIT};
+            if (setrlimit(RLIMIT_NOFILE, &limit) == 0 && chdir(dir_.c_str()) == 0)
+            {
+                execl(SERVER_BIN, SERVER_BIN, nullptr);
+            }
+            _exit(127);
+        }
+        setpgid(pid_, pid_);
+        bool up = false;
+        for (int i = 0; i < 500 && !up; i++)
+        {
+            int fd = Connect(port_);
+            if (fd >= 0)
+            {
+                close(fd);
+                up = true;
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        ASSERT_TRUE(up);
+    }
+
+    void TearDown() override
+    {
+        /* 测试期间服务器不应退出 */
+        int status = 0;
+        EXPECT_EQ(waitpid(pid_, &status, WNOHANG), 0);
+        kill(-pid_, SIGKILL);
+        waitpid(pid_, &status, 0);
+        system(("rm -rf " + dir_).c_str());
+    }
+
+    /* 暂停服务器时建立n个连接， 恢复后这些连接同时在全连接队列中 */
+    std::vector<int> ConnectBurst(int n)
+    {
+        std::vector<int> fds;
+        kill(pid_, SIGSTOP);
+        for (int i = 0; i < n; i++)
+        {
+            int fd = Connect(port_);
+            EXPECT_GE(fd, 0);
+            fds.push_back(fd);
+        }
+        kill(pid_, SIGCONT);
+        return fds;
+    }
+
+    int port_;
+    std::string dir_;
+    pid_t pid_;
+};
+
+} // namespace
+
+TEST_P(AcceptServer_TEST, BudgetDrainsBacklog)
+{
+    /* 每轮只接受一个连接， 边沿触发不会再次通知， 其余连接由acceptPending_接受 */
+    std::vector<int> fds = ConnectBurst(32);
+    for (int fd : fds)
+    {
+        EXPECT_TRUE(Request(fd));
+        close(fd);
+    }
+}
+
+TEST_P(AcceptServer_TEST, FdExhaustionBacksOff)
+{
+    std::vector<int> fds = ConnectBurst(FD_LIMIT + 32);
+    /* fd耗尽后暂停接受， 不应空转 */
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    long before = CpuTicks(pid_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_LT(CpuTicks(pid_) - before, sysconf(_SC_CLK_TCK) / 10);
+
+    /* 已接受的连接关闭后， 剩余的连接在暂停结束后被接受 */
+    for (int i = 0; i < FD_LIMIT; i++)
+    {
+        close(fds[i]);
+    }
+    for (size_t i = FD_LIMIT; i < fds.size(); i++)
+    {
+        EXPECT_TRUE(Request(fds[i]));
+        close(fds[i]);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Engines,
+                         AcceptServer_TEST,
+                         ::testing::Values(std::make_tuple("epoll", 3),
+                                           std::make_tuple("epoll", 0),
+                                           std::make_tuple("io_uring", 3)));
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include "arena.h"
+#include "httpconn.h"
+
+namespace
+{
+
+std::atomic<size_t> allocCount{0};
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    allocCount++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+TEST(ArenaTest, Allocate)
+{
+    Arena arena;
+    void *a = arena.Allocate(10);
+    void *b = arena.Allocate(8, 8);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0u);
+
+    std::string_view copy = arena.Copy("hello");
+    EXPECT_EQ(copy, "hello");
+    EXPECT_EQ(copy.data()[copy.size()], '\0');
+    EXPECT_STREQ(arena.Concat("/srv/", "index.html"), "/srv/index.html");
+
+    /* 超过内存块大小的分配单独申请 */
+    char *big = static_cast<char *>(arena.Allocate(Arena::BLOCK_SIZE * 2));
+    memset(big, 'x', Arena::BLOCK_SIZE * 2);
+    EXPECT_GE(arena.Capacity(), Arena::BLOCK_SIZE * 3);
+}
+
+TEST(ArenaTest, ResetReusesBlocks)
+{
+    Arena arena;
+    for (int i = 0; i < 4; i++)
+    {
+        arena.Allocate(Arena::BLOCK_SIZE / 2);
+    }
+    size_t capacity = arena.Capacity();
+    arena.Reset();
+    EXPECT_EQ(arena.Capacity(), capacity);
+
+    size_t before = allocCount;
+    for (int i = 0; i < 4; i++)
+    {
+        arena.Allocate(Arena::BLOCK_SIZE / 2);
+    }
+    EXPECT_EQ(allocCount - before, 0u);
+    EXPECT_EQ(arena.Capacity(), capacity);
+}
+
+TEST(ArenaTest, ResetReleasesLargeBlocks)
+{
+    Arena arena;
+    arena.Allocate(Arena::MAX_RETAIN * 2);
+    arena.Reset();
+    EXPECT_LE(arena.Capacity(), Arena::MAX_RETAIN);
+}
+
+/* 预热后重复请求同一静态文件， 命中文件缓存， 解析与生成响应的过程不再申请内存 */
+TEST(ArenaTest, StaticHitDoesNotAllocate)
+{
+    HttpConn::srcDir = RESOURCES_DIR;
+    ASSERT_TRUE(FileCache::Instance()->Watch(RESOURCES_DIR));
+    HttpConn::isET = false;
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    HttpConn conn;
+    conn.init(sv[0], sockaddr_in{});
+
+    const char req[] = "GET /index.html HTTP/1.1\r\n"
+                       "Host: localhost\r\n"
+                       "Connection: keep-alive\r\n\r\n";
+    char resp[65536];
+    auto roundTrip = [&]() {
+        int err = 0;
+        send(sv[1], req, sizeof(req) - 1, 0);
+        conn.read(&err);
+        size_t total = 0;
+        while (conn.process())
+        {
+            conn.write(&err);
+            ssize_t n;
+            while ((n = recv(sv[1], resp, sizeof(resp), MSG_DONTWAIT)) > 0)
+            {
+                total += n;
+            }
+        }
+        return total;
+    };
+
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_GT(roundTrip(), 0u);
+    }
+    size_t before = allocCount;
+    for (int i = 0; i < 100; i++)
+    {
+        roundTrip();
+    }
+    EXPECT_EQ(allocCount - before, 0u);
+    EXPECT_EQ(strncmp(resp, "HTTP/1.1 200 OK\r\n", 17), 0);
+    EXPECT_EQ(FileCache::Instance()->Size(), 1u);
+
+    conn.Close();
+    close(sv[1]);
+}
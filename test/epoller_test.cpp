@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include "epoller.h"
+
+TEST(Epoller_TEST, SkipUnchangedMod)
+{
+    Epoller epoller;
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    ASSERT_TRUE(epoller.AddFd(sv[0], EPOLLIN | EPOLLRDHUP));
+    uint64_t issued = epoller.CtlIssued();
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_TRUE(epoller.ModFd(sv[0], EPOLLIN | EPOLLRDHUP));
+    }
+    EXPECT_EQ(epoller.CtlIssued(), issued);
+    EXPECT_EQ(epoller.CtlAvoided(), 10u);
+    close(sv[0]);
+    close(sv[1]);
+}
+
+TEST(Epoller_TEST, BatchModInWait)
+{
+    Epoller epoller;
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    ASSERT_TRUE(epoller.AddFd(sv[0], EPOLLIN));
+    EXPECT_EQ(epoller.Wait(0), 0);
+    uint64_t issued = epoller.CtlIssued();
+    /* 同一轮内多次修改只在下一次Wait时提交一次 */
+    EXPECT_TRUE(epoller.ModFd(sv[0], EPOLLIN | EPOLLOUT));
+    EXPECT_TRUE(epoller.ModFd(sv[0], EPOLLOUT));
+    EXPECT_EQ(epoller.CtlIssued(), issued);
+    ASSERT_EQ(epoller.Wait(0), 1);
+    EXPECT_EQ(epoller.CtlIssued(), issued + 1);
+    EXPECT_EQ(epoller.GetEventFd(0), sv[0]);
+    EXPECT_EQ(epoller.GetEvents(0), static_cast<uint32_t>(EPOLLOUT));
+    close(sv[0]);
+    close(sv[1]);
+}
+
+TEST(Epoller_TEST, RearmOneShot)
+{
+    Epoller epoller;
+    int sv[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    ASSERT_TRUE(epoller.AddFd(sv[0], EPOLLIN | EPOLLONESHOT));
+    ASSERT_EQ(write(sv[1], "a", 1), 1);
+    ASSERT_EQ(epoller.Wait(0), 1);
+    /* EPOLLONESHOT触发后掩码相同的ModFd也必须提交 */
+    uint64_t issued = epoller.CtlIssued();
+    EXPECT_TRUE(epoller.ModFd(sv[0], EPOLLIN | EPOLLONESHOT));
+    ASSERT_EQ(epoller.Wait(0), 1);
+    EXPECT_EQ(epoller.CtlIssued(), issued + 1);
+    EXPECT_EQ(epoller.Wait(0), 0);
+    close(sv[0]);
+    close(sv[1]);
+}
@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include <sys/time.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "filecache.h"
+
+namespace
+{
+
+const std::string &TYPE(std::string_view)
+{
+    static const std::string type = "text/plain";
+    return type;
+}
+
+void WriteFile(const std::string &path, const std::string &data)
+{
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+std::string Gunzip(const char *data, size_t size)
+{
+    z_stream zs{};
+    std::string out;
+    if (inflateInit2(&zs, 15 + 16) != Z_OK)
+    {
+        return out;
+    }
+    zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    zs.avail_in = size;
+    char buf[4096];
+    int ret;
+    do
+    {
+        zs.next_out = reinterpret_cast<Bytef *>(buf);
+        zs.avail_out = sizeof(buf);
+        ret = inflate(&zs, Z_NO_FLUSH);
+        out.append(buf, sizeof(buf) - zs.avail_out);
+    } while (ret == Z_OK);
+    inflateEnd(&zs);
+    return ret == Z_STREAM_END ? out : std::string();
+}
+
+/* inotify线程异步失效， 最多等待一秒 */
+template <class Pred> bool WaitFor(Pred pred)
+{
+    for (int i = 0; i < 100 && !pred(); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+}
+
+/* 等待写入产生的inotify事件处理完， 否则之后缓存的结果可能随即被失效 */
+void Settle() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }
+
+class FileCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/filecache-XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        dir_ = tmpl;
+        cache_ = FileCache::Instance();
+        cache_->Init(1 << 20);
+        ASSERT_TRUE(cache_->Watch(dir_));
+    }
+
+    void TearDown() override
+    {
+        cache_->Clear();
+        std::string cmd = "rm -rf " + dir_;
+        ASSERT_EQ(system(cmd.c_str()), 0);
+    }
+
+    std::string dir_;
+    FileCache *cache_;
+};
+
+} // namespace
+
+TEST_F(FileCacheTest, HitSharesEntry)
+{
+    std::string path = dir_ + "/a.txt";
+    WriteFile(path, "hello");
+    Settle();
+    auto first = cache_->Get(path.c_str(), TYPE, true);
+    ASSERT_EQ(first->code, 200);
+    EXPECT_EQ(first->size, 5u);
+    ASSERT_NE(first->data, nullptr);
+    EXPECT_EQ(std::string(first->data, first->size), "hello");
+    EXPECT_EQ(first->header, "Content-type: text/plain\r\n" + first->validators +
+                                 "Content-length: 5\r\n\r\n");
+    EXPECT_EQ(cache_->Get(path.c_str(), TYPE, true), first);
+    EXPECT_EQ(cache_->Size(), 1u);
+}
+
+TEST_F(FileCacheTest, ModifyInvalidates)
+{
+    std::string path = dir_ + "/a.txt";
+    WriteFile(path, "old");
+    cache_->Get(path.c_str(), TYPE, true);
+    WriteFile(path, "new content");
+    ASSERT_TRUE(WaitFor([&] { return cache_->Size() == 0; }));
+    auto fresh = cache_->Get(path.c_str(), TYPE, true);
+    EXPECT_EQ(fresh->size, 11u);
+
+    /* 以rename替换文件时， 失效前取得的条目仍是原来的内容 */
+    WriteFile(path + ".tmp", "replaced");
+    ASSERT_EQ(rename((path + ".tmp").c_str(), path.c_str()), 0);
+    ASSERT_TRUE(WaitFor([&] { return cache_->Get(path.c_str(), TYPE, true)->size == 8; }));
+    EXPECT_EQ(std::string(fresh->data, fresh->size), "new content");
+}
+
+TEST_F(FileCacheTest, NegativeEntry)
+{
+    std::string path = dir_ + "/later.txt";
+    auto missing = cache_->Get(path.c_str(), TYPE, true);
+    EXPECT_EQ(missing->code, 404);
+    EXPECT_EQ(missing->fd, -1);
+    EXPECT_EQ(cache_->Get(path.c_str(), TYPE, true), missing);
+    WriteFile(path, "now");
+    ASSERT_TRUE(WaitFor([&] { return cache_->Get(path.c_str(), TYPE, true)->code == 200; }));
+
+    ASSERT_EQ(mkdir((dir_ + "/sub").c_str(), 0755), 0);
+    EXPECT_EQ(cache_->Get(dir_.c_str(), TYPE, true)->code, 404);
+    std::string unreadable = dir_ + "/secret.txt";
+    WriteFile(unreadable, "x");
+    chmod(unreadable.c_str(), 0600);
+    EXPECT_EQ(cache_->Get(unreadable.c_str(), TYPE, true)->code, 403);
+}
+
+TEST_F(FileCacheTest, NewDirectoryIsWatched)
+{
+    std::string sub = dir_ + "/sub";
+    ASSERT_EQ(mkdir(sub.c_str(), 0755), 0);
+    std::string path = sub + "/b.txt";
+    WriteFile(path, "1");
+    /* 等待新目录加入监视 */
+    ASSERT_TRUE(WaitFor([&] {
+        cache_->Get(path.c_str(), TYPE, true);
+        WriteFile(path, "22");
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return cache_->Get(path.c_str(), TYPE, true)->size == 2;
+    }));
+    WriteFile(path, "333");
+    ASSERT_TRUE(WaitFor([&] { return cache_->Get(path.c_str(), TYPE, true)->size == 3; }));
+}
+
+TEST_F(FileCacheTest, Uncacheable)
+{
+    WriteFile(dir_ + "/a.txt", "a");
+    /* 非规范路径与未监视目录下的文件每次重新打开 */
+    for (std::string path : {dir_ + "//a.txt", dir_ + "/./a.txt", std::string("/etc/hostname")})
+    {
+        auto first = cache_->Get(path.c_str(), TYPE, true);
+        EXPECT_NE(cache_->Get(path.c_str(), TYPE, true), first) << path;
+    }
+    EXPECT_EQ(cache_->Size(), 0u);
+}
+
+TEST_F(FileCacheTest, EvictsWithinCapacity)
+{
+    std::string big(16 * 1024, 'x');
+    for (int i = 0; i < 200; i++)
+    {
+        std::string path = dir_ + "/f" + std::to_string(i);
+        WriteFile(path, big);
+        cache_->Get(path.c_str(), TYPE, true);
+    }
+    EXPECT_LE(cache_->Bytes(), 1u << 20);
+    EXPECT_GT(cache_->Size(), 0u);
+    EXPECT_LE(cache_->Size(), FileCache::MAX_ENTRIES);
+}
+
+TEST_F(FileCacheTest, EncodedCompressedOnce)
+{
+    std::string path = dir_ + "/a.txt";
+    std::string text;
+    for (int i = 0; i < 200; i++)
+    {
+        text += "line " + std::to_string(i) + "\n";
+    }
+    WriteFile(path, text);
+    Settle();
+    auto plain = cache_->Get(path.c_str(), TYPE, false);
+    ASSERT_TRUE(plain->compressible);
+    EXPECT_NE(plain->header.find("\r\nVary: Accept-Encoding\r\n"), std::string::npos);
+
+    auto gzip = cache_->GetEncoded(plain, FileCache::GZIP, false);
+    ASSERT_NE(gzip, nullptr);
+    EXPECT_EQ(gzip->fd, -1);
+    EXPECT_LT(gzip->size, text.size());
+    EXPECT_EQ(Gunzip(gzip->data, gzip->size), text);
+    EXPECT_EQ(gzip->header, "Content-type: text/plain\r\nContent-Encoding: gzip\r\n"
+                            "Vary: Accept-Encoding\r\n" + plain->validators +
+                            "Content-length: " +
+                                std::to_string(gzip->size) + "\r\n\r\n");
+    EXPECT_EQ(cache_->GetEncoded(plain, FileCache::GZIP, false), gzip);
+    /* br只使用预先压缩的文件 */
+    EXPECT_EQ(cache_->GetEncoded(plain, FileCache::BR, false), nullptr);
+
+    /* 原文件变化后编码结果一同失效 */
+    WriteFile(path, text + text);
+    ASSERT_TRUE(WaitFor([&] { return cache_->Size() == 0; }));
+    Settle();
+    plain = cache_->Get(path.c_str(), TYPE, false);
+    gzip = cache_->GetEncoded(plain, FileCache::GZIP, false);
+    ASSERT_NE(gzip, nullptr);
+    EXPECT_EQ(Gunzip(gzip->data, gzip->size), text + text);
+
+    /* 小文件与不可压缩的类型不压缩 */
+    WriteFile(dir_ + "/small.txt", "small");
+    auto small = cache_->Get((dir_ + "/small.txt").c_str(), TYPE, false);
+    EXPECT_FALSE(small->compressible);
+    EXPECT_EQ(small->header.find("Vary"), std::string::npos);
+    EXPECT_EQ(cache_->GetEncoded(small, FileCache::GZIP, false), nullptr);
+}
+
+TEST_F(FileCacheTest, EncodedSiblingFile)
+{
+    std::string path = dir_ + "/b.txt";
+    WriteFile(path, std::string(2048, 'b'));
+    WriteFile(path + ".br", "brotli bytes");
+    WriteFile(path + ".gz", "gzip bytes");
+    auto plain = cache_->Get(path.c_str(), TYPE, true);
+    auto br = cache_->GetEncoded(plain, FileCache::BR, true);
+    ASSERT_NE(br, nullptr);
+    EXPECT_GE(br->fd, 0);
+    EXPECT_EQ(std::string(br->data, br->size), "brotli bytes");
+    EXPECT_NE(br->header.find("Content-type: text/plain\r\nContent-Encoding: br\r\n"),
+              std::string::npos);
+    auto gzip = cache_->GetEncoded(plain, FileCache::GZIP, true);
+    ASSERT_NE(gzip, nullptr);
+    EXPECT_EQ(std::string(gzip->data, gzip->size), "gzip bytes");
+
+    /* 预先压缩的文件变化时失效 */
+    WriteFile(path + ".br", "new brotli");
+    ASSERT_TRUE(WaitFor([&] {
+        auto fresh = cache_->GetEncoded(plain, FileCache::BR, true);
+        return fresh && fresh->size == 10;
+    }));
+
+    /* 比原文件旧的.gz文件不使用， 改为压缩生成 */
+    struct timeval old[2] = {{1000000000, 0}, {1000000000, 0}};
+    ASSERT_EQ(utimes((path + ".gz").c_str(), old), 0);
+    ASSERT_TRUE(WaitFor([&] {
+        auto fresh = cache_->GetEncoded(plain, FileCache::GZIP, true);
+        return fresh && fresh->fd == -1;
+    }));
+    gzip = cache_->GetEncoded(plain, FileCache::GZIP, true);
+    EXPECT_EQ(Gunzip(gzip->data, gzip->size), std::string(2048, 'b'));
+}
+
+TEST_F(FileCacheTest, EncodedOnlyOneCompressor)
+{
+    std::string path = dir_ + "/big.txt";
+    std::string text;
+    for (int i = 0; i < 3000; i++)
+    {
+        text += "row " + std::to_string(i % 97) + "\n";
+    }
+    WriteFile(path, text);
+    Settle();
+    auto plain = cache_->Get(path.c_str(), TYPE, false);
+    /* 并发未命中时只有一个线程压缩， 其余线程不等待也不重复压缩 */
+    std::vector<FileCache::EntryPtr> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        threads.emplace_back([&, i] { results[i] = cache_->GetEncoded(plain, FileCache::GZIP, false); });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto gzip = cache_->GetEncoded(plain, FileCache::GZIP, false);
+    ASSERT_NE(gzip, nullptr);
+    for (auto &result : results)
+    {
+        EXPECT_TRUE(result == nullptr || result == gzip);
+    }
+    EXPECT_EQ(Gunzip(gzip->data, gzip->size), text);
+}
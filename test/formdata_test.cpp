@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "formdata.h"
+
+namespace
+{
+
+std::string Decode(std::string s, bool plusAsSpace = true)
+{
+    s.resize(FormData::Decode(&s[0], s.size(), plusAsSpace));
+    return s;
+}
+
+} // namespace
+
+TEST(FormData_TEST, ScanMatchesScalar)
+{
+    const char stops[] = {'%', '+'};
+    for (size_t len = 0; len < 80; len++)
+    {
+        for (size_t pos = 0; pos <= len; pos++)
+        {
+            std::string s(len, 'a');
+            if (pos < len)
+            {
+                s[pos] = stops[pos % sizeof(stops)];
+            }
+            const char *b = s.data(), *e = s.data() + s.size();
+            EXPECT_EQ(FormData::ScanEscape(b, e), FormData::ScanEscapeScalar(b, e));
+            EXPECT_EQ(FormData::ScanEscape(b, e) - b, static_cast<long>(pos));
+        }
+    }
+}
+
+TEST(FormData_TEST, Decode)
+{
+    EXPECT_EQ(Decode("plain"), "plain");
+    EXPECT_EQ(Decode("a%20b+c"), "a b c");
+    EXPECT_EQ(Decode("a+b", false), "a+b");
+    EXPECT_EQ(Decode("%E4%BD%A0%e5%a5%bd"), "\xe4\xbd\xa0\xe5\xa5\xbd");
+    EXPECT_EQ(Decode("100%25"), "100%");
+    /* 不合法的转义原样保留 */
+    EXPECT_EQ(Decode("%"), "%");
+    EXPECT_EQ(Decode("%4"), "%4");
+    EXPECT_EQ(Decode("%zz%41"), "%zzA");
+    EXPECT_EQ(Decode("%00"), std::string(1, '\0'));
+    /* 转义之后的长段需整体前移 */
+    std::string tail(100, 'x');
+    EXPECT_EQ(Decode("%41" + tail + "%42" + tail), "A" + tail + "B" + tail);
+}
+
+TEST(FormData_TEST, Parse)
+{
+    std::string text = "username=alice&password=p%40ss+word&&flag&empty=&username=bob";
+    FormData form;
+    form.Parse(&text[0], text.size());
+    ASSERT_EQ(form.Fields().size(), 5u);
+    EXPECT_EQ(form.Get("username"), "alice");
+    EXPECT_EQ(form.Get("password"), "p@ss word");
+    EXPECT_NE(form.Get("flag").data(), nullptr);
+    EXPECT_EQ(form.Get("flag"), "");
+    EXPECT_EQ(form.Get("empty"), "");
+    EXPECT_EQ(form.Get("missing").data(), nullptr);
+    EXPECT_EQ(form.Fields().back().second, "bob");
+
+    std::string encodedKey = "a%3Db=c%26d";
+    form.Clear();
+    EXPECT_TRUE(form.Empty());
+    form.Parse(&encodedKey[0], encodedKey.size());
+    EXPECT_EQ(form.Get("a=b"), "c&d");
+}
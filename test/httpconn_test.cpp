@@ -0,0 +1,403 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <iterator>
+#include <sys/socket.h>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "httpconn.h"
+
+namespace
+{
+
+std::string ReadAll(int fd)
+{
+    std::string data;
+    char buf[65536];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+    {
+        data.append(buf, n);
+    }
+    return data;
+}
+
+/* 依次取出各响应的状态行与Content-length指定的内容 */
+std::vector<std::string> SplitResponses(const std::string &data)
+{
+    std::vector<std::string> statusLines;
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        size_t headEnd = data.find("\r\n\r\n", pos);
+        if (headEnd == std::string::npos)
+        {
+            break;
+        }
+        statusLines.push_back(data.substr(pos, data.find("\r\n", pos) - pos));
+        size_t lenPos = data.find("Content-length: ", pos);
+        size_t len = std::stoul(data.substr(lenPos + 16));
+        pos = headEnd + 4 + len;
+    }
+    EXPECT_EQ(pos, data.size());
+    return statusLines;
+}
+
+class HttpConnTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        HttpConn::srcDir = RESOURCES_DIR;
+        HttpConn::isET = false;
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv_), 0);
+        conn_.init(sv_[0], sockaddr_in{});
+    }
+
+    void TearDown() override
+    {
+        conn_.Close();
+        close(sv_[1]);
+    }
+
+    /* 发送请求， 处理并写回全部响应 */
+    std::string RoundTrip(const std::string &req)
+    {
+        int err = 0;
+        send(sv_[1], req.data(), req.size(), 0);
+        conn_.read(&err);
+        std::string resp;
+        while (conn_.process())
+        {
+            conn_.write(&err);
+            EXPECT_EQ(conn_.ToWriteBytes(), 0u);
+            resp += ReadAll(sv_[1]);
+            if (!conn_.isKeepAlive())
+            {
+                break;
+            }
+        }
+        return resp;
+    }
+
+    int sv_[2];
+    HttpConn conn_;
+};
+
+} // namespace
+
+TEST_F(HttpConnTest, PipelinedRequestsInOrder)
+{
+    std::string req;
+    req += "GET /index.html HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    req += "GET /nope.html HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    req += "GET /login HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    int err = 0;
+    send(sv_[1], req.data(), req.size(), 0);
+    conn_.read(&err);
+    /* 三个请求一次处理， 一次writev写回 */
+    ASSERT_TRUE(conn_.process());
+    conn_.write(&err);
+    EXPECT_EQ(conn_.ToWriteBytes(), 0u);
+    auto status = SplitResponses(ReadAll(sv_[1]));
+    ASSERT_EQ(status.size(), 3u);
+    EXPECT_EQ(status[0], "HTTP/1.1 200 OK");
+    EXPECT_EQ(status[1], "HTTP/1.1 404 Not Found");
+    EXPECT_EQ(status[2], "HTTP/1.1 200 OK");
+    EXPECT_TRUE(conn_.isKeepAlive());
+    EXPECT_FALSE(conn_.process());
+}
+
+TEST_F(HttpConnTest, StopAtConnectionClose)
+{
+    std::string req;
+    req += "GET / HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    req += "GET / HTTP/1.1\r\nConnection: close\r\n\r\n";
+    req += "GET / HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    auto status = SplitResponses(RoundTrip(req));
+    EXPECT_EQ(status.size(), 2u);
+    EXPECT_FALSE(conn_.isKeepAlive());
+}
+
+TEST_F(HttpConnTest, MoreThanOneBatch)
+{
+    std::string req;
+    size_t num = HttpConn::MAX_PIPELINE * 2 + 3;
+    for (size_t i = 0; i < num; i++)
+    {
+        req += "GET /400.html HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    }
+    auto status = SplitResponses(RoundTrip(req));
+    EXPECT_EQ(status.size(), num);
+}
+
+TEST_F(HttpConnTest, PartialRequestAfterComplete)
+{
+    std::string first = "GET / HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    std::string second = "GET /404.html HTTP/1.1\r\nConnection: keep-alive\r\n\r\n";
+    /* 第二个请求只到达一部分， 不影响第一个请求保持连接 */
+    auto status = SplitResponses(RoundTrip(first + second.substr(0, 10)));
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_TRUE(conn_.isKeepAlive());
+    status = SplitResponses(RoundTrip(second.substr(10)));
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_EQ(status[0], "HTTP/1.1 200 OK");
+}
+
+TEST_F(HttpConnTest, RegisteredRoute)
+{
+    HttpRequest::router.Add(
+        "GET", "/hello/:name", [](HttpRequest &request, HttpResponse &response) {
+            response.SetContent("hello " + std::string(request.GetParam("name")),
+                                "text/plain");
+        });
+    std::string resp = RoundTrip("GET /hello/web?x=1 HTTP/1.1\r\n"
+                                 "Connection: keep-alive\r\n\r\n");
+    auto status = SplitResponses(resp);
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_EQ(status[0], "HTTP/1.1 200 OK");
+    EXPECT_NE(resp.find("Content-type: text/plain\r\n"), std::string::npos);
+    EXPECT_EQ(resp.substr(resp.size() - 9), "hello web");
+    /* 方法不匹配时按路径查找静态文件 */
+    status = SplitResponses(RoundTrip("POST /hello/web HTTP/1.1\r\n"
+                                      "Connection: keep-alive\r\n\r\n"));
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_EQ(status[0], "HTTP/1.1 404 Not Found");
+}
+
+TEST_F(HttpConnTest, StaticFileWithQueryString)
+{
+    std::string resp = RoundTrip("GET /index.html?v=3 HTTP/1.1\r\n"
+                                 "Connection: keep-alive\r\n\r\n");
+    auto status = SplitResponses(resp);
+    ASSERT_EQ(status.size(), 1u);
+    EXPECT_EQ(status[0], "HTTP/1.1 200 OK");
+    EXPECT_NE(resp.find("Content-type: text/html\r\n"), std::string::npos);
+}
+
+TEST_F(HttpConnTest, KeepAliveLimits)
+{
+    HttpConn::keepAliveMax = 3;
+    HttpConn::keepAliveTimeout = 60;
+    std::string req;
+    for (int i = 0; i < 4; i++)
+    {
+        req += "GET /400.html HTTP/1.1\r\n\r\n";
+    }
+    std::string resp = RoundTrip(req);
+    HttpConn::keepAliveMax = 0;
+    HttpConn::keepAliveTimeout = 0;
+    /* 第三个响应后关闭连接， 第四个请求不处理 */
+    auto status = SplitResponses(resp);
+    EXPECT_EQ(status.size(), 3u);
+    EXPECT_FALSE(conn_.isKeepAlive());
+    EXPECT_NE(resp.find("Keep-Alive: timeout=60, max=2\r\n"), std::string::npos);
+    EXPECT_NE(resp.find("Keep-Alive: timeout=60, max=1\r\n"), std::string::npos);
+    EXPECT_NE(resp.find("Connection: close\r\n"), std::string::npos);
+}
+
+TEST_F(HttpConnTest, SendfileLargeFile)
+{
+    HttpResponse::sendfileThreshold = 4096;
+    std::string req;
+    req += "GET /index.html HTTP/1.1\r\n\r\n";
+    req += "GET /css/bootstrap.min.css HTTP/1.1\r\n\r\n";
+    req += "GET /index.html HTTP/1.1\r\n\r\n";
+    int err = 0;
+    send(sv_[1], req.data(), req.size(), 0);
+    conn_.read(&err);
+    ASSERT_TRUE(conn_.process());
+    /* 套接字缓冲区放不下时部分发送， 从记录的偏移继续 */
+    std::string resp;
+    while (conn_.ToWriteBytes() > 0)
+    {
+        ssize_t len = conn_.write(&err);
+        ASSERT_TRUE(len > 0 || err == EAGAIN);
+        resp += ReadAll(sv_[1]);
+    }
+    HttpResponse::sendfileThreshold = -1;
+
+    auto status = SplitResponses(resp);
+    ASSERT_EQ(status.size(), 3u);
+    std::ifstream css(std::string(RESOURCES_DIR) + "css/bootstrap.min.css",
+                      std::ios::binary);
+    std::string expected((std::istreambuf_iterator<char>(css)),
+                         std::istreambuf_iterator<char>());
+    ASSERT_EQ(expected.size(), 121260u);
+    EXPECT_NE(resp.find("\r\n\r\n" + expected + "HTTP/1.1 200 OK\r\n"),
+              std::string::npos);
+}
+
+TEST_F(HttpConnTest, ResponseHeaderBlock)
+{
+    HttpRequest::router.Add("GET", "/only-post", [](HttpRequest &, HttpResponse &response) {
+        response.SetCode(405);
+        response.SetPath("/405.html");
+    });
+    std::string resp = RoundTrip("GET /index.html HTTP/1.1\r\n\r\n"
+                                 "GET /only-post HTTP/1.1\r\nConnection: close\r\n\r\n");
+    auto status = SplitResponses(resp);
+    ASSERT_EQ(status.size(), 2u);
+    EXPECT_EQ(resp.compare(0, 41, "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\n"), 0);
+    EXPECT_EQ(status[1], "HTTP/1.1 405 Method Not Allowed");
+    EXPECT_NE(resp.find("HTTP/1.1 405 Method Not Allowed\r\nConnection: close\r\n"),
+              std::string::npos);
+    /* Date: Sun, 06 Nov 1994 08:49:37 GMT */
+    size_t date = resp.find("\r\nDate: ");
+    ASSERT_NE(date, std::string::npos);
+    EXPECT_EQ(resp.compare(date + 33, 6, " GMT\r\n"), 0);
+}
+
+TEST(HttpResponse_TEST, AcceptedEncodings)
+{
+    const unsigned ALL = FileCache::GZIP | FileCache::BR;
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("gzip"), FileCache::GZIP);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("gzip, deflate, br"), ALL);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("GZIP;q=0.5, br;q=0"), FileCache::GZIP);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("br;q=0.0"), 0u);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("x-gzip;q=1.0"), FileCache::GZIP);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("*"), ALL);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("gzip;q=0, *"), FileCache::BR);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("identity, *;q=0"), 0u);
+    EXPECT_EQ(HttpResponse::AcceptedEncodings("deflate"), 0u);
+}
+
+TEST_F(HttpConnTest, GzipNegotiation)
+{
+    ASSERT_TRUE(FileCache::Instance()->Watch(RESOURCES_DIR));
+    std::string resp = RoundTrip("GET /index.html HTTP/1.1\r\n"
+                                 "Accept-Encoding: gzip, deflate\r\n\r\n"
+                                 "GET /index.html HTTP/1.1\r\n\r\n"
+                                 "GET /index.html HTTP/1.1\r\n"
+                                 "Accept-Encoding: gzip;q=0\r\nConnection: close\r\n\r\n");
+    ASSERT_EQ(SplitResponses(resp).size(), 3u);
+    std::ifstream html(std::string(RESOURCES_DIR) + "index.html", std::ios::binary);
+    std::string expected((std::istreambuf_iterator<char>(html)),
+                         std::istreambuf_iterator<char>());
+
+    size_t encoding = resp.find("Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n");
+    ASSERT_NE(encoding, std::string::npos);
+    EXPECT_EQ(resp.find("Content-Encoding", encoding + 1), std::string::npos);
+    size_t body = resp.find("\r\n\r\n") + 4;
+    size_t len = std::stoul(resp.substr(resp.find("Content-length: ") + 16));
+    std::string out(expected.size(), '\0');
+    z_stream zs{};
+    ASSERT_EQ(inflateInit2(&zs, 15 + 16), Z_OK);
+    zs.next_in = reinterpret_cast<Bytef *>(&resp[body]);
+    zs.avail_in = len;
+    zs.next_out = reinterpret_cast<Bytef *>(&out[0]);
+    zs.avail_out = out.size();
+    EXPECT_EQ(inflate(&zs, Z_FINISH), Z_STREAM_END);
+    inflateEnd(&zs);
+    EXPECT_EQ(out, expected);
+
+    /* 未接受压缩时发送原始内容， 同样带Vary */
+    size_t identity = resp.find("Content-length: " + std::to_string(expected.size()) +
+                                "\r\n\r\n" + expected);
+    ASSERT_NE(identity, std::string::npos);
+    size_t vary = resp.rfind("Vary: Accept-Encoding\r\n", identity);
+    ASSERT_NE(vary, std::string::npos);
+    EXPECT_GT(vary, encoding);
+    FileCache::Instance()->Clear();
+}
+
+TEST(HttpResponse_TEST, ConditionalHelpers)
+{
+    EXPECT_TRUE(HttpResponse::ETagMatches("W/\"1-2-3\"", "W/\"1-2-3\""));
+    EXPECT_TRUE(HttpResponse::ETagMatches("\"a\", \"1-2-3\"", "W/\"1-2-3\""));
+    EXPECT_TRUE(HttpResponse::ETagMatches("*", "W/\"x\""));
+    EXPECT_FALSE(HttpResponse::ETagMatches("W/\"1-2-4\"", "W/\"1-2-3\""));
+    EXPECT_FALSE(HttpResponse::ETagMatches("", "W/\"1-2-3\""));
+
+    EXPECT_EQ(HttpResponse::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT"), 784111777);
+    EXPECT_EQ(HttpResponse::ParseHttpDate("Sunday, 06-Nov-94 08:49:37 GMT"), -1);
+    EXPECT_EQ(HttpResponse::ParseHttpDate("Sun, 06 Nov 1994 08:49:37 GMT junk"), -1);
+}
+
+TEST_F(HttpConnTest, ConditionalGet)
+{
+    HttpResponse::SetCacheControl("/css/:public, max-age=31536000, immutable;.html:no-cache");
+    auto header = [](const std::string &resp, const std::string &name) {
+        size_t pos = resp.find("\r\n" + name + ": ");
+        if (pos == std::string::npos)
+        {
+            return std::string();
+        }
+        pos += name.size() + 4;
+        return resp.substr(pos, resp.find("\r\n", pos) - pos);
+    };
+    /* 第一轮不缓存， 验证器由stat得到； 第二轮命中文件缓存 */
+    for (int round = 0; round < 2; round++)
+    {
+        if (round == 1)
+        {
+            ASSERT_TRUE(FileCache::Instance()->Watch(RESOURCES_DIR));
+        }
+        std::string full = RoundTrip("GET /index.html HTTP/1.1\r\n\r\n");
+        std::string etag = header(full, "ETag");
+        std::string lastModified = header(full, "Last-Modified");
+        ASSERT_EQ(etag.compare(0, 3, "W/\""), 0);
+        ASSERT_FALSE(lastModified.empty());
+        EXPECT_EQ(header(full, "Cache-Control"), "no-cache");
+
+        std::string resp = RoundTrip("GET /index.html HTTP/1.1\r\nIf-None-Match: \"x\", " +
+                                     etag + "\r\n\r\n");
+        EXPECT_EQ(resp.compare(0, 25, "HTTP/1.1 304 Not Modified"), 0) << round;
+        EXPECT_EQ(header(resp, "ETag"), etag);
+        EXPECT_EQ(header(resp, "Last-Modified"), lastModified);
+        EXPECT_EQ(header(resp, "Cache-Control"), "no-cache");
+        EXPECT_EQ(header(resp, "Content-length"), "");
+        ASSERT_GE(resp.size(), 4u);
+        EXPECT_EQ(resp.compare(resp.size() - 4, 4, "\r\n\r\n"), 0);
+
+        resp = RoundTrip("GET /index.html HTTP/1.1\r\nIf-Modified-Since: " + lastModified +
+                         "\r\n\r\n");
+        EXPECT_EQ(resp.compare(0, 25, "HTTP/1.1 304 Not Modified"), 0);
+        /* If-None-Match不匹配时忽略If-Modified-Since */
+        resp = RoundTrip("GET /index.html HTTP/1.1\r\nIf-None-Match: \"x\"\r\n"
+                         "If-Modified-Since: " + lastModified + "\r\n\r\n");
+        EXPECT_EQ(resp.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+        resp = RoundTrip("GET /index.html HTTP/1.1\r\n"
+                         "If-Modified-Since: Sun, 06 Nov 1994 08:49:37 GMT\r\n\r\n");
+        EXPECT_EQ(resp.compare(0, 15, "HTTP/1.1 200 OK"), 0);
+        EXPECT_EQ(FileCache::Instance()->Size(), round == 0 ? 0u : 1u);
+    }
+    std::string css = RoundTrip("GET /css/bootstrap.min.css HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(header(css, "Cache-Control"), "public, max-age=31536000, immutable");
+    std::string missing = RoundTrip("GET /missing.html HTTP/1.1\r\nIf-None-Match: *\r\n\r\n");
+    EXPECT_EQ(missing.compare(0, 22, "HTTP/1.1 404 Not Found"), 0);
+    EXPECT_EQ(header(missing, "Cache-Control"), "");
+    HttpResponse::SetCacheControl("");
+    FileCache::Instance()->Clear();
+}
+
+TEST_F(HttpConnTest, EncodedDotDotIsBadRequest)
+{
+    std::string resp = RoundTrip("GET /%2e%2e/%2e%2e/etc/passwd HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(resp.compare(0, 24, "HTTP/1.1 400 Bad Request"), 0);
+    EXPECT_EQ(resp.find("root:"), std::string::npos);
+}
+
+TEST_F(HttpConnTest, OversizedUploadIsPayloadTooLarge)
+{
+    HttpRequest::AllowUpload("/conn-upload");
+    size_t saved = HttpRequest::maxUpload;
+    HttpRequest::maxUpload = 16;
+    std::string body = "--b\r\nContent-Disposition: form-data; name=\"f\"; filename=\"a\"\r\n\r\n" +
+                       std::string(64, 'x') + "\r\n--b--\r\n";
+    std::string resp = RoundTrip("POST /conn-upload HTTP/1.1\r\n"
+                                 "Content-Type: multipart/form-data; boundary=b\r\n"
+                                 "Content-Length: " +
+                                 std::to_string(body.size()) + "\r\n\r\n" + body);
+    HttpRequest::maxUpload = saved;
+    EXPECT_EQ(resp.compare(0, 30, "HTTP/1.1 413 Payload Too Large"), 0) << resp;
+    EXPECT_NE(resp.find("Connection: close"), std::string::npos);
+}
+
+TEST_F(HttpConnTest, HeadTooLargeClosesConnection)
+{
+    std::string resp = RoundTrip("GET / HTTP/1.1\r\nX-Long: " +
+                                 std::string(HttpParser::MAX_HEAD, 'x'));
+    EXPECT_EQ(resp.compare(0, 24, "HTTP/1.1 400 Bad Request"), 0) << resp.substr(0, 64);
+    EXPECT_FALSE(conn_.isKeepAlive());
+}
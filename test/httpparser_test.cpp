@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "httpparser.h"
+
+TEST(HttpParser_TEST, FindMatchesScalar)
+{
+    /* 覆盖SIMD块内各个位置、块边界以及尾部 */
+    for (size_t len = 0; len < 100; len++)
+    {
+        for (size_t pos = 0; pos <= len; pos++)
+        {
+            std::string s(len, 'a');
+            if (pos < len)
+            {
+                s[pos] = (pos & 1) ? '\r' : '\n';
+            }
+            const char *b = s.data(), *e = s.data() + s.size();
+            EXPECT_EQ(HttpParser::FindEol(b, e), HttpParser::FindEolScalar(b, e));
+            EXPECT_EQ(HttpParser::FindEol(b, e) - b, static_cast<long>(pos));
+            if (pos < len)
+            {
+                s[pos] = ':';
+            }
+            EXPECT_EQ(HttpParser::FindChar(b, e, ':'),
+                      HttpParser::FindCharScalar(b, e, ':'));
+            EXPECT_EQ(HttpParser::FindChar(b, e, ':') - b, static_cast<long>(pos));
+        }
+    }
+}
+
+TEST(HttpParser_TEST, ParseRequest)
+{
+    std::string req = "GET /index.html HTTP/1.1\r\n"
+                      "Host: 127.0.0.1\r\n"
+                      "Connection:  keep-alive \r\n"
+                      "accept-encoding:gzip\r\n"
+                      "\r\n"
+                      "body";
+    HttpParser parser;
+    ASSERT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_OK);
+    EXPECT_EQ(parser.Method(), "GET");
+    EXPECT_EQ(parser.Path(), "/index.html");
+    EXPECT_EQ(parser.Version(), "1.1");
+    EXPECT_EQ(parser.HeaderCount(), 3u);
+    EXPECT_EQ(parser.GetHeader("host"), "127.0.0.1");
+    EXPECT_EQ(parser.GetHeader("Connection"), "keep-alive");
+    EXPECT_EQ(parser.GetHeader("Accept-Encoding"), "gzip");
+    EXPECT_EQ(parser.GetHeader("Cookie"), "");
+    EXPECT_EQ(parser.HeadLength(), req.size() - 4);
+    /* 结果指向输入数据， 不做拷贝 */
+    EXPECT_EQ(parser.Path().data(), req.data() + 4);
+}
+
+TEST(HttpParser_TEST, BareLineFeed)
+{
+    std::string req = "\r\nGET / HTTP/1.0\nHost: a\n\n";
+    HttpParser parser;
+    ASSERT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_OK);
+    EXPECT_EQ(parser.Version(), "1.0");
+    EXPECT_EQ(parser.GetHeader("Host"), "a");
+    EXPECT_EQ(parser.HeadLength(), req.size());
+}
+
+TEST(HttpParser_TEST, Incomplete)
+{
+    std::string req = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+    HttpParser parser;
+    for (size_t len = 0; len < req.size(); len++)
+    {
+        EXPECT_EQ(parser.Parse(req.data(), req.data() + len),
+                  HttpParser::PARSE_AGAIN)
+            << len;
+    }
+    EXPECT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_OK);
+}
+
+TEST(HttpParser_TEST, ResumeAfterMove)
+{
+    /* 逐字节到达， 且每次读取后数据都被移动到新的位置 */
+    std::string req = "POST /login HTTP/1.1\r\nHost: a\r\n"
+                      "Content-Type: text/plain\r\n\r\n";
+    HttpParser parser;
+    std::string buff;
+    for (size_t len = 1; len < req.size(); len++)
+    {
+        buff = std::string(req, 0, len);
+        EXPECT_EQ(parser.Parse(buff.data(), buff.data() + buff.size()),
+                  HttpParser::PARSE_AGAIN)
+            << len;
+    }
+    std::string moved = req;
+    ASSERT_EQ(parser.Parse(moved.data(), moved.data() + moved.size()),
+              HttpParser::PARSE_OK);
+    EXPECT_EQ(parser.Method(), "POST");
+    EXPECT_EQ(parser.Path().data(), moved.data() + 5);
+    EXPECT_EQ(parser.GetHeader("content-type"), "text/plain");
+    EXPECT_EQ(parser.GetHeader(1).name, "Content-Type");
+    EXPECT_EQ(parser.HeadLength(), req.size());
+    /* 完成后再次调用结果不变， Reset后开始新的请求 */
+    EXPECT_EQ(parser.Parse(moved.data(), moved.data() + moved.size()),
+              HttpParser::PARSE_OK);
+    parser.Reset();
+    EXPECT_EQ(parser.Parse(moved.data(), moved.data() + 4),
+              HttpParser::PARSE_AGAIN);
+    EXPECT_EQ(parser.HeaderCount(), 0u);
+}
+
+TEST(HttpParser_TEST, Malformed)
+{
+    const char *bad[] = {
+        "GET\r\n\r\n",
+        "GET /\r\n\r\n",
+        "GET  / HTTP/1.1\r\n\r\n",
+        "GET / HTTP/1.1 x\r\n\r\n",
+        "GET / FTP/1.1\r\n\r\n",
+        "GET / HTTP/1.1\r\nHost a\r\n\r\n",
+        "GET / HTTP/1.1\r\n: a\r\n\r\n",
+        "GET / HTTP/1.1\r\nHo st: a\r\n\r\n",
+        "GET / HTTP/1.1\r\n folded\r\n\r\n",
+        "GET / HTTP/1.1\rHost: a\r\n\r\n",
+    };
+    HttpParser parser;
+    for (const char *req : bad)
+    {
+        parser.Reset();
+        EXPECT_EQ(parser.Parse(req, req + strlen(req)), HttpParser::PARSE_ERROR)
+            << req;
+    }
+}
+
+TEST(HttpParser_TEST, TooManyHeaders)
+{
+    std::string req = "GET / HTTP/1.1\r\n";
+    for (size_t i = 0; i <= HttpParser::MAX_HEADERS; i++)
+    {
+        req += "X-" + std::to_string(i) + ": v\r\n";
+    }
+    req += "\r\n";
+    HttpParser parser;
+    EXPECT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_ERROR);
+}
+
+TEST(HttpParser_TEST, KnownHeaderTable)
+{
+    for (size_t i = 0; i < httpheader::KNOWN_NUM; i++)
+    {
+        HttpHeader id = static_cast<HttpHeader>(i);
+        std::string name(HeaderName(id));
+        EXPECT_EQ(LookupHeader(name), id) << name;
+        for (char &ch : name)
+        {
+            ch = (ch >= 'a' && ch <= 'z') ? ch - 'a' + 'A' : ch;
+        }
+        EXPECT_EQ(LookupHeader(name), id) << name;
+        /* 长度或内容不同的名称不能误中 */
+        EXPECT_EQ(LookupHeader(name + "x"), HttpHeader::UNKNOWN) << name;
+        EXPECT_EQ(LookupHeader(name.substr(1)), HttpHeader::UNKNOWN) << name;
+    }
+    EXPECT_EQ(LookupHeader(""), HttpHeader::UNKNOWN);
+    EXPECT_EQ(LookupHeader("X-Forwarded-For"), HttpHeader::UNKNOWN);
+}
+
+TEST(HttpParser_TEST, KnownHeaderSlots)
+{
+    std::string req = "GET / HTTP/1.1\r\n"
+                      "X-Custom: 1\r\n"
+                      "content-length: 0\r\n"
+                      "Cookie: a=1\r\n"
+                      "COOKIE: b=2\r\n"
+                      "\r\n";
+    HttpParser parser;
+    ASSERT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_OK);
+    EXPECT_EQ(parser.GetHeader(HttpHeader::CONTENT_LENGTH), "0");
+    /* 重复的首部字段取第一个 */
+    EXPECT_EQ(parser.GetHeader(HttpHeader::COOKIE), "a=1");
+    EXPECT_EQ(parser.GetHeader("cookie"), "a=1");
+    EXPECT_EQ(parser.GetHeader(HttpHeader::HOST), "");
+    EXPECT_EQ(parser.GetHeader(HttpHeader::UNKNOWN), "");
+    EXPECT_EQ(parser.GetHeader("x-custom"), "1");
+    EXPECT_EQ(parser.HeaderCount(), 4u);
+    /* Reset后不残留上一个请求的槽位 */
+    parser.Reset();
+    std::string next = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+    ASSERT_EQ(parser.Parse(next.data(), next.data() + next.size()),
+              HttpParser::PARSE_OK);
+    EXPECT_EQ(parser.GetHeader(HttpHeader::COOKIE), "");
+    EXPECT_EQ(parser.GetHeader(HttpHeader::HOST), "a");
+}
+
+TEST(HttpParser_TEST, DuplicateContentLength)
+{
+    std::string req = "POST / HTTP/1.1\r\n"
+                      "Content-Length: 1\r\n"
+                      "Content-Length: 2\r\n"
+                      "\r\n";
+    HttpParser parser;
+    EXPECT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_ERROR);
+}
+
+TEST(HttpParser_TEST, DuplicateTransferEncoding)
+{
+    /* 合并为"chunked, identity"的中间代理与这里对分帧的判断会不一致 */
+    std::string req = "POST / HTTP/1.1\r\n"
+                      "Transfer-Encoding: chunked\r\n"
+                      "transfer-encoding: identity\r\n"
+                      "\r\n";
+    HttpParser parser;
+    EXPECT_EQ(parser.Parse(req.data(), req.data() + req.size()),
+              HttpParser::PARSE_ERROR);
+}
+
+TEST(HttpParser_TEST, HeadTooLarge)
+{
+    /* 没有行尾的首部字段分段到达， 超过MAX_HEAD后不再等待 */
+    std::string req = "GET / HTTP/1.1\r\nX-Long: ";
+    HttpParser parser;
+    HttpParser::PARSE_RESULT result = HttpParser::PARSE_AGAIN;
+    while (result == HttpParser::PARSE_AGAIN && req.size() < 4 * HttpParser::MAX_HEAD)
+    {
+        req.append(1000, 'x');
+        result = parser.Parse(req.data(), req.data() + req.size());
+    }
+    EXPECT_EQ(result, HttpParser::PARSE_ERROR);
+    EXPECT_LE(req.size(), HttpParser::MAX_HEAD + 1000);
+
+    /* 没有行尾的请求行 */
+    std::string line = "GET /" + std::string(HttpParser::MAX_HEAD, 'a');
+    parser.Reset();
+    EXPECT_EQ(parser.Parse(line.data(), line.data() + line.size()),
+              HttpParser::PARSE_ERROR);
+
+    /* 接近上限的完整请求头仍然可以解析 */
+    std::string ok = "GET / HTTP/1.1\r\nX-Long: " +
+                     std::string(HttpParser::MAX_HEAD - 64, 'y') + "\r\n\r\n";
+    parser.Reset();
+    EXPECT_EQ(parser.Parse(ok.data(), ok.data() + ok.size()), HttpParser::PARSE_OK);
+}
+
+TEST(HttpParser_TEST, HasToken)
+{
+    EXPECT_TRUE(HttpParser::HasToken("close", "close"));
+    EXPECT_TRUE(HttpParser::HasToken("Upgrade,  Keep-Alive ", "keep-alive"));
+    EXPECT_TRUE(HttpParser::HasToken("a,,\tclose", "close"));
+    EXPECT_FALSE(HttpParser::HasToken("", "close"));
+    EXPECT_FALSE(HttpParser::HasToken("closed", "close"));
+    EXPECT_FALSE(HttpParser::HasToken("keep-alive=close", "close"));
+}
@@ -0,0 +1,404 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include "httprequest.h"
+
+TEST(HttpRequest_TEST, FragmentedRequest)
+{
+    std::string req = "GET /login HTTP/1.1\r\n"
+                      "Host: 127.0.0.1\r\n"
+                      "Connection: keep-alive\r\n"
+                      "\r\n";
+    HttpRequest request;
+    Buffer buff;
+    /* 请求逐字节到达， 完整之前不应判为错误 */
+    for (size_t i = 0; i + 1 < req.size(); i++)
+    {
+        buff.Append(&req[i], 1);
+        EXPECT_EQ(request.parse(buff), HttpRequest::NO_REQUEST) << i;
+    }
+    buff.Append(&req.back(), 1);
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.method(), "GET");
+    EXPECT_EQ(request.path(), "/login");
+    EXPECT_TRUE(request.IsKeepAlive());
+    EXPECT_EQ(buff.ReadableBytes(), 0u);
+}
+
+TEST(HttpRequest_TEST, BodyByContentLength)
+{
+    std::string req = "PUT /a HTTP/1.1\r\n"
+                      "Content-Length: 10\r\n"
+                      "\r\n"
+                      "0123\r\n6789";
+    std::string next = "GET /b HTTP/1.0\r\n\r\n";
+    HttpRequest request;
+    Buffer buff;
+    buff.Append(req.substr(0, req.size() - 3));
+    EXPECT_EQ(request.parse(buff), HttpRequest::NO_REQUEST);
+    /* 内容实体中的CRLF不影响边界， 之后的数据留给下一个请求 */
+    buff.Append(req.substr(req.size() - 3) + next);
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.path(), "/a");
+    EXPECT_TRUE(request.IsKeepAlive());
+    EXPECT_EQ(buff.ReadableBytes(), next.size());
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.path(), "/b");
+    EXPECT_EQ(request.version(), "1.0");
+    EXPECT_EQ(buff.ReadableBytes(), 0u);
+}
+
+TEST(HttpRequest_TEST, BadRequest)
+{
+    HttpRequest request;
+    Buffer buff;
+    buff.Append(std::string("GET / HTTP/1.1\r\nContent-Length: x\r\n\r\n"));
+    EXPECT_EQ(request.parse(buff), HttpRequest::BAD_REQUEST);
+    buff.Append(std::string("BAD\r\n\r\n"));
+    EXPECT_EQ(request.parse(buff), HttpRequest::BAD_REQUEST);
+    EXPECT_FALSE(request.IsKeepAlive());
+}
+
+TEST(HttpRequest_TEST, ChunkedBodyStreamsToHandler)
+{
+    std::string received;
+    int calls = 0;
+    bool finished = false;
+    HttpRequest::SetBodyHandler(
+        "POST", "/upload", [&](HttpRequest &req, std::string_view data, bool last) {
+            EXPECT_EQ(req.GetHeader("X-Name"), "demo");
+            received.append(data);
+            calls++;
+            finished = last;
+            return true;
+        });
+    std::string req = "POST /upload HTTP/1.1\r\n"
+                      "X-Name: demo\r\n"
+                      "Transfer-Encoding: chunked\r\n"
+                      "\r\n"
+                      "5\r\nhello\r\n"
+                      "7;ext=1\r\n, world\r\n"
+                      "b\r\n\r\nline2\r\n\r\n\r\n"
+                      "0\r\n"
+                      "Trailer: x\r\n"
+                      "\r\n";
+    std::string next = "GET / HTTP/1.1\r\n\r\n";
+    HttpRequest request;
+    Buffer buff;
+    /* 逐字节到达， 请求头之后的内容实体到达一段交付一段， 不在缓冲区中累积 */
+    size_t headLen = req.find("\r\n\r\n") + 4;
+    for (size_t i = 0; i + 1 < req.size(); i++)
+    {
+        buff.Append(&req[i], 1);
+        EXPECT_EQ(request.parse(buff), HttpRequest::NO_REQUEST) << i;
+        if (i >= headLen)
+        {
+            EXPECT_LE(buff.ReadableBytes(), 16u) << i;
+        }
+    }
+    EXPECT_FALSE(finished);
+    buff.Append(req.substr(req.size() - 1) + next);
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(received, "hello, world\r\nline2\r\n\r\n");
+    EXPECT_GT(calls, 3);
+    EXPECT_EQ(buff.ReadableBytes(), next.size());
+    EXPECT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+}
+
+TEST(HttpRequest_TEST, HandlerSeesContentLengthBodyInPieces)
+{
+    size_t total = 0;
+    int lastCalls = 0;
+    HttpRequest::SetBodyHandler(
+        "PUT", "/big", [&](HttpRequest &, std::string_view data, bool last) {
+            total += data.size();
+            lastCalls += last;
+            return true;
+        });
+    HttpRequest request;
+    Buffer buff;
+    const size_t size = 1 << 20;
+    buff.Append("PUT /big HTTP/1.1\r\nContent-Length: " + std::to_string(size) +
+                "\r\n\r\n");
+    std::string piece(4096, 'x');
+    for (size_t sent = 0; sent < size; sent += piece.size())
+    {
+        buff.Append(piece);
+        HttpRequest::HTTP_CODE code = request.parse(buff);
+        EXPECT_EQ(code,
+                  sent + piece.size() < size ? HttpRequest::NO_REQUEST
+                                             : HttpRequest::GET_REQUEST);
+        EXPECT_EQ(buff.ReadableBytes(), 0u);
+    }
+    EXPECT_EQ(total, size);
+    EXPECT_EQ(lastCalls, 1);
+}
+
+TEST(HttpRequest_TEST, BadFraming)
+{
+    const char *bad[] = {
+        "POST / HTTP/1.1\r\nContent-Length: 3\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n"
+        "Transfer-Encoding: identity\r\n\r\n0\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nab\r\n",
+    };
+    for (const char *req : bad)
+    {
+        HttpRequest request;
+        Buffer buff;
+        buff.Append(std::string(req));
+        EXPECT_EQ(request.parse(buff), HttpRequest::BAD_REQUEST) << req;
+    }
+}
+
+TEST(HttpRequest_TEST, ChunkLineTooLong)
+{
+    /* 块大小行或trailer行迟迟没有行尾时， 不应让缓冲区无限增长 */
+    const std::string head = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+    const std::string prefixes[] = {"1;ext=", "0\r\nX-Trailer: "};
+    for (const std::string &prefix : prefixes)
+    {
+        HttpRequest request;
+        Buffer buff;
+        buff.Append(head + prefix);
+        EXPECT_EQ(request.parse(buff), HttpRequest::NO_REQUEST) << prefix;
+        std::string piece(512, 'x');
+        HttpRequest::HTTP_CODE code = HttpRequest::NO_REQUEST;
+        size_t sent = 0;
+        while (code == HttpRequest::NO_REQUEST && sent < 4 * HttpRequest::MAX_CHUNK_LINE)
+        {
+            buff.Append(piece);
+            sent += piece.size();
+            code = request.parse(buff);
+        }
+        EXPECT_EQ(code, HttpRequest::BAD_REQUEST) << prefix;
+        EXPECT_LE(sent, HttpRequest::MAX_CHUNK_LINE + piece.size()) << prefix;
+    }
+}
+
+TEST(HttpRequest_TEST, ChunkTrailerAcrossReads)
+{
+    std::string received;
+    HttpRequest::SetBodyHandler(
+        "POST", "/trailer", [&](HttpRequest &, std::string_view data, bool) {
+            received.append(data);
+            return true;
+        });
+    std::string req = "POST /trailer HTTP/1.1\r\n"
+                      "Transfer-Encoding: chunked\r\n"
+                      "\r\n"
+                      "3;name=" + std::string(1000, 'n') + "\r\nabc\r\n"
+                      "0\r\n"
+                      "X-Checksum: " + std::string(3000, 'c') + "\r\n"
+                      "X-Other: 1\r\n"
+                      "\r\n";
+    HttpRequest request;
+    Buffer buff;
+    /* 长的块大小行与trailer行分多次到达， 行尾到达前保持未完成 */
+    size_t i = 0;
+    for (; i + 100 < req.size(); i += 100)
+    {
+        buff.Append(req.substr(i, 100));
+        EXPECT_EQ(request.parse(buff), HttpRequest::NO_REQUEST) << i;
+    }
+    buff.Append(req.substr(i));
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(received, "abc");
+    EXPECT_EQ(buff.ReadableBytes(), 0u);
+}
+
+TEST(HttpRequest_TEST, MultipartUpload)
+{
+    HttpRequest::AllowUpload("/upload-form");
+    std::string body = "--XyZ\r\n"
+                       "Content-Disposition: form-data; name=\"title\"\r\n"
+                       "\r\n"
+                       "hello\r\n"
+                       "--XyZ\r\n"
+                       "Content-Disposition: form-data; name=\"file\"; filename=\"a.bin\"\r\n"
+                       "\r\n" +
+                       std::string(1 << 20, 'z') +
+                       "\r\n--XyZ--\r\n";
+    std::string req = "POST /upload-form HTTP/1.1\r\n"
+                      "Content-Type: multipart/form-data; boundary=XyZ\r\n"
+                      "Content-Length: " +
+                      std::to_string(body.size()) + "\r\n\r\n" + body;
+    HttpRequest request;
+    Buffer buff;
+    /* 按4KB到达， 缓冲区中不累积内容实体 */
+    HttpRequest::HTTP_CODE code = HttpRequest::NO_REQUEST;
+    for (size_t i = 0; i < req.size(); i += 4096)
+    {
+        buff.Append(req.substr(i, 4096));
+        code = request.parse(buff);
+        EXPECT_LE(buff.ReadableBytes(), 4096u);
+    }
+    ASSERT_EQ(code, HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.GetPost("title"), "hello");
+    const MultipartParser::File *file = request.GetFile("file");
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->filename, "a.bin");
+    EXPECT_EQ(file->size, 1u << 20);
+    std::string path = file->path;
+    EXPECT_EQ(access(path.c_str(), F_OK), 0);
+    /* 下一个请求开始时删除临时文件 */
+    buff.Append(std::string("GET / HTTP/1.1\r\n\r\n"));
+    EXPECT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.GetFile("file"), nullptr);
+    EXPECT_NE(access(path.c_str(), F_OK), 0);
+}
+
+TEST(HttpRequest_TEST, MultipartUploadLimits)
+{
+    HttpRequest::AllowUpload("/upload-limit");
+    auto upload = [](const std::string &path, size_t size) {
+        std::string body = "--XyZ\r\n"
+                           "Content-Disposition: form-data; name=\"file\"; filename=\"a\"\r\n"
+                           "\r\n" +
+                           std::string(size, 'z') + "\r\n--XyZ--\r\n";
+        return "POST " + path + " HTTP/1.1\r\n"
+               "Content-Type: multipart/form-data; boundary=XyZ\r\n"
+               "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    };
+    size_t saved = HttpRequest::maxUpload;
+    HttpRequest::maxUpload = 64 * 1024;
+    {
+        /* 没有允许上传的路径不写入临时文件， 内容实体被丢弃 */
+        HttpRequest request;
+        Buffer buff;
+        buff.Append(upload("/index.html", 1024));
+        ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+        EXPECT_TRUE(request.GetFiles().empty());
+        EXPECT_EQ(buff.ReadableBytes(), 0u);
+    }
+    {
+        /* 超出上限时以413结束， 已写入的部分随即删除 */
+        HttpRequest request;
+        Buffer buff;
+        std::string req = upload("/upload-limit", HttpRequest::maxUpload + 1);
+        HttpRequest::HTTP_CODE code = HttpRequest::NO_REQUEST;
+        for (size_t i = 0; i < req.size() && code == HttpRequest::NO_REQUEST; i += 4096)
+        {
+            buff.Append(req.substr(i, 4096));
+            code = request.parse(buff);
+        }
+        EXPECT_EQ(code, HttpRequest::PAYLOAD_TOO_LARGE);
+        EXPECT_FALSE(request.IsKeepAlive());
+        EXPECT_TRUE(request.GetFiles().empty());
+    }
+    {
+        HttpRequest request;
+        Buffer buff;
+        buff.Append(upload("/upload-limit", HttpRequest::maxUpload));
+        ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+        ASSERT_NE(request.GetFile("file"), nullptr);
+        EXPECT_EQ(request.GetFile("file")->size, HttpRequest::maxUpload);
+    }
+    HttpRequest::maxUpload = saved;
+}
+
+TEST(HttpRequest_TEST, JsonBody)
+{
+    std::string body = R"({"username":"bob","n":[1,2]})";
+    std::string req = "POST /api HTTP/1.1\r\n"
+                      "Content-Type: application/json; charset=utf-8\r\n"
+                      "Content-Length: " +
+                      std::to_string(body.size()) + "\r\n\r\n" + body;
+    HttpRequest request;
+    Buffer buff;
+    buff.Append(req);
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.GetJson()["username"].AsString(), "bob");
+    EXPECT_EQ(request.GetJson()["n"][1].AsInt(), 2);
+    /* 格式错误的JSON以400结束 */
+    buff.Append(std::string("POST /api HTTP/1.1\r\n"
+                            "Content-Type: application/json\r\n"
+                            "Content-Length: 3\r\n\r\n{x}"));
+    EXPECT_EQ(request.parse(buff), HttpRequest::BAD_REQUEST);
+    EXPECT_FALSE(request.GetJson().IsValid());
+}
+
+TEST(HttpRequest_TEST, QueryString)
+{
+    HttpRequest request;
+    Buffer buff;
+    buff.Append(std::string("GET /caf%C3%A9/a+b.html?v=3&q=hello+world%21&v=4 HTTP/1.1\r\n\r\n"));
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    /* 路径中的+不是空格 */
+    EXPECT_EQ(request.path(), "/caf\xc3\xa9/a+b.html");
+    EXPECT_EQ(request.GetQuery("v"), "3");
+    EXPECT_EQ(request.GetQuery("q"), "hello world!");
+    EXPECT_EQ(request.GetQuery("x").data(), nullptr);
+
+    buff.Append(std::string("GET /index.html HTTP/1.1\r\n\r\n"));
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.GetQuery("v").data(), nullptr);
+
+    /* 解码出'\0'的路径无法作为文件名 */
+    buff.Append(std::string("GET /a%00.html HTTP/1.1\r\n\r\n"));
+    EXPECT_EQ(request.parse(buff), HttpRequest::BAD_REQUEST);
+}
+
+TEST(HttpRequest_TEST, DotDotSegment)
+{
+    /* 解码后含有..段的路径会拼接出srcDir之外的路径 */
+    for (std::string target : {"/%2e%2e/%2e%2e/etc/passwd", "/../index.html", "/css/%2E%2E",
+                               "/a/..%2fb", ".."})
+    {
+        HttpRequest request;
+        Buffer buff;
+        buff.Append("GET " + target + " HTTP/1.1\r\n\r\n");
+        EXPECT_EQ(request.parse(buff), HttpRequest::BAD_REQUEST) << target;
+    }
+    for (std::string target : {"/..a/b..", "/a/.../x", "/a./.b"})
+    {
+        HttpRequest request;
+        Buffer buff;
+        buff.Append("GET " + target + " HTTP/1.1\r\n\r\n");
+        EXPECT_EQ(request.parse(buff), HttpRequest::GET_REQUEST) << target;
+    }
+}
+
+TEST(HttpRequest_TEST, UrlencodedBody)
+{
+    std::string body = "username=al%69ce&password=p%40ss+word";
+    std::string req = "POST /form HTTP/1.1\r\n"
+                      "Content-Type: application/x-www-form-urlencoded\r\n"
+                      "Content-Length: " +
+                      std::to_string(body.size()) + "\r\n\r\n" + body;
+    HttpRequest request;
+    Buffer buff;
+    buff.Append(req);
+    ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST);
+    EXPECT_EQ(request.GetPost("username"), "alice");
+    EXPECT_EQ(request.GetPost("password"), "p@ss word");
+    EXPECT_EQ(request.GetPost("missing"), "");
+}
+
+TEST(HttpRequest_TEST, KeepAliveDefaults)
+{
+    struct Case
+    {
+        const char *req;
+        bool keepAlive;
+    } cases[] = {
+        {"GET / HTTP/1.1\r\n\r\n", true},
+        {"GET / HTTP/1.1\r\nConnection: Close\r\n\r\n", false},
+        {"GET / HTTP/1.1\r\nConnection: Upgrade, close\r\n\r\n", false},
+        {"GET / HTTP/1.0\r\n\r\n", false},
+        {"GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", true},
+        {"GET / HTTP/1.0\r\nConnection: TE, keep-alive\r\n\r\n", true},
+    };
+    for (auto &c : cases)
+    {
+        HttpRequest request;
+        Buffer buff;
+        buff.Append(c.req);
+        ASSERT_EQ(request.parse(buff), HttpRequest::GET_REQUEST) << c.req;
+        EXPECT_EQ(request.IsKeepAlive(), c.keepAlive) << c.req;
+    }
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "json.h"
+
+TEST(Json_TEST, ScanMatchesScalar)
+{
+    const char stops[] = {'"', '\\', '\n', '\0', '\x1f'};
+    for (size_t len = 0; len < 80; len++)
+    {
+        for (size_t pos = 0; pos <= len; pos++)
+        {
+            /* 高位字节(UTF-8)不是控制字符 */
+            std::string s(len, '\xe4');
+            if (pos < len)
+            {
+                s[pos] = stops[pos % sizeof(stops)];
+            }
+            const char *b = s.data(), *e = s.data() + s.size();
+            EXPECT_EQ(JsonDoc::ScanString(b, e), JsonDoc::ScanStringScalar(b, e));
+            EXPECT_EQ(JsonDoc::ScanString(b, e) - b, static_cast<long>(pos));
+        }
+    }
+}
+
+TEST(Json_TEST, ParseDocument)
+{
+    std::string text = R"( {"username": "alice", "age": 30, "score": -1.5e2,
+        "tags": ["a", "b", []], "admin": false, "ok": true, "none": null,
+        "nested": {"k": {"deep": "v"}}, "username": "dup"} )";
+    const char *begin = text.data();
+    JsonDoc doc;
+    ASSERT_TRUE(doc.Parse(text));
+    JsonValue root = doc.Root();
+    ASSERT_EQ(root.Type(), JsonValue::OBJECT);
+    EXPECT_EQ(root.Size(), 9u);
+    /* 重复的键取第一个， 没有转义的字符串直接指向原文 */
+    EXPECT_EQ(root["username"].AsString(), "alice");
+    EXPECT_GE(root["username"].AsString().data(), begin);
+    EXPECT_LT(root["username"].AsString().data(), begin + text.size());
+    EXPECT_EQ(root["age"].AsInt(), 30);
+    EXPECT_DOUBLE_EQ(root["score"].AsNumber(), -150.0);
+    EXPECT_EQ(root["score"].AsInt(), -150);
+    EXPECT_EQ(root["tags"].Size(), 3u);
+    EXPECT_EQ(root["tags"][1].AsString(), "b");
+    EXPECT_EQ(root["tags"][2].Type(), JsonValue::ARRAY);
+    EXPECT_FALSE(root["tags"][3].IsValid());
+    EXPECT_FALSE(root["admin"].AsBool(true));
+    EXPECT_TRUE(root["ok"].AsBool());
+    EXPECT_TRUE(root["none"].IsNull());
+    EXPECT_EQ(root["nested"]["k"]["deep"].AsString(), "v");
+    EXPECT_EQ(root.Key(8), "username");
+    /* 不存在的值可以继续取值 */
+    EXPECT_FALSE(root["missing"]["x"][0].IsValid());
+    EXPECT_EQ(root["missing"].AsString("def"), "def");
+    EXPECT_EQ(root["age"].AsString(), "");
+}
+
+TEST(Json_TEST, Escapes)
+{
+    std::string text = R"(["a\"b\\c\/d\n\t", "\u0041\u00e9\u4e2d\ud83d\ude00", "x\u0000y"])";
+    JsonDoc doc;
+    ASSERT_TRUE(doc.Parse(text));
+    EXPECT_EQ(doc.Root()[0].AsString(), "a\"b\\c/d\n\t");
+    EXPECT_EQ(doc.Root()[1].AsString(), "A\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80");
+    EXPECT_EQ(doc.Root()[2].AsString(), std::string("x\0y", 3));
+}
+
+TEST(Json_TEST, Scalars)
+{
+    const char *good[] = {"0", "-0", "1.5", "1e10", "2E-3", "\"\"", "true", "null", " [ ] ", "{}"};
+    for (const char *t : good)
+    {
+        std::string text = t;
+        JsonDoc doc;
+        EXPECT_TRUE(doc.Parse(text)) << t;
+    }
+}
+
+TEST(Json_TEST, Malformed)
+{
+    const char *bad[] = {
+        "", "   ", "{", "[1,]", "[1 2]", "{\"a\" 1}", "{\"a\":}", "{a:1}",
+        "{\"a\":1,}", "01", "1.", ".5", "-", "1e", "+1", "tru", "nul",
+        "\"abc", "\"a\nb\"", "\"\\x\"", "\"\\u12\"", "\"\\ud800\"",
+        "\"\\udc00\"", "[] []", "{\"a\":1}x",
+    };
+    for (const char *t : bad)
+    {
+        std::string text = t;
+        JsonDoc doc;
+        EXPECT_FALSE(doc.Parse(text)) << t;
+        EXPECT_FALSE(doc.Root().IsValid()) << t;
+    }
+    /* 嵌套过深 */
+    std::string deep(JsonDoc::MAX_DEPTH + 2, '[');
+    deep += std::string(JsonDoc::MAX_DEPTH + 2, ']');
+    JsonDoc doc;
+    EXPECT_FALSE(doc.Parse(deep));
+    std::string ok(JsonDoc::MAX_DEPTH, '[');
+    ok += std::string(JsonDoc::MAX_DEPTH, ']');
+    EXPECT_TRUE(doc.Parse(ok));
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include "multipart.h"
+
+namespace
+{
+
+const char *TYPE = "multipart/form-data; boundary=----WebKitFormBoundaryX";
+
+/* 文件内容中包含分隔符的前缀， 不应被截断 */
+const std::string FILE_DATA = "line1\r\n------WebKitFormBoundar\r\n--\r\nend";
+
+std::string Body()
+{
+    return "preamble\r\n"
+           "------WebKitFormBoundaryX\r\n"
+           "Content-Disposition: form-data; name=\"username\"\r\n"
+           "\r\n"
+           "alice\r\n"
+           "------WebKitFormBoundaryX\r\n"
+           "content-disposition: form-data; name=\"avatar\"; filename=\"a; b.txt\"\r\n"
+           "Content-Type: text/plain\r\n"
+           "\r\n" +
+           FILE_DATA +
+           "\r\n"
+           "------WebKitFormBoundaryX\r\n"
+           "Content-Disposition: form-data; name=\"empty\"\r\n"
+           "\r\n"
+           "\r\n"
+           "------WebKitFormBoundaryX--\r\n"
+           "epilogue";
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+} // namespace
+
+TEST(Multipart_TEST, HeaderParam)
+{
+    std::string_view v = "form-data; name=\"a\"; filename=\"x;y\"; size = 3";
+    EXPECT_EQ(MultipartParser::HeaderParam(v, "name"), "a");
+    EXPECT_EQ(MultipartParser::HeaderParam(v, "FILENAME"), "x;y");
+    EXPECT_EQ(MultipartParser::HeaderParam(v, "size"), "3");
+    EXPECT_EQ(MultipartParser::HeaderParam(v, "other").data(), nullptr);
+    EXPECT_NE(MultipartParser::HeaderParam("a; f=\"\"", "f").data(), nullptr);
+    EXPECT_TRUE(MultipartParser::IsMultipart(TYPE));
+    EXPECT_TRUE(MultipartParser::IsMultipart("Multipart/Form-Data ;boundary=a"));
+    EXPECT_FALSE(MultipartParser::IsMultipart("multipart/mixed; boundary=a"));
+}
+
+TEST(Multipart_TEST, AnySplit)
+{
+    std::string body = Body();
+    /* 每种切分长度都应得到相同的结果 */
+    for (size_t step = 1; step <= body.size(); step++)
+    {
+        MultipartParser parser;
+        ASSERT_TRUE(parser.Init(TYPE, "/tmp"));
+        for (size_t i = 0; i < body.size(); i += step)
+        {
+            ASSERT_TRUE(parser.Feed(body.data() + i,
+                                    std::min(step, body.size() - i)))
+                << step << " " << i;
+        }
+        ASSERT_TRUE(parser.Finish()) << step;
+        auto &fields = parser.Fields();
+        ASSERT_EQ(fields.size(), 2u);
+        EXPECT_EQ(fields[0].first, "username");
+        EXPECT_EQ(fields[0].second, "alice");
+        EXPECT_EQ(fields[1].first, "empty");
+        EXPECT_EQ(fields[1].second, "");
+        ASSERT_EQ(parser.Files().size(), 1u);
+        auto &file = parser.Files()[0];
+        EXPECT_EQ(file.name, "avatar");
+        EXPECT_EQ(file.filename, "a; b.txt");
+        EXPECT_EQ(file.contentType, "text/plain");
+        EXPECT_EQ(file.size, FILE_DATA.size());
+        EXPECT_EQ(ReadFile(file.path), FILE_DATA);
+        /* Reset删除临时文件 */
+        std::string path = file.path;
+        parser.Reset();
+        EXPECT_NE(access(path.c_str(), F_OK), 0);
+    }
+}
+
+TEST(Multipart_TEST, LargeFileInChunks)
+{
+    std::string head = "--b\r\n"
+                       "Content-Disposition: form-data; name=\"f\"; filename=\"big\"\r\n"
+                       "\r\n";
+    std::string tail = "\r\n--b--\r\n";
+    const size_t size = 4 << 20;
+    MultipartParser parser;
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=\"b\"", "/tmp"));
+    ASSERT_TRUE(parser.Feed(head.data(), head.size()));
+    /* 各种大小的片段， 包括大于SPILL_SIZE的 */
+    std::string piece;
+    size_t sent = 0;
+    for (size_t i = 0; sent < size; i++)
+    {
+        size_t len = std::min(size - sent, (i % 3 == 0) ? 100000 : 777 * (i % 7 + 1));
+        piece.assign(len, static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(parser.Feed(piece.data(), piece.size()));
+        sent += len;
+    }
+    ASSERT_TRUE(parser.Feed(tail.data(), tail.size()));
+    ASSERT_TRUE(parser.Finish());
+    ASSERT_EQ(parser.Files().size(), 1u);
+    EXPECT_EQ(parser.Files()[0].size, size);
+    EXPECT_EQ(ReadFile(parser.Files()[0].path).size(), size);
+}
+
+TEST(Multipart_TEST, Malformed)
+{
+    MultipartParser parser;
+    EXPECT_FALSE(parser.Init("multipart/form-data", "/tmp"));
+    EXPECT_FALSE(parser.Init("text/plain; boundary=b", "/tmp"));
+    EXPECT_FALSE(parser.Init("multipart/form-data; boundary=" + std::string(71, 'x'),
+                             "/tmp"));
+    const char *bad[] = {
+        /* 缺少name */
+        "--b\r\nContent-Disposition: form-data\r\n\r\nx\r\n--b--",
+        /* 首部行没有冒号 */
+        "--b\r\nbad header\r\n\r\nx\r\n--b--",
+        /* 分隔符后既不是CRLF也不是-- */
+        "--b\r\nContent-Disposition: form-data; name=\"a\"\r\n\r\nx\r\n--bxx",
+    };
+    for (const char *body : bad)
+    {
+        ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp"));
+        EXPECT_FALSE(parser.Feed(body, strlen(body))) << body;
+    }
+    /* 没有结束分隔符 */
+    std::string body = "--b\r\nContent-Disposition: form-data; name=\"a\"\r\n\r\nx";
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp"));
+    EXPECT_TRUE(parser.Feed(body.data(), body.size()));
+    EXPECT_FALSE(parser.Finish());
+    /* 字段过大 */
+    std::string big = "--b\r\nContent-Disposition: form-data; name=\"a\"\r\n\r\n" +
+                      std::string(MultipartParser::MAX_FIELD + 1, 'x');
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp"));
+    EXPECT_FALSE(parser.Feed(big.data(), big.size()));
+    EXPECT_TRUE(parser.TooLarge());
+}
+
+TEST(Multipart_TEST, Limits)
+{
+    MultipartParser parser;
+    /* 文件合计超出上限 */
+    std::string file = "--b\r\nContent-Disposition: form-data; name=\"f\"; "
+                       "filename=\"a\"\r\n\r\n" +
+                       std::string(600, 'x') + "\r\n--b\r\n"
+                       "Content-Disposition: form-data; name=\"g\"; "
+                       "filename=\"b\"\r\n\r\n" +
+                       std::string(600, 'y') + "\r\n--b--";
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp", 1000));
+    EXPECT_FALSE(parser.Feed(file.data(), file.size()));
+    EXPECT_TRUE(parser.TooLarge());
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp", 1200));
+    EXPECT_TRUE(parser.Feed(file.data(), file.size()));
+    EXPECT_TRUE(parser.Finish());
+    EXPECT_FALSE(parser.TooLarge());
+
+    /* 部分过多 */
+    std::string parts;
+    for (size_t i = 0; i <= MultipartParser::MAX_PARTS; i++)
+    {
+        parts += "--b\r\nContent-Disposition: form-data; name=\"a\"\r\n\r\nx\r\n";
+    }
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp"));
+    EXPECT_FALSE(parser.Feed(parts.data(), parts.size()));
+    EXPECT_TRUE(parser.TooLarge());
+
+    /* 每个字段都未超出MAX_FIELD， 但合计超出MAX_FIELDS */
+    std::string fields;
+    std::string value(MultipartParser::MAX_FIELD, 'v');
+    for (size_t size = 0; size <= MultipartParser::MAX_FIELDS; size += value.size())
+    {
+        fields += "--b\r\nContent-Disposition: form-data; name=\"a\"\r\n\r\n" +
+                  value + "\r\n";
+    }
+    ASSERT_TRUE(parser.Init("multipart/form-data; boundary=b", "/tmp"));
+    EXPECT_FALSE(parser.Feed(fields.data(), fields.size()));
+    EXPECT_TRUE(parser.TooLarge());
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <map>
+#include <new>
+#include <stdlib.h>
+#include <string>
+#include "router.h"
+
+namespace
+{
+
+std::atomic<size_t> allocCount{0};
+
+} // namespace
+
+void *operator new(size_t size)
+{
+    allocCount++;
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+class RouterTest : public ::testing::Test
+{
+protected:
+    /* 以标记区分各路由 */
+    void Add(const char *method, const char *pattern, int tag)
+    {
+        tags_[&router_.Add(method, pattern)] = tag;
+    }
+
+    /* 返回匹配到的路由标记， 没有匹配时为0 */
+    int Lookup(const char *method, const char *path)
+    {
+        return router_.Find(method, path, match_) ? tags_[match_.route] : 0;
+    }
+
+    Router router_;
+    Router::Match match_;
+    std::map<const Router::Route *, int> tags_;
+};
+
+TEST_F(RouterTest, StaticPrefixSplit)
+{
+    Add("GET", "/search", 1);
+    Add("GET", "/support", 2);
+    Add("GET", "/s", 3);
+    Add("GET", "/", 4);
+    Add("POST", "/search", 5);
+    EXPECT_EQ(Lookup("GET", "/search"), 1);
+    EXPECT_EQ(Lookup("GET", "/support"), 2);
+    EXPECT_EQ(Lookup("GET", "/s"), 3);
+    EXPECT_EQ(Lookup("GET", "/"), 4);
+    EXPECT_EQ(Lookup("POST", "/search"), 5);
+    EXPECT_EQ(Lookup("GET", "/se"), 0);
+    EXPECT_EQ(Lookup("GET", "/searches"), 0);
+    EXPECT_EQ(Lookup("PUT", "/search"), 0);
+    EXPECT_EQ(Lookup("GET", ""), 0);
+}
+
+TEST_F(RouterTest, Params)
+{
+    Add("GET", "/user/:id", 1);
+    Add("GET", "/user/:id/posts/:post", 2);
+    Add("GET", "/user/me", 3);
+    EXPECT_EQ(Lookup("GET", "/user/42"), 1);
+    EXPECT_EQ(match_.Get("id"), "42");
+    EXPECT_EQ(Lookup("GET", "/user/42/posts/7"), 2);
+    EXPECT_EQ(match_.paramCount, 2u);
+    EXPECT_EQ(match_.Get("id"), "42");
+    EXPECT_EQ(match_.Get("post"), "7");
+    /* 静态部分优先 */
+    EXPECT_EQ(Lookup("GET", "/user/me"), 3);
+    EXPECT_EQ(match_.paramCount, 0u);
+    EXPECT_EQ(Lookup("GET", "/user/"), 0);
+    EXPECT_EQ(Lookup("GET", "/user/42/posts"), 0);
+}
+
+TEST_F(RouterTest, Wildcard)
+{
+    Add("GET", "/static/*file", 1);
+    Add("GET", "/static/index.html", 2);
+    Add("GET", "/*path", 3);
+    EXPECT_EQ(Lookup("GET", "/static/css/a.css"), 1);
+    EXPECT_EQ(match_.Get("file"), "css/a.css");
+    EXPECT_EQ(Lookup("GET", "/static/index.html"), 2);
+    /* 静态部分只匹配了一半时回退到通配符 */
+    EXPECT_EQ(Lookup("GET", "/static/index.htm"), 1);
+    EXPECT_EQ(Lookup("GET", "/other/x"), 3);
+    EXPECT_EQ(match_.Get("path"), "other/x");
+    EXPECT_EQ(Lookup("GET", "/"), 3);
+    EXPECT_EQ(match_.Get("path"), "");
+}
+
+TEST_F(RouterTest, SameRouteReturned)
+{
+    Router::Route &a = router_.Add("POST", "/upload");
+    Add("POST", "/up", 1);
+    Add("POST", "/uploads", 2);
+    /* 节点拆分不影响已返回的路由 */
+    EXPECT_EQ(&router_.Add("POST", "/upload"), &a);
+    EXPECT_TRUE(router_.Find("POST", "/upload", match_));
+    EXPECT_EQ(match_.route, &a);
+}
+
+TEST_F(RouterTest, LookupDoesNotAllocate)
+{
+    Add("GET", "/", 1);
+    Add("GET", "/index", 2);
+    Add("GET", "/user/:id/posts/:post", 3);
+    Add("GET", "/static/*file", 4);
+    const char *paths[] = {
+        "/", "/index", "/user/1/posts/2", "/static/a/b/c.png", "/missing"};
+    size_t before = allocCount;
+    for (int i = 0; i < 1000; i++)
+    {
+        for (const char *path : paths)
+        {
+            router_.Find("GET", path, match_);
+        }
+    }
+    EXPECT_EQ(allocCount - before, 0u);
+}
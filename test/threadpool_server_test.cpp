@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const int TIMEOUT_MS = 300;
+
+/* 绑定0端口获取一个空闲端口 */
+int FreePort()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+int Connect(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    /* 服务器异常时不让测试一直阻塞 */
+    struct timeval tv = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+enum RESULT
+{
+    OK,     // 收到完整的200响应
+    CLOSED, // 连接已被关闭， 没有收到任何数据
+    BAD,    // 响应不完整或状态码不对
+};
+
+/* 在保持的连接上发送一个请求并读取完整的响应
+   请求逐字节发送： 工作线程处理已到达的部分时又有数据到达， 没有
+   EPOLLONESHOT时会有多个工作线程同时处理同一个连接 */
+RESULT KeepAliveRequest(int fd)
+{
+    const char req[] = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    for (size_t i = 0; i + 1 < sizeof(req); i++)
+    {
+        if (send(fd, req + i, 1, MSG_NOSIGNAL) != 1)
+        {
+            return CLOSED;
+        }
+    }
+    std::string resp;
+    size_t total = std::string::npos;
+    char buf[16384];
+    while (total == std::string::npos || resp.size() < total)
+    {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            /* 空闲超时与发送请求同时发生时， 连接关闭且没有响应 */
+            return resp.empty() && (n == 0 || errno == ECONNRESET) ? CLOSED : BAD;
+        }
+        resp.append(buf, n);
+        size_t headEnd = resp.find("\r\n\r\n");
+        size_t lenPos = resp.find("Content-length: ");
+        if (total == std::string::npos && headEnd != std::string::npos &&
+            lenPos < headEnd)
+        {
+            total = headEnd + 4 + std::stoul(resp.substr(lenPos + 16));
+        }
+    }
+    return resp.size() == total && resp.compare(0, 15, "HTTP/1.1 200 OK") == 0 ? OK
+                                                                               : BAD;
+}
+
+/* 以构建目录中的config.ini为模板， 在临时目录中生成线程池模型的配置 */
+std::string MakeConfigDir(int port)
+{
+    std::string bin = SERVER_BIN;
+    std::ifstream in(bin.substr(0, bin.find_last_of('/')) + "/config.ini");
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string cfg = ss.str();
+    const std::pair<const char *, std::string> keys[] = {
+        {"port", std::to_string(port)},
+        {"model", "thread-pool"},
+        {"threadNum", "4"},
+        /* 0-3以外的值按ET + ET处理， 线程池模型仍需EPOLLONESHOT */
+        {"trigMode", "7"},
+        {"timeoutMS", std::to_string(TIMEOUT_MS)},
+        {"keepAliveMax", "0"},
+        {"open", "false"},
+    };
+    for (auto &key : keys)
+    {
+        cfg = std::regex_replace(cfg,
+                                 std::regex(std::string("\n") + key.first + " = [^\n]*"),
+                                 std::string("\n") + key.first + " = " + key.second);
+    }
+    char tmpl[] = "/tmp/threadpool_testXXXXXX";
+    std::string dir = mkdtemp(tmpl);
+    std::ofstream(dir + "/config.ini") << cfg;
+    return dir;
+}
+
+class ThreadPoolServer_TEST : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        port_ = FreePort();
+        dir_ = MakeConfigDir(port_);
+        pid_ = fork();
+        ASSERT_GE(pid_, 0);
+        if (pid_ == 0)
+        {
+            setpgid(0, 0);
+            if (chdir(dir_.c_str()) == 0)
+            {
+                execl(SERVER_BIN, SERVER_BIN, nullptr);
+            }
+            _exit(127);
+        }
+        setpgid(pid_, pid_);
+        bool up = false;
+        for (int i = 0; i < 500 && !up; i++)
+        {
+            int fd = Connect(port_);
+            if (fd >= 0)
+            {
+                close(fd);
+                up = true;
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        ASSERT_TRUE(up);
+    }
+
+    void TearDown() override
+    {
+        /* 测试期间服务器不应退出 */
+        int status = 0;
+        EXPECT_EQ(waitpid(pid_, &status, WNOHANG), 0);
+        kill(-pid_, SIGKILL);
+        waitpid(pid_, &status, 0);
+        system(("rm -rf " + dir_).c_str());
+    }
+
+    int port_;
+    std::string dir_;
+    pid_t pid_;
+};
+
+} // namespace
+
+/* 大量保持的连接在工作线程与Reactor线程之间反复交接， 部分请求恰好在
+   空闲超时附近发出， 与定时器关闭连接竞争 */
+TEST_F(ThreadPoolServer_TEST, KeepAliveClientsRaceIdleTimeout)
+{
+    std::atomic<int> ok(0), closed(0), bad(0);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 32; i++)
+    {
+        clients.emplace_back([&, i]() {
+            std::mt19937 rng(i);
+            std::uniform_int_distribution<int> pause(TIMEOUT_MS - 40, TIMEOUT_MS + 40);
+            int fd = Connect(port_);
+            for (int n = 0; n < 60 && fd >= 0; n++)
+            {
+                if (n % 20 == 19)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(pause(rng)));
+                }
+                RESULT result = KeepAliveRequest(fd);
+                if (result == OK)
+                {
+                    ok++;
+                    continue;
+                }
+                (result == CLOSED ? closed : bad)++;
+                close(fd);
+                fd = Connect(port_);
+            }
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        });
+    }
+    for (auto &t : clients)
+    {
+        t.join();
+    }
+    EXPECT_EQ(bad, 0);
+    EXPECT_EQ(ok + closed, 32 * 60);
+    EXPECT_GT(ok, 32 * 50);
+}
+
+TEST_F(ThreadPoolServer_TEST, IdleConnectionsTimeOut)
+{
+    std::vector<int> fds;
+    for (int i = 0; i < 64; i++)
+    {
+        int fd = Connect(port_);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(KeepAliveRequest(fd), OK);
+        fds.push_back(fd);
+    }
+    /* 每个连接都经过一次工作线程再挂回定时器， 空闲超时后由服务器关闭 */
+    auto begin = std::chrono::steady_clock::now();
+    for (int fd : fds)
+    {
+        char ch;
+        EXPECT_EQ(read(fd, &ch, 1), 0);
+        close(fd);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+    EXPECT_LT(elapsed, TIMEOUT_MS * 4);
+
+    /* 超时关闭后fd被新连接复用， 仍能正常服务 */
+    int fd = Connect(port_);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(KeepAliveRequest(fd), OK);
+    close(fd);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "timer.h"
+
+class Timer_TEST : public ::testing::TestWithParam<TimerType>
+{
+protected:
+    void SetUp() override { timer_ = Timer::Create(GetParam(), 1); }
+
+    /* 按GetNextTick的提示等待， 直到没有定时器 */
+    void RunUntilEmpty()
+    {
+        int ms;
+        while ((ms = timer_->GetNextTick()) >= 0)
+        {
+            std::this_thread::sleep_for(MS(ms));
+            timer_->UpdateNow();
+        }
+    }
+
+    std::unique_ptr<Timer> timer_;
+};
+
+TEST_P(Timer_TEST, ExpireInOrder)
+{
+    std::vector<int> fired;
+    timer_->add(1, 30, [&] { fired.push_back(1); });
+    timer_->add(2, 10, [&] { fired.push_back(2); });
+    timer_->add(3, 20, [&] { fired.push_back(3); });
+    RunUntilEmpty();
+    EXPECT_EQ(fired, std::vector<int>({2, 3, 1}));
+}
+
+TEST_P(Timer_TEST, AdjustDelays)
+{
+    bool fired = false;
+    timer_->add(1, 20, [&] { fired = true; });
+    std::this_thread::sleep_for(MS(10));
+    timer_->UpdateNow();
+    timer_->adjust(1, 50);
+    std::this_thread::sleep_for(MS(20));
+    timer_->UpdateNow();
+    timer_->tick();
+    EXPECT_FALSE(fired);
+    std::this_thread::sleep_for(MS(40));
+    timer_->UpdateNow();
+    timer_->tick();
+    EXPECT_TRUE(fired);
+}
+
+TEST_P(Timer_TEST, CancelAndDoWork)
+{
+    int fired = 0;
+    timer_->add(1, 10, [&] { fired += 1; });
+    timer_->add(2, 1000, [&] { fired += 10; });
+    timer_->cancel(1);
+    timer_->doWork(2);
+    EXPECT_EQ(fired, 10);
+    EXPECT_EQ(timer_->GetNextTick(), -1);
+    std::this_thread::sleep_for(MS(20));
+    timer_->UpdateNow();
+    timer_->tick();
+    EXPECT_EQ(fired, 10);
+}
+
+TEST_P(Timer_TEST, AddExistingReplacesCallback)
+{
+    int fired = 0;
+    timer_->add(1, 10, [&] { fired = 1; });
+    timer_->add(1, 20, [&] { fired = 2; });
+    RunUntilEmpty();
+    EXPECT_EQ(fired, 2);
+}
+
+TEST_P(Timer_TEST, ReAddInCallback)
+{
+    int fired = 0;
+    timer_->add(1, 5, [&] {
+        fired++;
+        timer_->add(1, 5, [&] { fired++; });
+    });
+    RunUntilEmpty();
+    EXPECT_EQ(fired, 2);
+}
+
+TEST_P(Timer_TEST, CachedClock)
+{
+    bool fired = false;
+    timer_->add(1, 10, [&] { fired = true; });
+    std::this_thread::sleep_for(MS(20));
+    /* 未刷新缓存时间前不会到期 */
+    timer_->tick();
+    EXPECT_FALSE(fired);
+    timer_->UpdateNow();
+    timer_->tick();
+    EXPECT_TRUE(fired);
+}
+
+TEST_P(Timer_TEST, SameExpiry)
+{
+    /* 同一轮循环中添加的定时器使用同一缓存时间， 超时时间相同 */
+    timer_->UpdateNow();
+    std::vector<int> fired;
+    for (int id = 0; id < 64; id++)
+    {
+        timer_->add(id, 10, [&fired, id] { fired.push_back(id); });
+    }
+    timer_->adjust(63, 10);
+    timer_->adjust(0, 10);
+    RunUntilEmpty();
+    ASSERT_EQ(fired.size(), 64u);
+    std::sort(fired.begin(), fired.end());
+    for (int id = 0; id < 64; id++)
+    {
+        EXPECT_EQ(fired[id], id);
+    }
+}
+
+TEST_P(Timer_TEST, LongTimeout)
+{
+    /* 跨越时间轮第0层， 需要经过级联 */
+    timer_->UpdateNow();
+    auto begin = timer_->Now();
+    TimeStamp firedAt;
+    timer_->add(7, 600, [&] { firedAt = Clock::now(); });
+    int next = timer_->GetNextTick();
+    EXPECT_GT(next, 0);
+    EXPECT_LE(next, 600);
+    RunUntilEmpty();
+    auto elapsed = std::chrono::duration_cast<MS>(firedAt - begin).count();
+    EXPECT_GE(elapsed, 599); // 毫秒取整误差
+    EXPECT_LT(elapsed, 700);
+}
+
+TEST_P(Timer_TEST, NextTickRoundsUp)
+{
+    /* 未到期时剩余不足1ms也返回1， 返回0会让epoll_wait立即返回而空转 */
+    timer_->UpdateNow();
+    timer_->add(1, 10, [] {});
+    std::this_thread::sleep_for(std::chrono::microseconds(9500));
+    timer_->UpdateNow();
+    EXPECT_NE(timer_->GetNextTick(), 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Timers,
+                         Timer_TEST,
+                         ::testing::Values(TimerType::HEAP, TimerType::WHEEL));
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/* 绑定0端口获取一个空闲端口 */
+int FreePort()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+int Connect(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+/* 发送一个短连接请求， 返回是否收到200响应 */
+bool Request(int fd)
+{
+    const char req[] = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n"
+                       "Connection: close\r\n\r\n";
+    if (send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL) != sizeof(req) - 1)
+    {
+        return false;
+    }
+    std::string resp;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0)
+    {
+        resp.append(buf, n);
+    }
+    return n == 0 && resp.compare(0, 12, "HTTP/1.1 200") == 0;
+}
+
+/* 以构建目录中的config.ini为模板， 在临时目录中生成配置 */
+std::string MakeConfigDir(int port)
+{
+    std::string bin = SERVER_BIN;
+    std::ifstream in(bin.substr(0, bin.find_last_of('/')) + "/config.ini");
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string cfg = ss.str();
+    cfg = std::regex_replace(
+        cfg, std::regex("\nport = 8080"), "\nport = " + std::to_string(port));
+    cfg = std::regex_replace(cfg, std::regex("\nmodel = [^\n]*"),
+                             "\nmodel = multi-reactor");
+    cfg = std::regex_replace(cfg, std::regex("\nthreadNum = [^\n]*"),
+                             "\nthreadNum = 2");
+    cfg = std::regex_replace(cfg, std::regex("\nopen = [^\n]*"),
+                             "\nopen = false");
+    char tmpl[] = "/tmp/upgrade_testXXXXXX";
+    std::string dir = mkdtemp(tmpl);
+    std::ofstream(dir + "/config.ini") << cfg;
+    return dir;
+}
+
+} // namespace
+
+TEST(Upgrade_TEST, NoRefusedConnections)
+{
+    int port = FreePort();
+    std::string dir = MakeConfigDir(port);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        setpgid(0, 0);
+        if (chdir(dir.c_str()) == 0)
+        {
+            execl(SERVER_BIN, SERVER_BIN, nullptr);
+        }
+        _exit(127);
+    }
+    setpgid(pid, pid);
+
+    bool up = false;
+    for (int i = 0; i < 500 && !up; i++)
+    {
+        int fd = Connect(port);
+        if (fd >= 0)
+        {
+            close(fd);
+            up = true;
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_TRUE(up);
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> oldExited(false);
+    std::atomic<int> ok(0), refused(0), errors(0), okAfter(0);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 4; i++)
+    {
+        clients.emplace_back([&]() {
+            while (!stop)
+            {
+                bool after = oldExited;
+                int fd = Connect(port);
+                if (fd < 0)
+                {
+                    (errno == ECONNREFUSED ? refused : errors)++;
+                    continue;
+                }
+                if (Request(fd))
+                {
+                    ok++;
+                    if (after)
+                    {
+                        okAfter++;
+                    }
+                }
+                else
+                {
+                    errors++;
+                }
+                close(fd);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(kill(pid, SIGUSR2), 0);
+    /* 旧进程排空连接后退出 */
+    int status = 0;
+    pid_t ret = 0;
+    for (int i = 0; i < 1500 && ret == 0; i++)
+    {
+        ret = waitpid(pid, &status, WNOHANG);
+        if (ret == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    oldExited = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop = true;
+    for (auto &t : clients)
+    {
+        t.join();
+    }
+    kill(-pid, SIGKILL);
+    if (ret == 0)
+    {
+        waitpid(pid, &status, 0);
+    }
+    system(("rm -rf " + dir).c_str());
+
+    EXPECT_EQ(ret, pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_GT(ok, 0);
+    EXPECT_GT(okAfter, 0);
+    EXPECT_EQ(refused, 0);
+    EXPECT_EQ(errors, 0);
+}
@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+const int TIMEOUT_MS = 300;
+
+/* 绑定0端口获取一个空闲端口 */
+int FreePort()
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+int Connect(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    /* 服务器异常时不让测试一直阻塞 */
+    struct timeval tv = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return fd;
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+std::string Resource(const std::string &path)
+{
+    std::string bin = SERVER_BIN;
+    return ReadFile(bin.substr(0, bin.find_last_of('/')) + "/resources" + path);
+}
+
+/* 读取一个完整的响应， 返回响应体， 出错时返回"ERROR" */
+std::string ReadResponse(int fd, std::string &pending)
+{
+    char buf[16384];
+    while (true)
+    {
+        size_t headEnd = pending.find("\r\n\r\n");
+        size_t lenPos = pending.find("Content-length: ");
+        if (headEnd != std::string::npos && lenPos < headEnd)
+        {
+            size_t total = headEnd + 4 + std::stoul(pending.substr(lenPos + 16));
+            if (pending.size() >= total)
+            {
+                std::string body = pending.substr(headEnd + 4, total - headEnd - 4);
+                bool ok = pending.compare(0, 15, "HTTP/1.1 200 OK") == 0;
+                pending.erase(0, total);
+                return ok ? body : "ERROR";
+            }
+        }
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0)
+        {
+            return "ERROR";
+        }
+        pending.append(buf, n);
+    }
+}
+
+/* 以构建目录中的config.ini为模板， 生成io_uring引擎多Reactor模型的配置 */
+std::string MakeConfigDir(int port, int sendfileThreshold)
+{
+    std::string bin = SERVER_BIN;
+    std::string cfg = ReadFile(bin.substr(0, bin.find_last_of('/')) + "/config.ini");
+    const std::pair<const char *, std::string> keys[] = {
+        {"port", std::to_string(port)},
+        {"model", "multi-reactor"},
+        {"engine", "io_uring"},
+        {"threadNum", "2"},
+        /* 空闲连接不发送数据， 不能等到首包才接受 */
+        {"deferAcceptSec", "0"},
+        {"timeoutMS", std::to_string(TIMEOUT_MS)},
+        {"timer", "wheel"},
+        {"timerTickMS", "10"},
+        {"sendfileThreshold", std::to_string(sendfileThreshold)},
+        {"open", "false"},
+    };
+    for (auto &key : keys)
+    {
+        cfg = std::regex_replace(cfg,
+                                 std::regex(std::string("\n") + key.first + " = [^\n]*"),
+                                 std::string("\n") + key.first + " = " + key.second);
+    }
+    char tmpl[] = "/tmp/uring_server_testXXXXXX";
+    std::string dir = mkdtemp(tmpl);
+    std::ofstream(dir + "/config.ini") << cfg;
+    return dir;
+}
+
+/* 参数为sendfileThreshold： 0时文件用sendfile发送， -1时文件以内存映射
+   作为SENDMSG请求的一部分发送 */
+class UringServer_TEST : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override
+    {
+        port_ = FreePort();
+        dir_ = MakeConfigDir(port_, GetParam());
+        pid_ = fork();
+        ASSERT_GE(pid_, 0);
+        if (pid_ == 0)
+        {
+            setpgid(0, 0);
+            if (chdir(dir_.c_str()) == 0)
+            {
+                execl(SERVER_BIN, SERVER_BIN, nullptr);
+            }
+            _exit(127);
+        }
+        setpgid(pid_, pid_);
+        bool up = false;
+        for (int i = 0; i < 500 && !up; i++)
+        {
+            int fd = Connect(port_);
+            if (fd >= 0)
+            {
+                close(fd);
+                up = true;
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        ASSERT_TRUE(up);
+    }
+
+    void TearDown() override
+    {
+        /* 测试期间服务器不应退出 */
+        int status = 0;
+        EXPECT_EQ(waitpid(pid_, &status, WNOHANG), 0);
+        kill(-pid_, SIGKILL);
+        waitpid(pid_, &status, 0);
+        system(("rm -rf " + dir_).c_str());
+    }
+
+    int port_;
+    std::string dir_;
+    pid_t pid_;
+};
+
+} // namespace
+
+TEST_P(UringServer_TEST, PipelinedKeepAlive)
+{
+    std::string index = Resource("/index.html");
+    std::string css = Resource("/css/bootstrap.min.css");
+    ASSERT_FALSE(index.empty());
+    ASSERT_FALSE(css.empty());
+    int fd = Connect(port_);
+    ASSERT_GE(fd, 0);
+    std::string pending;
+    for (int round = 0; round < 20; round++)
+    {
+        /* 一次发出多个请求， 响应发送期间到达的请求在发送完成后处理 */
+        std::string reqs = "GET / HTTP/1.1\r\nHost: a\r\n\r\n"
+                           "GET /css/bootstrap.min.css HTTP/1.1\r\nHost: a\r\n\r\n";
+        ASSERT_EQ(send(fd, reqs.data(), reqs.size(), MSG_NOSIGNAL),
+                  static_cast<ssize_t>(reqs.size()));
+        ASSERT_EQ(send(fd, "GET / HTTP/1.1\r\n", 16, MSG_NOSIGNAL), 16);
+        EXPECT_EQ(ReadResponse(fd, pending), index);
+        EXPECT_EQ(ReadResponse(fd, pending), css);
+        ASSERT_EQ(send(fd, "Host: a\r\n\r\n", 11, MSG_NOSIGNAL), 11);
+        EXPECT_EQ(ReadResponse(fd, pending), index);
+    }
+    close(fd);
+}
+
+TEST_P(UringServer_TEST, ClientsCloseMidResponse)
+{
+    /* 大文件发送期间对端关闭， 未完成的发送被撤销， fd随后被新连接复用 */
+    for (int i = 0; i < 50; i++)
+    {
+        int fd = Connect(port_);
+        ASSERT_GE(fd, 0);
+        const char req[] = "GET /css/bootstrap.min.css HTTP/1.1\r\nHost: a\r\n\r\n";
+        ASSERT_EQ(send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL),
+                  static_cast<ssize_t>(sizeof(req) - 1));
+        if (i % 2)
+        {
+            char ch;
+            ASSERT_EQ(read(fd, &ch, 1), 1);
+        }
+        /* 丢弃未读数据时发送RST */
+        struct linger lg = {1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+        close(fd);
+    }
+    int fd = Connect(port_);
+    ASSERT_GE(fd, 0);
+    std::string pending;
+    const char req[] = "GET /css/bootstrap.min.css HTTP/1.1\r\nHost: a\r\n\r\n";
+    ASSERT_EQ(send(fd, req, sizeof(req) - 1, MSG_NOSIGNAL),
+              static_cast<ssize_t>(sizeof(req) - 1));
+    EXPECT_EQ(ReadResponse(fd, pending), Resource("/css/bootstrap.min.css"));
+    close(fd);
+}
+
+TEST_P(UringServer_TEST, IdleConnectionsTimeOut)
+{
+    std::vector<int> fds;
+    for (int i = 0; i < 32; i++)
+    {
+        int fd = Connect(port_);
+        ASSERT_GE(fd, 0);
+        fds.push_back(fd);
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (int fd : fds)
+    {
+        char ch;
+        EXPECT_EQ(read(fd, &ch, 1), 0);
+        close(fd);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+    EXPECT_LT(elapsed, TIMEOUT_MS * 4);
+}
+
+INSTANTIATE_TEST_SUITE_P(SendPaths, UringServer_TEST, ::testing::Values(0, -1));